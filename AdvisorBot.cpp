@@ -1,9 +1,46 @@
 #include "AdvisorBot.h"
 #include "UserCommands.h"
+#include "TimeStamp.h"
 #include <regex>
+#include <set>
 
 /** Initialize an instance of the Advisor Bot class */
-AdvisorBot::AdvisorBot() = default;
+AdvisorBot::AdvisorBot()
+{
+    pinLatestVersion();
+}
+
+/** Initialize an instance of the Advisor Bot class over the CSV file provided
+ *
+ *  @param csvFilename Name of the CSV file to be parsed
+ *
+ */
+AdvisorBot::AdvisorBot(std::string csvFilename)
+    : versionedBook{ StocksDataBook{ csvFilename } }
+{
+    pinLatestVersion();
+}
+
+/** Initialize an instance of the Advisor Bot class over several files merged into one dataset, loaded now or in the background
+ *
+ *  In the background, the book starts empty and versions holding more of the dataset are published from
+ *  another thread while commands are processed. Each command waits only for the data it needs, and pins
+ *  the latest version before it runs
+ *
+ *  @param csvFilenames Names of the CSV files or book archives to be parsed
+ *  @param options      Validation mode, quarantine stream and read method applied while parsing
+ *  @param loadMode     Whether to load the dataset before returning or in the background
+ *
+ */
+AdvisorBot::AdvisorBot(std::vector<std::string> csvFilenames, const CSVReadOptions& options, BookLoadMode loadMode)
+    : versionedBook{ loadMode == BookLoadMode::foreground ? StocksDataBook{ csvFilenames, options } : StocksDataBook{} }
+{
+    pinLatestVersion();
+    if (loadMode == BookLoadMode::background)
+    {
+        bookLoader = std::make_unique<BookLoader>(csvFilenames, versionedBook, options);
+    }
+}
 
 /** Prompt the user for input - validate and process the input and execute corresponding command */
 void AdvisorBot::init()
@@ -12,8 +49,14 @@ void AdvisorBot::init()
 
     UserCommands userCommands;
 
-    // Begin simulation at earliest timestamp
-    currentTime = stocksDataBook.getEarliestTimeStamp();
+    // Begin simulation at earliest timestamp, set by the first command needing data if loading in the background
+    if (bookLoader == nullptr)
+    {
+        currentTime = book().getEarliestTimeStamp();
+    }
+
+    // Fund the simulated wallet so that orders can be placed from the start
+    wallet.insertCurrency("BTC", 10);
 
     // Continually process and validate user commands
     while (true)
@@ -41,6 +84,113 @@ void AdvisorBot::init()
     }
 }
 
+/** Wait until the data a command needs has been loaded, and pin the latest version of the book for the command
+ *
+ *  Commands about the current time step only need every SDBE up to that time step, so they can run while
+ *  the rest of the dataset is loading. The simulation starts at the first time step once it is available.
+ *  Versions published while the command runs are not seen until the next command
+ *
+ *  @param wholeDataset True if the command needs the complete dataset rather than the data up to the current time step
+ *
+ */
+void AdvisorBot::awaitDataset(bool wholeDataset)
+{
+    if (bookLoader != nullptr)
+    {
+        std::int64_t time = currentTime.empty() ? -1 : TimeStamp::parse(currentTime);
+        bool ready = wholeDataset ? bookLoader->getProgress().state != BookLoadState::loading : bookLoader->isTimeStepReady(time);
+        if (!ready)
+        {
+            std::cout << "Waiting for the dataset to load" << (wholeDataset ? "" : " up to the current time step") << "..." << std::endl;
+            if (wholeDataset)
+            {
+                bookLoader->waitForCompletion();
+            }
+            else
+            {
+                bookLoader->waitForTimeStep(time);
+            }
+        }
+    }
+
+    pinLatestVersion();
+
+    // A book loaded up front is always complete
+    if (bookLoader == nullptr)
+    {
+        return;
+    }
+
+    if (bookLoader->getProgress().state == BookLoadState::failed)
+    {
+        std::cout << "Advisor Bot could not load its dataset." << std::endl;
+        throw std::exception{};
+    }
+    if (book().getEntries().empty())
+    {
+        std::cout << "The dataset holds no entries." << std::endl;
+        throw std::exception{};
+    }
+    if (currentTime.empty())
+    {
+        currentTime = book().getEarliestTimeStamp();
+    }
+}
+
+/** Return the engines answering queries about the pinned version of the dataset
+ *
+ *  @return engines over the version pinned by the latest command
+ *
+ */
+VersionEngines& AdvisorBot::engines()
+{
+    return *pinnedEngines;
+}
+
+/** Return the pinned version of the dataset
+ *
+ *  @return dataset of the version pinned by the latest command
+ *
+ */
+const StocksDataBook& AdvisorBot::book()
+{
+    return pinnedVersion->book;
+}
+
+/** Return the progress of loading the dataset
+ *
+ *  @return progress of the background load, or of a completed load if the book was loaded up front
+ *
+ */
+BookLoadProgress AdvisorBot::getLoadProgress()
+{
+    if (bookLoader != nullptr)
+    {
+        return bookLoader->getProgress();
+    }
+
+    const LoadReport& loadReport = book().getLoadReport();
+    const std::vector<StocksDataBookEntry>& entries = book().getEntries();
+    BookLoadProgress progress;
+    progress.state = BookLoadState::complete;
+    progress.bytesParsed = progress.totalBytes = loadReport.bytesRead;
+    progress.rowsParsed = progress.rowsPublished = entries.size();
+    progress.latestTime = entries.empty() ? -1 : entries.back().timestamp;
+    progress.elapsedSeconds = loadReport.phaseTimes.totalSeconds;
+    return progress;
+}
+
+/** Pin the latest version of the book, releasing the version pinned before */
+void AdvisorBot::pinLatestVersion()
+{
+    // Fills carry over to the ladders of the newer version
+    if (versionedBook.pin(pinnedVersion))
+    {
+        pinnedEngines = std::make_unique<VersionEngines>(pinnedVersion);
+        orderMatcher.setDepthEngine(pinnedEngines->depthEngine);
+    }
+}
+
 /** Inform the user of how to interact with AdvisorBot */
 void AdvisorBot::promptUser()
 {
@@ -82,6 +232,9 @@ void AdvisorBot::mapUserInputToCommand()
     singleTokenCommandMap["prod"] = [this]() { UserCommands::Command3_PROD(this); };
     singleTokenCommandMap["time"] = [this]() { UserCommands::Command8_TIME(this); };
     singleTokenCommandMap["step"] = [this]() { UserCommands::Command9_STEP(this); };
+    singleTokenCommandMap["report"] = [this]() { UserCommands::Command11_REPORT(this); };
+    singleTokenCommandMap["wallet"] = [this]() { UserCommands::Command24_WALLET(this); };
+    singleTokenCommandMap["status"] = [this]() { UserCommands::Command30_STATUS(this); };
 
     // Populate two token command map with user inputs mapped to static function pointers representing commands 
 
@@ -93,17 +246,62 @@ void AdvisorBot::mapUserInputToCommand()
     twoTokenCommandMap["helptime"] = [this]() { UserCommands::Command2_HELP_time();  };
     twoTokenCommandMap["helpstep"] = [this]() { UserCommands::Command2_HELP_step();  };
     twoTokenCommandMap["helpmedian"] = [this]() { UserCommands::Command2_HELP_median();  };
+    twoTokenCommandMap["helpreport"] = [this]() { UserCommands::Command2_HELP_report();  };
+    twoTokenCommandMap["helpdepth"] = [this]() { UserCommands::Command2_HELP_depth();  };
+    twoTokenCommandMap["helpimpact"] = [this]() { UserCommands::Command2_HELP_impact();  };
+    twoTokenCommandMap["helpvwap"] = [this]() { UserCommands::Command2_HELP_vwap();  };
+    twoTokenCommandMap["helpvwmedian"] = [this]() { UserCommands::Command2_HELP_vwmedian();  };
+    twoTokenCommandMap["helpvolume"] = [this]() { UserCommands::Command2_HELP_volume();  };
+    twoTokenCommandMap["helpspread"] = [this]() { UserCommands::Command2_HELP_spread();  };
+    twoTokenCommandMap["helpcandles"] = [this]() { UserCommands::Command2_HELP_candles();  };
+    twoTokenCommandMap["helpvol"] = [this]() { UserCommands::Command2_HELP_vol();  };
+    twoTokenCommandMap["helpzscore"] = [this]() { UserCommands::Command2_HELP_zscore();  };
+    twoTokenCommandMap["helpcorr"] = [this]() { UserCommands::Command2_HELP_corr();  };
+    twoTokenCommandMap["helpbacktest"] = [this]() { UserCommands::Command2_HELP_backtest();  };
+    twoTokenCommandMap["helpsweep"] = [this]() { UserCommands::Command2_HELP_sweep();  };
+    twoTokenCommandMap["helpwallet"] = [this]() { UserCommands::Command2_HELP_wallet();  };
+    twoTokenCommandMap["helpbuy"] = [this]() { UserCommands::Command2_HELP_buy();  };
+    twoTokenCommandMap["helpsell"] = [this]() { UserCommands::Command2_HELP_sell();  };
+    twoTokenCommandMap["helpgoto"] = [this]() { UserCommands::Command2_HELP_goto();  };
+    twoTokenCommandMap["helpback"] = [this]() { UserCommands::Command2_HELP_back();  };
+    twoTokenCommandMap["helpforward"] = [this]() { UserCommands::Command2_HELP_forward();  };
+    twoTokenCommandMap["helpstatus"] = [this]() { UserCommands::Command2_HELP_status();  };
+    twoTokenCommandMap["reportjson"] = [this]() { UserCommands::Command11_REPORT_json(this);  };
+
+    // Populate two token command map for commands taking an argument
+    twoTokenArgumentCommandMap["corr"] = [this](const std::string& numTimesteps, const std::string& currentTime) { return UserCommands::Command21_CORR(numTimesteps, currentTime, this); };
+    twoTokenArgumentCommandMap["goto"] = [this](const std::string& timestamp, const std::string& currentTime) { return UserCommands::Command27_GOTO(timestamp, currentTime, this); };
+    twoTokenArgumentCommandMap["back"] = [this](const std::string& numTimesteps, const std::string& currentTime) { return UserCommands::Command28_BACK(numTimesteps, currentTime, this); };
+    twoTokenArgumentCommandMap["forward"] = [this](const std::string& numTimesteps, const std::string& currentTime) { return UserCommands::Command29_FORWARD(numTimesteps, currentTime, this); };
+    twoTokenArgumentCommandMap["sweep"] = [this](const std::string& SDBEtype, const std::string& /*currentTime*/) { return UserCommands::Command23_SWEEP(SDBEtype, this); };
 
     // Populate three token command map with user inputs mapped to static function pointers representing commands 
 
-    threeTokenCommandMap["min"] = [this](std::string SDBEtype, std::string product, std::string currentTime) { return UserCommands::Command4_MIN(SDBEtype, product, currentTime, this); };
-    threeTokenCommandMap["max"] = [this](std::string SDBEtype, std::string product, std::string currentTime) { return UserCommands::Command5_MAX(SDBEtype, product, currentTime, this); };
+    threeTokenCommandMap["min"] = [this](const std::string& SDBEtype, const std::string& product, const std::string& currentTime) { return UserCommands::Command4_MIN(SDBEtype, product, currentTime, this); };
+    threeTokenCommandMap["max"] = [this](const std::string& SDBEtype, const std::string& product, const std::string& currentTime) { return UserCommands::Command5_MAX(SDBEtype, product, currentTime, this); };
+    threeTokenCommandMap["spread"] = [this](const std::string& numTimesteps, const std::string& product, const std::string& currentTime) { return UserCommands::Command17_SPREAD(product, numTimesteps, currentTime, this); };
+    threeTokenCommandMap["goto"] = [this](const std::string& time, const std::string& date, const std::string& currentTime) { return UserCommands::Command27_GOTO(date + " " + time, currentTime, this); };
+    threeTokenCommandMap["depth"] = [this](const std::string& numLevels, const std::string& product, const std::string& currentTime) { return UserCommands::Command12_DEPTH(product, numLevels, currentTime, this); };
 
     // Populate four token command map with user inputs mapped to static function pointers representing commands 
 
-    fourTokenCommandMap["avg"] = [this](std::string SDBEtype, std::string product, std::string currentTime, std::string numTimesteps) { return UserCommands::Command6_AVG(SDBEtype, product, currentTime, numTimesteps, this); };
-    fourTokenCommandMap["median"] = [this](std::string SDBEtype, std::string product, std::string currentTime, std::string numTimesteps) { return UserCommands::Command10_MEDIAN(SDBEtype, product, currentTime, numTimesteps, this); };
-    fourTokenCommandMap["predict"] = [this](std::string product, std::string maxOrMin, std::string currentTime, std::string SDBEtype) { return UserCommands::Command7_PREDICT(product, maxOrMin, currentTime, SDBEtype, this); };
+    fourTokenCommandMap["avg"] = [this](const std::string& SDBEtype, const std::string& product, const std::string& currentTime, const std::string& numTimesteps) { return UserCommands::Command6_AVG(SDBEtype, product, currentTime, numTimesteps, this); };
+    fourTokenCommandMap["median"] = [this](const std::string& SDBEtype, const std::string& product, const std::string& currentTime, const std::string& numTimesteps) { return UserCommands::Command10_MEDIAN(SDBEtype, product, currentTime, numTimesteps, this); };
+    fourTokenCommandMap["impact"] = [this](const std::string& SDBEtype, const std::string& product, const std::string& currentTime, const std::string& amount) { return UserCommands::Command13_IMPACT(SDBEtype, product, currentTime, amount, this); };
+    fourTokenCommandMap["vwap"] = [this](const std::string& SDBEtype, const std::string& product, const std::string& currentTime, const std::string& numTimesteps) { return UserCommands::Command14_VWAP(SDBEtype, product, currentTime, numTimesteps, this); };
+    fourTokenCommandMap["vwmedian"] = [this](const std::string& SDBEtype, const std::string& product, const std::string& currentTime, const std::string& numTimesteps) { return UserCommands::Command15_VWMEDIAN(SDBEtype, product, currentTime, numTimesteps, this); };
+    fourTokenCommandMap["volume"] = [this](const std::string& SDBEtype, const std::string& product, const std::string& currentTime, const std::string& numTimesteps) { return UserCommands::Command16_VOLUME(SDBEtype, product, currentTime, numTimesteps, this); };
+    fourTokenCommandMap["vol"] = [this](const std::string& SDBEtype, const std::string& product, const std::string& currentTime, const std::string& numTimesteps) { return UserCommands::Command19_VOL(SDBEtype, product, currentTime, numTimesteps, this); };
+    fourTokenCommandMap["zscore"] = [this](const std::string& SDBEtype, const std::string& product, const std::string& currentTime, const std::string& numTimesteps) { return UserCommands::Command20_ZSCORE(SDBEtype, product, currentTime, numTimesteps, this); };
+    fourTokenCommandMap["backtest"] = [this](const std::string& span, const std::string& product, const std::string& /*currentTime*/, const std::string& threshold) { return UserCommands::Command22_BACKTEST(product, span, threshold, this); };
+    fourTokenCommandMap["buy"] = [this](const std::string& amount, const std::string& product, const std::string& currentTime, const std::string& price) { return UserCommands::Command25_BUY(product, amount, price, currentTime, this); };
+    fourTokenCommandMap["sell"] = [this](const std::string& amount, const std::string& product, const std::string& currentTime, const std::string& price) { return UserCommands::Command26_SELL(product, amount, price, currentTime, this); };
+    fourTokenCommandMap["predict"] = [this](const std::string& product, const std::string& maxOrMin, const std::string& currentTime, const std::string& SDBEtype) { return UserCommands::Command7_PREDICT(product, maxOrMin, currentTime, SDBEtype, this); };
+
+    // Populate five token command map with user inputs mapped to static function pointers representing commands
+
+    fiveTokenCommandMap["candles"] = [this](const std::string& product, const std::string& SDBEtype, const std::string& resolution, const std::string& numCandles, const std::string& currentTime) { return UserCommands::Command18_CANDLES(product, SDBEtype, resolution, numCandles, currentTime, this); };
+    fiveTokenCommandMap["predict"] = [this](const std::string& maxOrMin, const std::string& product, const std::string& SDBEtype, const std::string& resolution, const std::string& currentTime) { return UserCommands::Command7_PREDICT_candles(maxOrMin, product, SDBEtype, resolution, currentTime, this); };
 }
 
 /** Determine a command's validity based on token contents and quantity
@@ -111,13 +309,13 @@ void AdvisorBot::mapUserInputToCommand()
  *  @param userCommand User-entered command
  *
  */
-void AdvisorBot::processUserCommand(std::string userCommand)
+void AdvisorBot::processUserCommand(const std::string& userCommand)
 {
     // Tokenize user input based on whitespace delimiter
     std::vector<std::string> tokens = CSVFileReader::tokenize(userCommand, ' ');
 
     // Determine if the token quantity falls outside the valid command range
-    if (tokens.size() < 1 || tokens.size() > 4)
+    if (tokens.size() < 1 || tokens.size() > 5)
     {
         std::cout << "Too few or too many tokens detected" << std::endl;
         throw std::exception{};
@@ -126,6 +324,27 @@ void AdvisorBot::processUserCommand(std::string userCommand)
     // Number of user-inputted tokens parsed
     int numTokens = tokens.size();
 
+    // Commands that look beyond the current time step need the complete dataset, as do windowed commands, whose
+    // windows wrap around to the end of the dataset rather than to the end of the data loaded so far
+    static const std::set<std::string> wholeDatasetCommands{ "prod", "report", "goto", "forward", "backtest", "sweep",
+                                                             "avg", "median", "predict", "vwap", "vwmedian", "volume",
+                                                             "spread", "vol", "zscore", "corr" };
+
+    // Wait for the data the command needs, unless it needs none, in which case it names no products either
+    if (tokens[0] != "help" && tokens[0] != "status" && tokens[0] != "wallet")
+    {
+        awaitDataset(wholeDatasetCommands.count(tokens[0]) != 0);
+
+        // Products are matched regardless of case, then passed on under the dataset's name for them
+        for (std::string& token : tokens)
+        {
+            if (const std::string* product = book().findProduct(token))
+            {
+                token = *product;
+            }
+        }
+    }
+
     // Execute command based on token quantity
     switch (numTokens)
     {
@@ -149,7 +368,15 @@ void AdvisorBot::processUserCommand(std::string userCommand)
         // Execute two token command using command map given that it is recognized
         try
         {
-            twoTokenCommandMap[tokens[0] + tokens[1]]();
+            // Fixed two token commands take precedence over commands taking an argument, e.g. "help corr" over "corr 10"
+            if (twoTokenCommandMap.count(tokens[0] + tokens[1]) == 0 && twoTokenArgumentCommandMap.count(tokens[0]) != 0)
+            {
+                twoTokenArgumentCommandMap[tokens[0]](tokens[1], currentTime);
+            }
+            else
+            {
+                twoTokenCommandMap[tokens[0] + tokens[1]]();
+            }
         }
         catch (const std::exception& e)
         {
@@ -188,5 +415,20 @@ void AdvisorBot::processUserCommand(std::string userCommand)
             throw std::exception{};
         }
         break;
+    // Process five token user command
+    case 5:
+        // Execute five token command using command map given that it is recognized
+        try
+        {
+            // Retrieve CANDLES or candle-based PREDICT function from map and execute it with the user arguments in order
+            fiveTokenCommandMap[tokens[0]](tokens[1], tokens[2], tokens[3], tokens[4], currentTime);
+        }
+        catch (const std::exception& e)
+        {
+            // Five token command does not belong to the recognized command list
+            std::cout << "Unrecognized five token command" << std::endl;
+            throw std::exception{};
+        }
+        break;
     }
 }
\ No newline at end of file
@@ -2,6 +2,10 @@
 
 #include "StocksDataBookEntry.h"
 #include "StocksDataBook.h"
+#include "VersionedBook.h"
+#include "Wallet.h"
+#include "OrderMatcher.h"
+#include "BookLoader.h"
 #include <string>
 #include <vector>
 #include <stack>
@@ -9,6 +13,7 @@
 #include <functional>
 #include <iostream>
 #include <algorithm>
+#include <memory>
 #include "CSVFileReader.h"
 
 
@@ -18,14 +23,38 @@ public:
     /** Initialize an instance of the Advisor Bot class */
     AdvisorBot();
 
+    /** Initialize an instance of the Advisor Bot class over the CSV file provided */
+    AdvisorBot(std::string csvFilename);
+
+    /** Initialize an instance of the Advisor Bot class over several files merged into one dataset, loaded now or in the background */
+    AdvisorBot(std::vector<std::string> csvFilenames, const CSVReadOptions& options = CSVReadOptions{}, BookLoadMode loadMode = BookLoadMode::foreground);
+
     /** Prompt the user for input - validate and process the input and execute corresponding command */
     void init();
 
+    /** Wait until the data a command needs has been loaded, and pin the latest version of the book for the command */
+    void awaitDataset(bool wholeDataset);
+
+    /** Return the engines answering queries about the pinned version of the dataset */
+    VersionEngines& engines();
+
+    /** Return the pinned version of the dataset */
+    const StocksDataBook& book();
+
+    /** Return the progress of loading the dataset */
+    BookLoadProgress getLoadProgress();
+
     /** Current simulation timestamp */
     std::string currentTime;
 
-    /** Instantiate an SDBE with the CSV file name to be parsed */
-    StocksDataBook stocksDataBook{ "20200601.csv" };
+    /** Versions of the dataset parsed from the CSV file, each pinned by the commands reading it */
+    VersionedBook versionedBook{ StocksDataBook{ "20200601.csv" } };
+
+    /** Simulated wallet holding a balance per currency */
+    Wallet wallet;
+
+    /** Order matcher filling simulated orders against the pinned version's ladders */
+    OrderMatcher orderMatcher;
 
 private:
     /** Inform the user of how to interact with AdvisorBot */
@@ -38,20 +67,38 @@ private:
     void sanitizeUserCommand(std::string& userCommand);
 
     /** Execute the command corresponding to the user input */
-    void processUserCommand(std::string userCommand);
+    void processUserCommand(const std::string& userCommand);
 
     /** Map user input to command execution */
     void mapUserInputToCommand();
 
+    /** Pin the latest version of the book, releasing the version pinned before */
+    void pinLatestVersion();
+
+    /** Version of the book read by the current command, kept until the next command pins a newer one */
+    std::shared_ptr<const BookVersion> pinnedVersion;
+
+    /** Engines over the pinned version, replaced along with it and only ever used by the command thread */
+    std::unique_ptr<VersionEngines> pinnedEngines;
+
+    /** Loader publishing versions of the book in the background, or null if the book was loaded up front */
+    std::unique_ptr<BookLoader> bookLoader;
+
     /** Command map that maps a single user token to a command's static function pointer */
     std::map<std::string, std::function<void()>> singleTokenCommandMap;
 
     /** Command map that maps two user tokens to a command's static function pointer */
     std::map<std::string, std::function<void()>> twoTokenCommandMap;
 
+    /** Command map that maps a two token command taking an argument, keyed by its first token, to a command's static function pointer */
+    std::map<std::string, std::function<double(const std::string&, const std::string&)>> twoTokenArgumentCommandMap;
+
     /** Command map that maps three user tokens to a command's static function pointer */
-    std::map<std::string, std::function<double(std::string, std::string, std::string)>> threeTokenCommandMap;
+    std::map<std::string, std::function<double(const std::string&, const std::string&, const std::string&)>> threeTokenCommandMap;
 
     /** Command map that maps four user tokens to a command's static function pointer */
-    std::map <std::string, std::function<double(std::string, std::string, std::string, std::string)>> fourTokenCommandMap;
+    std::map <std::string, std::function<double(const std::string&, const std::string&, const std::string&, const std::string&)>> fourTokenCommandMap;
+
+    /** Command map that maps five user tokens to a command's static function pointer */
+    std::map <std::string, std::function<double(const std::string&, const std::string&, const std::string&, const std::string&, const std::string&)>> fiveTokenCommandMap;
 };
\ No newline at end of file
@@ -0,0 +1,135 @@
+#include "AllocationCounter.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+    // Process-wide allocation statistics, updated by the replacement allocation functions below
+    std::atomic<std::size_t> allocationCount{ 0 };
+    std::atomic<std::size_t> allocatedBytes{ 0 };
+
+    /** Allocate memory from the heap and record the request */
+    void* countedAllocate(std::size_t size)
+    {
+        // Record the allocation without imposing any ordering on other memory operations
+        allocationCount.fetch_add(1, std::memory_order_relaxed);
+        allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+
+        // A zero-sized request must still return a unique pointer
+        return std::malloc(size != 0 ? size : 1);
+    }
+
+    /** Allocate aligned memory from the heap and record the request */
+    void* countedAllocateAligned(std::size_t size, std::size_t alignment)
+    {
+        allocationCount.fetch_add(1, std::memory_order_relaxed);
+        allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+
+        // aligned_alloc requires the size to be a multiple of the alignment
+        std::size_t roundedSize = (size + alignment - 1) / alignment * alignment;
+        return std::aligned_alloc(alignment, roundedSize != 0 ? roundedSize : alignment);
+    }
+}
+
+/** Return the number of heap allocations performed by the process so far
+ *
+ *  @return number of calls to the global allocation functions
+ *
+ */
+std::size_t AllocationCounter::getAllocationCount()
+{
+    return allocationCount.load(std::memory_order_relaxed);
+}
+
+/** Return the number of bytes requested from the heap by the process so far
+ *
+ *  @return total size of all requests made to the global allocation functions
+ *
+ */
+std::size_t AllocationCounter::getAllocatedBytes()
+{
+    return allocatedBytes.load(std::memory_order_relaxed);
+}
+
+// Replacement global allocation functions
+
+void* operator new(std::size_t size)
+{
+    void* memory = countedAllocate(size);
+    if (memory == nullptr)
+    {
+        throw std::bad_alloc{};
+    }
+    return memory;
+}
+
+void* operator new[](std::size_t size)
+{
+    return ::operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return countedAllocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return countedAllocate(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    void* memory = countedAllocateAligned(size, static_cast<std::size_t>(alignment));
+    if (memory == nullptr)
+    {
+        throw std::bad_alloc{};
+    }
+    return memory;
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return ::operator new(size, alignment);
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory, std::align_val_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t, std::align_val_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t, std::align_val_t) noexcept
+{
+    std::free(memory);
+}
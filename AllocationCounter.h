@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstddef>
+
+class AllocationCounter
+{
+public:
+    /** Return the number of heap allocations performed by the process so far */
+    static std::size_t getAllocationCount();
+
+    /** Return the number of bytes requested from the heap by the process so far */
+    static std::size_t getAllocatedBytes();
+};
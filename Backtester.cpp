@@ -0,0 +1,152 @@
+#include "Backtester.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+/** Initialize a strategy trading on the EWMA prediction of the mid price
+ *
+ *  @param _span      Number of time steps of the EWMA, giving a smoothing factor of 2 / (span + 1)
+ *  @param _threshold Fraction by which the prediction must clear the best price before trading
+ *
+ */
+EWMAStrategy::EWMAStrategy(std::size_t _span, double _threshold)
+    : smoothingFactor(2.0 / (std::max<std::size_t>(1, _span) + 1)),
+    threshold(_threshold),
+    EWMA(0),
+    hasEWMA(false)
+{
+}
+
+/** Return the strategy to its initial state before a replay */
+void EWMAStrategy::reset()
+{
+    EWMA = 0;
+    hasEWMA = false;
+}
+
+/** Buy when the predicted mid price exceeds the best ask, and sell when it falls below the best bid, by more than the threshold
+ *
+ *  The EWMA of the mid prices up to the current time step is the prediction for the next time step
+ *
+ *  @param tick     Market of the current time step
+ *  @param position Base currency position currently held
+ *  @return         buy, sell or hold
+ *
+ */
+TradeSignal EWMAStrategy::onTick(const MarketTick& tick, double position)
+{
+    // A one-sided book gives neither a mid price nor a price to trade at
+    if (std::isnan(tick.bestBid) || std::isnan(tick.bestAsk))
+    {
+        return TradeSignal::hold;
+    }
+
+    // Update the EWMA incrementally, seeding it with the first mid price
+    double midPrice = (tick.bestBid + tick.bestAsk) * 0.5;
+    EWMA = hasEWMA ? midPrice * smoothingFactor + (1 - smoothingFactor) * EWMA : midPrice;
+    hasEWMA = true;
+
+    if (position <= 0 && EWMA > tick.bestAsk * (1 + threshold))
+    {
+        return TradeSignal::buy;
+    }
+    if (position > 0 && EWMA < tick.bestBid * (1 - threshold))
+    {
+        return TradeSignal::sell;
+    }
+    return TradeSignal::hold;
+}
+
+/** Initialize a backtester over a StocksDataBook
+ *
+ *  @param _stocksDataBook Dataset that is replayed
+ *
+ */
+Backtester::Backtester(const StocksDataBook& _stocksDataBook)
+    : stocksDataBook(_stocksDataBook)
+{
+}
+
+/** Return the market ticks of a product at every time step, building them on first use
+ *
+ *  Ticks are derived from the per time step aggregates, so a replay never revisits the SDBEs
+ *
+ *  @param product Product name
+ *  @return        one tick per time step of the dataset
+ *
+ */
+const std::vector<MarketTick>& Backtester::getMarketTicks(const std::string& product)
+{
+    auto it = marketTicks.find(product);
+    if (it != marketTicks.end())
+    {
+        return it->second;
+    }
+
+    const std::vector<TimeStepAggregate>& bidAggregates = stocksDataBook.getTimeStepAggregates(product, StocksDataBookType::bid);
+    const std::vector<TimeStepAggregate>& askAggregates = stocksDataBook.getTimeStepAggregates(product, StocksDataBookType::ask);
+
+    std::vector<MarketTick> ticks(bidAggregates.size());
+    const double missing = std::numeric_limits<double>::quiet_NaN();
+    for (std::size_t i = 0; i < ticks.size(); ++i)
+    {
+        const TimeStepAggregate& bids = bidAggregates[i];
+        const TimeStepAggregate& asks = askAggregates[i];
+        ticks[i] = MarketTick{ i, bids.entries != 0 ? bids.maxPrice : missing, asks.entries != 0 ? asks.minPrice : missing, bids.sumAmount, asks.sumAmount };
+    }
+    return marketTicks[product] = std::move(ticks);
+}
+
+/** Replay market ticks through a strategy, trading a fixed amount at the best prices
+ *
+ *  Buys fill at the best ask and sells at the best bid. The position is marked to the mid price of the
+ *  latest two-sided time step to track the profit and loss and its drawdown
+ *
+ *  @param ticks       Market ticks in time order
+ *  @param strategy    Strategy deciding at every tick, reset before the replay
+ *  @param tradeAmount Base currency amount of each trade
+ *  @return            trades, final profit and loss and maximum drawdown
+ *
+ */
+BacktestResult Backtester::replay(const std::vector<MarketTick>& ticks, TradingStrategy& strategy, double tradeAmount)
+{
+    BacktestResult result;
+    strategy.reset();
+
+    double markPrice = 0;
+    double peakEquity = 0;
+    for (const MarketTick& tick : ticks)
+    {
+        TradeSignal signal = strategy.onTick(tick, result.position);
+        if (signal == TradeSignal::buy && !std::isnan(tick.bestAsk))
+        {
+            result.cash -= tick.bestAsk * tradeAmount;
+            result.position += tradeAmount;
+            result.trades.push_back(BacktestTrade{ tick.timeStep, signal, tick.bestAsk, tradeAmount });
+        }
+        else if (signal == TradeSignal::sell && !std::isnan(tick.bestBid))
+        {
+            result.cash += tick.bestBid * tradeAmount;
+            result.position -= tradeAmount;
+            result.trades.push_back(BacktestTrade{ tick.timeStep, signal, tick.bestBid, tradeAmount });
+        }
+
+        // Mark to market, keeping the previous mark through one-sided time steps
+        if (!std::isnan(tick.bestBid) && !std::isnan(tick.bestAsk))
+        {
+            markPrice = (tick.bestBid + tick.bestAsk) * 0.5;
+        }
+        double equity = result.cash + result.position * markPrice;
+        peakEquity = std::max(peakEquity, equity);
+        result.maxDrawdown = std::max(result.maxDrawdown, peakEquity - equity);
+        result.profitAndLoss = equity;
+        ++result.ticks;
+    }
+    return result;
+}
+
+/** Discard all cached market ticks */
+void Backtester::clearCache()
+{
+    marketTicks.clear();
+}
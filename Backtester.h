@@ -0,0 +1,114 @@
+#pragma once
+
+#include "StocksDataBookEntry.h"
+#include "StocksDataBook.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <map>
+
+/** Structure is used to describe the market of one product at one time step, as seen by a strategy */
+struct MarketTick
+{
+    // Position of the time step within getTimeSteps()
+    std::size_t timeStep;
+
+    // Best bid (max bid) and best ask (min ask), NaN if the side has no SDBEs at the time step
+    double bestBid;
+    double bestAsk;
+
+    // Amounts offered across each side
+    double bidAmount;
+    double askAmount;
+};
+
+/** Establish the decisions a strategy can take at a time step */
+enum class TradeSignal
+{
+    hold,
+    buy,
+    sell
+};
+
+/** Structure is used to record one simulated fill */
+struct BacktestTrade
+{
+    std::size_t timeStep;
+    TradeSignal side;
+    double price;
+    double amount;
+};
+
+/** Structure is used to return the outcome of replaying a product through a strategy */
+struct BacktestResult
+{
+    std::vector<BacktestTrade> trades;
+    std::size_t ticks = 0;
+
+    // Quote currency held and base currency position at the end of the replay
+    double cash = 0;
+    double position = 0;
+
+    // Mark-to-market profit and loss at the end of the replay, and the largest fall from a previous peak
+    double profitAndLoss = 0;
+    double maxDrawdown = 0;
+};
+
+class TradingStrategy
+{
+public:
+    virtual ~TradingStrategy() = default;
+
+    /** Return the strategy to its initial state before a replay */
+    virtual void reset() = 0;
+
+    /** Decide what to do at a time step, given the position currently held */
+    virtual TradeSignal onTick(const MarketTick& tick, double position) = 0;
+};
+
+class EWMAStrategy : public TradingStrategy
+{
+public:
+    /** Initialize a strategy trading on the EWMA prediction of the mid price */
+    EWMAStrategy(std::size_t _span, double _threshold);
+
+    /** Return the strategy to its initial state before a replay */
+    void reset() override;
+
+    /** Buy when the predicted mid price exceeds the best ask, and sell when it falls below the best bid, by more than the threshold */
+    TradeSignal onTick(const MarketTick& tick, double position) override;
+
+private:
+    /** Smoothing factor 2 / (span + 1), as used by the predict command */
+    double smoothingFactor;
+
+    /** Fraction by which the prediction must clear the best price before trading */
+    double threshold;
+
+    /** EWMA of the mid prices seen so far, and whether it has been seeded */
+    double EWMA;
+    bool hasEWMA;
+};
+
+class Backtester
+{
+public:
+    /** Initialize a backtester over a StocksDataBook */
+    Backtester(const StocksDataBook& _stocksDataBook);
+
+    /** Return the market ticks of a product at every time step, building them on first use */
+    const std::vector<MarketTick>& getMarketTicks(const std::string& product);
+
+    /** Replay market ticks through a strategy, trading a fixed amount at the best prices */
+    static BacktestResult replay(const std::vector<MarketTick>& ticks, TradingStrategy& strategy, double tradeAmount);
+
+    /** Discard all cached market ticks */
+    void clearCache();
+
+private:
+    /** Dataset that is replayed */
+    const StocksDataBook& stocksDataBook;
+
+    /** Market ticks built so far, keyed by product */
+    std::map<std::string, std::vector<MarketTick>> marketTicks;
+};
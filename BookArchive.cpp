@@ -0,0 +1,742 @@
+#include "BookArchive.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <unordered_map>
+
+namespace
+{
+    // Written at the start and at the end of every archive
+    const char archiveMagic[8] = { 'S', 'D', 'B', 'A', 'R', 'C', 'H', '1' };
+    const std::uint32_t archiveVersion = 1;
+
+    // Number of encoded columns per block: timestamps, products, types, prices and amounts
+    const int columnsPerBlock = 5;
+
+    /** Append a fixed-width integer in little-endian byte order */
+    template <typename T>
+    void putFixed(std::vector<std::uint8_t>& bytes, T value)
+    {
+        std::uint64_t bits = static_cast<std::uint64_t>(value);
+        for (std::size_t i = 0; i < sizeof(T); ++i)
+        {
+            bytes.push_back(static_cast<std::uint8_t>(bits >> (8 * i)));
+        }
+    }
+
+    /** Read a fixed-width little-endian integer, advancing the position */
+    template <typename T>
+    T getFixed(const std::uint8_t* bytes, std::size_t& position)
+    {
+        std::uint64_t bits = 0;
+        for (std::size_t i = 0; i < sizeof(T); ++i)
+        {
+            bits |= static_cast<std::uint64_t>(bytes[position + i]) << (8 * i);
+        }
+        position += sizeof(T);
+        return static_cast<T>(bits);
+    }
+
+    /** Append an unsigned LEB128 varint */
+    void putVarint(std::vector<std::uint8_t>& bytes, std::uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            bytes.push_back(static_cast<std::uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        bytes.push_back(static_cast<std::uint8_t>(value));
+    }
+
+    /** Read an unsigned LEB128 varint from the first size bytes, advancing the position
+     *
+     *  @return false if the varint runs past the end of the bytes or is longer than 64 bits
+     */
+    bool getVarint(const std::uint8_t* bytes, std::size_t size, std::size_t& position, std::uint64_t& value)
+    {
+        value = 0;
+        for (int shift = 0; shift < 64; shift += 7)
+        {
+            if (position >= size)
+            {
+                return false;
+            }
+            std::uint8_t byte = bytes[position++];
+            value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /** Map signed values onto unsigned values so that small magnitudes give short varints */
+    std::uint64_t zigZagEncode(std::int64_t value)
+    {
+        return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+    }
+
+    std::int64_t zigZagDecode(std::uint64_t value)
+    {
+        return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+    }
+
+    /** Packs values of arbitrary bit widths, most significant bit first */
+    class BitWriter
+    {
+    public:
+        BitWriter(std::vector<std::uint8_t>& _bytes) : bytes(_bytes), current(0), used(0) {}
+
+        void write(std::uint64_t value, int bits)
+        {
+            while (bits > 0)
+            {
+                int take = std::min(8 - used, bits);
+                std::uint8_t chunk = static_cast<std::uint8_t>((value >> (bits - take)) & ((1u << take) - 1));
+                current = static_cast<std::uint8_t>(current | (chunk << (8 - used - take)));
+                used += take;
+                bits -= take;
+                if (used == 8)
+                {
+                    bytes.push_back(current);
+                    current = 0;
+                    used = 0;
+                }
+            }
+        }
+
+        /** Write out the partially filled final byte */
+        void flush()
+        {
+            if (used > 0)
+            {
+                bytes.push_back(current);
+                current = 0;
+                used = 0;
+            }
+        }
+
+    private:
+        std::vector<std::uint8_t>& bytes;
+        std::uint8_t current;
+        int used;
+    };
+
+    /** Unpacks values written by BitWriter from the first size bytes
+     *
+     *  Reads past the end return zero bits and mark the reader as overrun
+     */
+    class BitReader
+    {
+    public:
+        BitReader(const std::uint8_t* _bytes, std::size_t size) : bytes(_bytes), bitCount(size * 8), position(0), overrun(false) {}
+
+        std::uint64_t read(int bits)
+        {
+            if (position + static_cast<std::size_t>(bits) > bitCount)
+            {
+                overrun = true;
+                position = bitCount;
+                return 0;
+            }
+
+            std::uint64_t value = 0;
+            while (bits > 0)
+            {
+                int offset = static_cast<int>(position & 7);
+                int take = std::min(8 - offset, bits);
+                std::uint8_t chunk = static_cast<std::uint8_t>((bytes[position >> 3] >> (8 - offset - take)) & ((1u << take) - 1));
+                value = (value << take) | chunk;
+                position += take;
+                bits -= take;
+            }
+            return value;
+        }
+
+        /** Return true if a read went past the end of the bytes */
+        bool isOverrun() const
+        {
+            return overrun;
+        }
+
+    private:
+        const std::uint8_t* bytes;
+        std::size_t bitCount;
+        std::size_t position;
+        bool overrun;
+    };
+
+    std::uint64_t doubleToBits(double value)
+    {
+        std::uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+
+    double bitsToDouble(std::uint64_t bits)
+    {
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    /** Gorilla-style float compression: each value is XORed with its predecessor and only the meaningful bits are kept
+     *
+     *  A zero XOR costs one bit. A non-zero XOR reuses the previous leading/trailing zero window when it fits,
+     *  and otherwise stores a new window as 5 bits of leading zeros and 6 bits of meaningful length
+     */
+    void encodeFloats(const std::vector<double>& values, std::vector<std::uint8_t>& bytes)
+    {
+        if (values.empty())
+        {
+            return;
+        }
+
+        BitWriter writer{ bytes };
+        std::uint64_t previous = doubleToBits(values[0]);
+        writer.write(previous, 64);
+
+        int previousLeading = -1;
+        int previousTrailing = 0;
+        for (std::size_t i = 1; i < values.size(); ++i)
+        {
+            std::uint64_t bits = doubleToBits(values[i]);
+            std::uint64_t xorValue = bits ^ previous;
+            previous = bits;
+
+            if (xorValue == 0)
+            {
+                writer.write(0, 1);
+                continue;
+            }
+            writer.write(1, 1);
+
+            int leading = std::min(__builtin_clzll(xorValue), 31);
+            int trailing = __builtin_ctzll(xorValue);
+            if (previousLeading >= 0 && leading >= previousLeading && trailing >= previousTrailing)
+            {
+                // Meaningful bits fit inside the previous window
+                writer.write(0, 1);
+                writer.write(xorValue >> previousTrailing, 64 - previousLeading - previousTrailing);
+            }
+            else
+            {
+                int meaningful = 64 - leading - trailing;
+                writer.write(1, 1);
+                writer.write(static_cast<std::uint64_t>(leading), 5);
+                writer.write(static_cast<std::uint64_t>(meaningful - 1), 6);
+                writer.write(xorValue >> trailing, meaningful);
+                previousLeading = leading;
+                previousTrailing = trailing;
+            }
+        }
+        writer.flush();
+    }
+
+    /** Reverse encodeFloats() for a known number of values held in the first size bytes
+     *
+     *  @return false if the bytes are exhausted or describe an impossible bit window
+     */
+    bool decodeFloats(const std::uint8_t* bytes, std::size_t size, std::size_t count, std::vector<double>& values)
+    {
+        values.resize(count);
+        if (count == 0)
+        {
+            return true;
+        }
+
+        BitReader reader{ bytes, size };
+        std::uint64_t previous = reader.read(64);
+        values[0] = bitsToDouble(previous);
+
+        int leading = 0;
+        int trailing = 0;
+        for (std::size_t i = 1; i < count; ++i)
+        {
+            if (reader.read(1) != 0)
+            {
+                if (reader.read(1) != 0)
+                {
+                    leading = static_cast<int>(reader.read(5));
+                    int meaningful = static_cast<int>(reader.read(6)) + 1;
+                    trailing = 64 - leading - meaningful;
+                    if (trailing < 0)
+                    {
+                        return false;
+                    }
+                }
+                previous ^= reader.read(64 - leading - trailing) << trailing;
+            }
+            values[i] = bitsToDouble(previous);
+        }
+        return !reader.isOverrun();
+    }
+
+    /** Run-length encode small codes as (code, run length) varint pairs */
+    void encodeRuns(const std::vector<std::uint32_t>& codes, std::vector<std::uint8_t>& bytes)
+    {
+        for (std::size_t i = 0; i < codes.size();)
+        {
+            std::size_t runEnd = i + 1;
+            while (runEnd < codes.size() && codes[runEnd] == codes[i])
+            {
+                ++runEnd;
+            }
+            putVarint(bytes, codes[i]);
+            putVarint(bytes, runEnd - i);
+            i = runEnd;
+        }
+    }
+
+    /** Reverse encodeRuns() for a known number of codes held in the first size bytes
+     *
+     *  @return false if the bytes are exhausted, a run is empty or a code is not below codeLimit
+     */
+    bool decodeRuns(const std::uint8_t* bytes, std::size_t size, std::size_t count, std::uint64_t codeLimit, std::vector<std::uint32_t>& codes)
+    {
+        codes.clear();
+        codes.reserve(count);
+        std::size_t position = 0;
+        while (codes.size() < count)
+        {
+            std::uint64_t code, runLength;
+            if (!getVarint(bytes, size, position, code) || !getVarint(bytes, size, position, runLength) || runLength == 0 || code >= codeLimit)
+            {
+                return false;
+            }
+            codes.insert(codes.end(), std::min<std::uint64_t>(runLength, count - codes.size()), static_cast<std::uint32_t>(code));
+        }
+        return true;
+    }
+
+    /** Append an encoded column prefixed with its length, so that readers can locate the next column */
+    void putColumn(std::vector<std::uint8_t>& block, const std::vector<std::uint8_t>& column)
+    {
+        putFixed<std::uint32_t>(block, static_cast<std::uint32_t>(column.size()));
+        block.insert(block.end(), column.begin(), column.end());
+    }
+
+    /** Print an error about an archive file and abort the operation */
+    [[noreturn]] void failArchive(const std::string& filename, const std::string& message)
+    {
+        std::cout << "Book archive " << filename << ": " << message << std::endl;
+        throw std::exception{};
+    }
+}
+
+/** Encode SDBEs into a compressed columnar archive file
+ *
+ *  The file holds a header with the product dictionary, the encoded blocks, a block directory and a footer
+ *  locating the directory. Within a block, timestamps are delta encoded as zigzag varints, products and types
+ *  are dictionary codes stored as runs, and prices and amounts use Gorilla-style XOR compression
+ *
+ *  @param filename     Archive file to be written
+ *  @param entries      SDBEs to be archived, kept in their order
+ *  @param rowsPerBlock Number of SDBEs per block, the unit of decoding
+ *
+ */
+void BookArchive::write(const std::string& filename, const std::vector<StocksDataBookEntry>& entries, std::size_t rowsPerBlock)
+{
+    rowsPerBlock = std::max<std::size_t>(1, rowsPerBlock);
+
+    // Assign dictionary codes in order of first occurrence
+    std::vector<std::string> dictionary;
+    std::unordered_map<std::string, std::uint32_t> productCodes;
+    for (const StocksDataBookEntry& entry : entries)
+    {
+        if (productCodes.emplace(entry.product, static_cast<std::uint32_t>(dictionary.size())).second)
+        {
+            dictionary.push_back(entry.product);
+        }
+    }
+
+    std::ofstream outputFile{ filename, std::ios::binary | std::ios::trunc };
+    if (!outputFile.is_open())
+    {
+        failArchive(filename, "cannot be opened for writing.");
+    }
+
+    // Header: magic, version, block size and product dictionary
+    std::vector<std::uint8_t> bytes(archiveMagic, archiveMagic + sizeof(archiveMagic));
+    putFixed<std::uint32_t>(bytes, archiveVersion);
+    putFixed<std::uint32_t>(bytes, static_cast<std::uint32_t>(rowsPerBlock));
+    putFixed<std::uint32_t>(bytes, static_cast<std::uint32_t>(dictionary.size()));
+    for (const std::string& product : dictionary)
+    {
+        putFixed<std::uint32_t>(bytes, static_cast<std::uint32_t>(product.size()));
+        bytes.insert(bytes.end(), product.begin(), product.end());
+    }
+    outputFile.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    std::uint64_t offset = bytes.size();
+
+    // Column buffers reused across blocks
+    std::vector<ArchiveBlockInfo> directory;
+    std::vector<std::uint8_t> timeColumn, productColumn, typeColumn, priceColumn, amountColumn;
+    std::vector<std::uint32_t> productCodesOfBlock, typeCodesOfBlock;
+    std::vector<double> prices, amounts;
+
+    for (std::size_t begin = 0; begin < entries.size(); begin += rowsPerBlock)
+    {
+        std::size_t end = std::min(entries.size(), begin + rowsPerBlock);
+        ArchiveBlockInfo block{ offset, 0, static_cast<std::uint32_t>(end - begin), entries[begin].timestamp, entries[begin].timestamp, 0 };
+
+        timeColumn.clear();
+        productColumn.clear();
+        typeColumn.clear();
+        priceColumn.clear();
+        amountColumn.clear();
+        productCodesOfBlock.clear();
+        typeCodesOfBlock.clear();
+        prices.clear();
+        amounts.clear();
+
+        // Split the rows into columns, tracking the block's time range and products
+        std::int64_t previousTime = 0;
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            const StocksDataBookEntry& entry = entries[i];
+            putVarint(timeColumn, zigZagEncode(entry.timestamp - previousTime));
+            previousTime = entry.timestamp;
+            block.minTime = std::min(block.minTime, entry.timestamp);
+            block.maxTime = std::max(block.maxTime, entry.timestamp);
+
+            std::uint32_t productCode = productCodes[entry.product];
+            productCodesOfBlock.push_back(productCode);
+            block.productMask |= productCode < 64 ? (1ULL << productCode) : ~0ULL;
+
+            typeCodesOfBlock.push_back(static_cast<std::uint32_t>(entry.SDBEtype));
+            prices.push_back(entry.price);
+            amounts.push_back(entry.amount);
+        }
+        encodeRuns(productCodesOfBlock, productColumn);
+        encodeRuns(typeCodesOfBlock, typeColumn);
+        encodeFloats(prices, priceColumn);
+        encodeFloats(amounts, amountColumn);
+
+        bytes.clear();
+        putColumn(bytes, timeColumn);
+        putColumn(bytes, productColumn);
+        putColumn(bytes, typeColumn);
+        putColumn(bytes, priceColumn);
+        putColumn(bytes, amountColumn);
+        outputFile.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+
+        block.bytes = static_cast<std::uint32_t>(bytes.size());
+        directory.push_back(block);
+        offset += bytes.size();
+    }
+
+    // Directory followed by a fixed-size footer, so that readers can find it from the end of the file
+    bytes.clear();
+    for (const ArchiveBlockInfo& block : directory)
+    {
+        putFixed<std::uint64_t>(bytes, block.offset);
+        putFixed<std::uint32_t>(bytes, block.bytes);
+        putFixed<std::uint32_t>(bytes, block.rows);
+        putFixed<std::int64_t>(bytes, block.minTime);
+        putFixed<std::int64_t>(bytes, block.maxTime);
+        putFixed<std::uint64_t>(bytes, block.productMask);
+    }
+    putFixed<std::uint64_t>(bytes, offset);
+    putFixed<std::uint32_t>(bytes, static_cast<std::uint32_t>(directory.size()));
+    putFixed<std::uint64_t>(bytes, entries.size());
+    bytes.insert(bytes.end(), archiveMagic, archiveMagic + sizeof(archiveMagic));
+    outputFile.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+
+    if (!outputFile.good())
+    {
+        failArchive(filename, "could not be written.");
+    }
+}
+
+/** Return true if a filename carries the archive extension
+ *
+ *  @param filename Filename to be checked
+ *  @return         true if the filename ends with the archive extension
+ *
+ */
+bool BookArchive::isArchiveFilename(const std::string& filename)
+{
+    std::size_t extensionLength = std::strlen(extension);
+    return filename.size() > extensionLength && filename.compare(filename.size() - extensionLength, extensionLength, extension) == 0;
+}
+
+/** Open an archive, reading its product dictionary and block directory only
+ *
+ *  @param filename Archive file written by write()
+ *
+ */
+BookArchive::BookArchive(const std::string& filename)
+    : archiveFilename(filename),
+    archiveFile(filename, std::ios::binary),
+    rowCount(0),
+    blocksDecoded(0)
+{
+    if (!archiveFile.is_open())
+    {
+        failArchive(filename, "cannot be opened.");
+    }
+
+    // Footer: directory offset, block count, row count and magic
+    const std::size_t footerBytes = 8 + 4 + 8 + sizeof(archiveMagic);
+    archiveFile.seekg(0, std::ios::end);
+    std::uint64_t fileBytes = static_cast<std::uint64_t>(archiveFile.tellg());
+    std::vector<std::uint8_t> bytes(footerBytes);
+    if (fileBytes < sizeof(archiveMagic) + 12 + footerBytes)
+    {
+        failArchive(filename, "is too short to be an archive.");
+    }
+    archiveFile.seekg(static_cast<std::streamoff>(fileBytes - footerBytes));
+    archiveFile.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(footerBytes));
+    if (std::memcmp(bytes.data() + footerBytes - sizeof(archiveMagic), archiveMagic, sizeof(archiveMagic)) != 0)
+    {
+        failArchive(filename, "is not an archive or is truncated.");
+    }
+    std::size_t position = 0;
+    std::uint64_t directoryOffset = getFixed<std::uint64_t>(bytes.data(), position);
+    std::uint32_t blockCount = getFixed<std::uint32_t>(bytes.data(), position);
+    rowCount = getFixed<std::uint64_t>(bytes.data(), position);
+
+    // Block directory, which must end exactly where the footer begins
+    const std::size_t directoryEntryBytes = 8 + 4 + 4 + 8 + 8 + 8;
+    if (directoryOffset + static_cast<std::uint64_t>(blockCount) * directoryEntryBytes + footerBytes != fileBytes)
+    {
+        failArchive(filename, "has a damaged footer.");
+    }
+    bytes.resize(blockCount * directoryEntryBytes);
+    archiveFile.seekg(static_cast<std::streamoff>(directoryOffset));
+    archiveFile.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    if (!archiveFile.good())
+    {
+        failArchive(filename, "has a damaged block directory.");
+    }
+    position = 0;
+    blocks.reserve(blockCount);
+    for (std::uint32_t i = 0; i < blockCount; ++i)
+    {
+        ArchiveBlockInfo block;
+        block.offset = getFixed<std::uint64_t>(bytes.data(), position);
+        block.bytes = getFixed<std::uint32_t>(bytes.data(), position);
+        block.rows = getFixed<std::uint32_t>(bytes.data(), position);
+        block.minTime = getFixed<std::int64_t>(bytes.data(), position);
+        block.maxTime = getFixed<std::int64_t>(bytes.data(), position);
+        block.productMask = getFixed<std::uint64_t>(bytes.data(), position);
+        if (block.offset + block.bytes > directoryOffset)
+        {
+            failArchive(filename, "has a damaged block directory.");
+        }
+        blocks.push_back(block);
+    }
+
+    // Header and product dictionary occupy everything before the first block
+    std::uint64_t headerBytes = blocks.empty() ? directoryOffset : blocks.front().offset;
+    if (headerBytes < sizeof(archiveMagic) + 12 || headerBytes > directoryOffset)
+    {
+        failArchive(filename, "has an unsupported header.");
+    }
+    bytes.resize(static_cast<std::size_t>(headerBytes));
+    archiveFile.seekg(0);
+    archiveFile.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    position = sizeof(archiveMagic);
+    if (std::memcmp(bytes.data(), archiveMagic, sizeof(archiveMagic)) != 0 || getFixed<std::uint32_t>(bytes.data(), position) != archiveVersion)
+    {
+        failArchive(filename, "has an unsupported header.");
+    }
+    getFixed<std::uint32_t>(bytes.data(), position);
+    std::uint32_t productCount = getFixed<std::uint32_t>(bytes.data(), position);
+    for (std::uint32_t i = 0; i < productCount; ++i)
+    {
+        std::uint32_t length = position + 4 <= bytes.size() ? getFixed<std::uint32_t>(bytes.data(), position) : 0;
+        if (position + length > bytes.size())
+        {
+            failArchive(filename, "has a damaged product dictionary.");
+        }
+        products.emplace_back(reinterpret_cast<const char*>(bytes.data() + position), length);
+        position += length;
+    }
+}
+
+/** Decode every block of the archive in file order
+ *
+ *  @return all SDBEs of the archive, in the order they were written
+ *
+ */
+std::vector<StocksDataBookEntry> BookArchive::readAll()
+{
+    std::vector<StocksDataBookEntry> entries;
+    entries.reserve(static_cast<std::size_t>(rowCount));
+    for (const ArchiveBlockInfo& block : blocks)
+    {
+        decodeBlock(block, entries);
+    }
+    return entries;
+}
+
+/** Decode a single block of the archive
+ *
+ *  @param blockIndex Position of the block within getBlocks()
+ *  @return           SDBEs of the block, in the order they were written
+ *
+ */
+std::vector<StocksDataBookEntry> BookArchive::readBlock(std::size_t blockIndex)
+{
+    std::vector<StocksDataBookEntry> entries;
+    decodeBlock(blocks.at(blockIndex), entries);
+    return entries;
+}
+
+/** Decode the SDBEs of one product within [fromTime, toTime], touching only the blocks that may contain them
+ *
+ *  Blocks are skipped using the time range and product mask held in the directory
+ *
+ *  @param product  Product name
+ *  @param fromTime Earliest timestamp, in microseconds since 1970/01/01
+ *  @param toTime   Latest timestamp, in microseconds since 1970/01/01
+ *  @return         matching SDBEs in archive order
+ *
+ */
+std::vector<StocksDataBookEntry> BookArchive::query(const std::string& product, std::int64_t fromTime, std::int64_t toTime)
+{
+    std::vector<StocksDataBookEntry> matches;
+
+    auto it = std::find(products.begin(), products.end(), product);
+    if (it == products.end())
+    {
+        return matches;
+    }
+    std::size_t productCode = static_cast<std::size_t>(it - products.begin());
+    std::uint64_t productBit = productCode < 64 ? (1ULL << productCode) : ~0ULL;
+
+    std::vector<StocksDataBookEntry> blockEntries;
+    for (const ArchiveBlockInfo& block : blocks)
+    {
+        // Skip blocks outside the time range or without the product
+        if (block.maxTime < fromTime || block.minTime > toTime || (block.productMask & productBit) == 0)
+        {
+            continue;
+        }
+
+        blockEntries.clear();
+        decodeBlock(block, blockEntries);
+        for (StocksDataBookEntry& entry : blockEntries)
+        {
+            if (entry.timestamp >= fromTime && entry.timestamp <= toTime && entry.product == product)
+            {
+                matches.push_back(std::move(entry));
+            }
+        }
+    }
+    return matches;
+}
+
+/** Return the number of SDBEs in the archive
+ *
+ *  @return number of SDBEs
+ *
+ */
+std::uint64_t BookArchive::getRowCount() const
+{
+    return rowCount;
+}
+
+/** Return the product dictionary of the archive
+ *
+ *  @return products in dictionary order
+ *
+ */
+const std::vector<std::string>& BookArchive::getProducts() const
+{
+    return products;
+}
+
+/** Return the block directory of the archive
+ *
+ *  @return blocks in file order
+ *
+ */
+const std::vector<ArchiveBlockInfo>& BookArchive::getBlocks() const
+{
+    return blocks;
+}
+
+/** Return the number of blocks decoded since the archive was opened
+ *
+ *  @return number of decoded blocks
+ *
+ */
+std::size_t BookArchive::getBlocksDecoded() const
+{
+    return blocksDecoded;
+}
+
+/** Read and decode one block into the SDBEs it holds
+ *
+ *  @param block   Directory entry of the block
+ *  @param entries Receives the SDBEs of the block, appended in order
+ *
+ */
+void BookArchive::decodeBlock(const ArchiveBlockInfo& block, std::vector<StocksDataBookEntry>& entries)
+{
+    // Read the whole block, every column reader below is bounded by the block's size
+    std::vector<std::uint8_t> bytes(block.bytes, 0);
+    archiveFile.clear();
+    archiveFile.seekg(static_cast<std::streamoff>(block.offset));
+    archiveFile.read(reinterpret_cast<char*>(bytes.data()), block.bytes);
+    if (!archiveFile.good())
+    {
+        failArchive(archiveFilename, "block could not be read.");
+    }
+
+    // Locate the columns from their length prefixes
+    const std::uint8_t* columns[columnsPerBlock];
+    std::size_t columnBytes[columnsPerBlock];
+    std::size_t position = 0;
+    for (int i = 0; i < columnsPerBlock; ++i)
+    {
+        if (position + 4 > block.bytes)
+        {
+            failArchive(archiveFilename, "block is damaged.");
+        }
+        columnBytes[i] = getFixed<std::uint32_t>(bytes.data(), position);
+        columns[i] = bytes.data() + position;
+        if (columnBytes[i] > block.bytes - position)
+        {
+            failArchive(archiveFilename, "block is damaged.");
+        }
+        position += columnBytes[i];
+    }
+
+    // Every row takes at least one byte of timestamp delta, which bounds the row count before allocating
+    if (block.rows > columnBytes[0])
+    {
+        failArchive(archiveFilename, "block is damaged.");
+    }
+
+    std::vector<std::uint32_t> productCodes, typeCodes;
+    std::vector<double> prices, amounts;
+    const std::uint64_t typeLimit = static_cast<std::uint64_t>(StocksDataBookType::unknown) + 1;
+    if (!decodeRuns(columns[1], columnBytes[1], block.rows, products.size(), productCodes)
+        || !decodeRuns(columns[2], columnBytes[2], block.rows, typeLimit, typeCodes)
+        || !decodeFloats(columns[3], columnBytes[3], block.rows, prices)
+        || !decodeFloats(columns[4], columnBytes[4], block.rows, amounts))
+    {
+        failArchive(archiveFilename, "block is damaged.");
+    }
+
+    // Reassemble the rows, undoing the timestamp deltas
+    std::size_t timePosition = 0;
+    std::int64_t time = 0;
+    entries.reserve(entries.size() + block.rows);
+    for (std::uint32_t i = 0; i < block.rows; ++i)
+    {
+        std::uint64_t delta;
+        if (!getVarint(columns[0], columnBytes[0], timePosition, delta))
+        {
+            failArchive(archiveFilename, "block is damaged.");
+        }
+        time += zigZagDecode(delta);
+        entries.emplace_back(prices[i], amounts[i], time, products[productCodes[i]], static_cast<StocksDataBookType>(typeCodes[i]));
+    }
+    ++blocksDecoded;
+}
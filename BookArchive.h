@@ -0,0 +1,87 @@
+#pragma once
+
+#include "StocksDataBookEntry.h"
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/** Structure is used to describe one block of an archive without decoding it */
+struct ArchiveBlockInfo
+{
+    // Position and size of the encoded block within the archive file
+    std::uint64_t offset;
+    std::uint32_t bytes;
+
+    // Number of SDBEs in the block
+    std::uint32_t rows;
+
+    // Earliest and latest timestamp in the block, in microseconds since 1970/01/01
+    std::int64_t minTime;
+    std::int64_t maxTime;
+
+    // Bit i is set if product i of the dictionary occurs in the block (all bits set beyond 64 products)
+    std::uint64_t productMask;
+};
+
+class BookArchive
+{
+public:
+    /** Encode SDBEs into a compressed columnar archive file */
+    static void write(const std::string& filename, const std::vector<StocksDataBookEntry>& entries, std::size_t rowsPerBlock = defaultRowsPerBlock);
+
+    /** Return true if a filename carries the archive extension */
+    static bool isArchiveFilename(const std::string& filename);
+
+    /** Open an archive, reading its product dictionary and block directory only */
+    BookArchive(const std::string& filename);
+
+    /** Decode every block of the archive in file order */
+    std::vector<StocksDataBookEntry> readAll();
+
+    /** Decode a single block of the archive */
+    std::vector<StocksDataBookEntry> readBlock(std::size_t blockIndex);
+
+    /** Decode the SDBEs of one product within [fromTime, toTime], touching only the blocks that may contain them */
+    std::vector<StocksDataBookEntry> query(const std::string& product, std::int64_t fromTime, std::int64_t toTime);
+
+    /** Return the number of SDBEs in the archive */
+    std::uint64_t getRowCount() const;
+
+    /** Return the product dictionary of the archive */
+    const std::vector<std::string>& getProducts() const;
+
+    /** Return the block directory of the archive */
+    const std::vector<ArchiveBlockInfo>& getBlocks() const;
+
+    /** Return the number of blocks decoded since the archive was opened */
+    std::size_t getBlocksDecoded() const;
+
+    /** Extension identifying archive files */
+    static constexpr const char* extension = ".sdba";
+
+    /** Number of SDBEs per block unless stated otherwise */
+    static constexpr std::size_t defaultRowsPerBlock = 4096;
+
+private:
+    /** Read and decode one block into the SDBEs it holds */
+    void decodeBlock(const ArchiveBlockInfo& block, std::vector<StocksDataBookEntry>& entries);
+
+    /** Name of the archive file, used in error messages */
+    std::string archiveFilename;
+
+    /** Archive file, kept open for block reads */
+    std::ifstream archiveFile;
+
+    /** Products in dictionary order */
+    std::vector<std::string> products;
+
+    /** Directory of the encoded blocks in file order */
+    std::vector<ArchiveBlockInfo> blocks;
+
+    /** Total SDBEs in the archive */
+    std::uint64_t rowCount;
+
+    /** Blocks decoded so far */
+    std::size_t blocksDecoded;
+};
@@ -0,0 +1,262 @@
+#include "BookLoader.h"
+#include "BookArchive.h"
+#include <algorithm>
+#include <filesystem>
+#include <iterator>
+
+/** Start loading files on a background thread, publishing the SDBEs as versions of a book
+ *
+ *  A single CSV file is parsed chunk by chunk, and its SDBEs are published as they are parsed.
+ *  Several files, or a book archive, are loaded and merged as a whole and published at once
+ *
+ *  @param _filenames      Names of CSV files or book archives
+ *  @param _versionedBook  Book the SDBEs are published into, which must outlive the loader
+ *  @param options         Validation mode, quarantine stream and read method applied to every CSV file
+ *
+ */
+BookLoader::BookLoader(std::vector<std::string> _filenames, VersionedBook& _versionedBook, const CSVReadOptions& options)
+    : filenames(std::move(_filenames)),
+      versionedBook(_versionedBook),
+      startTime(std::chrono::steady_clock::now())
+{
+    progressive = filenames.size() == 1 && !BookArchive::isArchiveFilename(filenames[0]);
+
+    for (const std::string& filename : filenames)
+    {
+        std::error_code sizeError;
+        std::uintmax_t fileBytes = std::filesystem::file_size(filename, sizeError);
+        progress.totalBytes += sizeError ? 0 : static_cast<std::size_t>(fileBytes);
+    }
+
+    loaderThread = std::thread{ &BookLoader::loadLoop, this, options };
+}
+
+/** Stop loading at the next chunk and wait for the background thread */
+BookLoader::~BookLoader()
+{
+    cancelled = true;
+    if (loaderThread.joinable())
+    {
+        loaderThread.join();
+    }
+}
+
+/** Return true if every SDBE at a timestamp has been published, a negative time standing for the first time step
+ *
+ *  @param time Timestamp in microseconds, or negative for the first time step
+ *  @return     true if the time step is complete in the latest version or loading has ended
+ *
+ */
+bool BookLoader::isTimeStepReady(std::int64_t time) const
+{
+    std::lock_guard<std::mutex> lock{ mutex };
+    return isTimeStepReadyLocked(time);
+}
+
+/** Block until every SDBE at a timestamp has been published, a negative time standing for the first time step
+ *
+ *  The loader publishes a version as soon as the time step has been parsed, rather than when the book next doubles
+ *
+ *  @param time Timestamp in microseconds, or negative for the first time step
+ *
+ */
+void BookLoader::waitForTimeStep(std::int64_t time)
+{
+    std::unique_lock<std::mutex> lock{ mutex };
+    requestedTime = timeStepRequested ? std::min(requestedTime, time) : time;
+    timeStepRequested = true;
+    progressChanged.wait(lock, [this, time]() { return isTimeStepReadyLocked(time); });
+
+    // Keep the request of any other command still waiting
+    timeStepRequested = !isTimeStepReadyLocked(requestedTime);
+}
+
+/** Block until loading has ended and its last version has been published */
+void BookLoader::waitForCompletion()
+{
+    std::unique_lock<std::mutex> lock{ mutex };
+    progressChanged.wait(lock, [this]() { return progress.state != BookLoadState::loading; });
+}
+
+/** Return the progress of the load
+ *
+ *  @return snapshot of the load's progress
+ *
+ */
+BookLoadProgress BookLoader::getProgress() const
+{
+    std::lock_guard<std::mutex> lock{ mutex };
+    BookLoadProgress snapshot = progress;
+    if (snapshot.state == BookLoadState::loading)
+    {
+        snapshot.elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    }
+    return snapshot;
+}
+
+/** Return the names of the files being loaded
+ *
+ *  @return names of the files
+ *
+ */
+const std::vector<std::string>& BookLoader::getFilenames() const
+{
+    return filenames;
+}
+
+/** Parse the files, publishing SDBEs as they become available
+ *
+ *  @param options Validation mode, quarantine stream and read method applied to every CSV file
+ *
+ */
+void BookLoader::loadLoop(CSVReadOptions options)
+{
+    BookLoadState finalState = BookLoadState::complete;
+    try
+    {
+        if (progressive)
+        {
+            // Take the SDBEs of each chunk as soon as it is parsed, abandoning the load if cancelled
+            options.chunkConsumer = [this](std::vector<StocksDataBookEntry>& entries, std::size_t bytesRead)
+            {
+                if (cancelled)
+                {
+                    throw std::exception{};
+                }
+                bool publishNow;
+                {
+                    std::lock_guard<std::mutex> lock{ mutex };
+                    for (const StocksDataBookEntry& entry : entries)
+                    {
+                        inTimeOrder = inTimeOrder && entry.timestamp >= progress.latestTime;
+                        earliestTime = earliestTime < 0 ? entry.timestamp : std::min(earliestTime, entry.timestamp);
+                        progress.latestTime = std::max(progress.latestTime, entry.timestamp);
+                    }
+                    progress.rowsParsed += entries.size();
+                    progress.bytesParsed = bytesRead;
+
+                    // Each version copies the book, so publish whenever the book doubles to keep the copying linear overall,
+                    // or as soon as a waiting command's time step has been parsed
+                    publishNow = progress.rowsParsed >= 2 * progress.rowsPublished
+                        || (timeStepRequested && coversTimeStep(progress.latestTime, requestedTime));
+                }
+                pendingEntries.insert(pendingEntries.end(), std::make_move_iterator(entries.begin()), std::make_move_iterator(entries.end()));
+                entries.clear();
+
+                if (publishNow)
+                {
+                    publishPendingEntries(nullptr);
+                }
+                progressChanged.notify_all();
+            };
+
+            // The last version carries the SDBEs of the final chunks along with the load report
+            LoadReport fileLoadReport;
+            StocksDataBook::loadFile(filenames[0], fileLoadReport, options);
+            publishPendingEntries(&fileLoadReport);
+        }
+        else
+        {
+            StocksDataBook book{ filenames, options };
+            const std::vector<StocksDataBookEntry>& entries = book.getEntries();
+            {
+                std::lock_guard<std::mutex> lock{ mutex };
+                if (!entries.empty())
+                {
+                    earliestTime = entries.front().timestamp;
+                    progress.latestTime = entries.back().timestamp;
+                }
+                progress.rowsParsed = entries.size();
+                progress.bytesParsed = progress.totalBytes;
+            }
+
+            std::size_t rows = entries.size();
+            versionedBook.publish(std::move(book));
+
+            std::lock_guard<std::mutex> lock{ mutex };
+            progress.rowsPublished = rows;
+            publishedLatestTime = progress.latestTime;
+        }
+    }
+    catch (const std::exception& e)
+    {
+        // The cause has already been printed by the reader
+        finalState = BookLoadState::failed;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock{ mutex };
+        progress.state = finalState;
+        progress.elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    }
+    progressChanged.notify_all();
+}
+
+/** Publish the latest version extended with the SDBEs parsed since, along with the report once the load is complete
+ *
+ *  The latest version is copied rather than changed, as commands may be reading it meanwhile
+ *
+ *  @param fileLoadReport Report of the completed load, or null while loading
+ *
+ */
+void BookLoader::publishPendingEntries(const LoadReport* fileLoadReport)
+{
+    StocksDataBook book = versionedBook.pin()->book;
+    std::size_t rows = pendingEntries.size();
+    book.appendSDBEentries(std::move(pendingEntries));
+    pendingEntries.clear();
+
+    if (fileLoadReport != nullptr)
+    {
+        book.recordLoad(filenames, *fileLoadReport);
+    }
+
+    std::int64_t latestTime = book.getEntries().empty() ? -1 : book.getEntries().back().timestamp;
+    versionedBook.publish(std::move(book));
+
+    {
+        std::lock_guard<std::mutex> lock{ mutex };
+        progress.rowsPublished += rows;
+        publishedLatestTime = latestTime;
+    }
+    progressChanged.notify_all();
+}
+
+/** Return true if every SDBE at a timestamp has been published, with the mutex held
+ *
+ *  @param time Timestamp in microseconds, or negative for the first time step
+ *  @return     true if the time step is complete in the latest version or loading has ended
+ *
+ */
+bool BookLoader::isTimeStepReadyLocked(std::int64_t time) const
+{
+    if (progress.state != BookLoadState::loading)
+    {
+        return true;
+    }
+    return coversTimeStep(publishedLatestTime, time);
+}
+
+/** Return true if SDBEs up to a timestamp cover its time step, a negative time standing for the first time step
+ *
+ *  While the input parsed so far is in time order, a timestamp is complete once a later one has been parsed.
+ *  Once it is not, any time step may still receive SDBEs, so none is complete before the load ends.
+ *  Must be called with the mutex held
+ *
+ *  @param latestTime Latest timestamp in microseconds among the SDBEs
+ *  @param time       Timestamp in microseconds, or negative for the first time step
+ *  @return           true if every SDBE at the time step is among the SDBEs
+ *
+ */
+bool BookLoader::coversTimeStep(std::int64_t latestTime, std::int64_t time) const
+{
+    if (!inTimeOrder)
+    {
+        return false;
+    }
+    if (time < 0)
+    {
+        return earliestTime >= 0 && latestTime > earliestTime;
+    }
+    return latestTime > time;
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+#include "StocksDataBook.h"
+#include "VersionedBook.h"
+#include "CSVFileReader.h"
+#include "LoadReport.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/** Establish whether a dataset is loaded before the Advisor Bot starts or while it runs */
+enum class BookLoadMode
+{
+    foreground,
+    background
+};
+
+/** Establish the stages of a background load */
+enum class BookLoadState
+{
+    loading,
+    complete,
+    failed
+};
+
+/** Structure is used to report the progress of a background load */
+struct BookLoadProgress
+{
+    BookLoadState state = BookLoadState::loading;
+
+    // Input bytes parsed out of the total size of the files
+    std::size_t bytesParsed = 0;
+    std::size_t totalBytes = 0;
+
+    // SDBEs parsed, and how many of them have been published in a version of the book
+    std::size_t rowsParsed = 0;
+    std::size_t rowsPublished = 0;
+
+    // Latest timestamp parsed in microseconds, or -1 before the first SDBE
+    std::int64_t latestTime = -1;
+
+    // Seconds since the load started, up to its end once it has ended
+    double elapsedSeconds = 0;
+};
+
+class BookLoader
+{
+public:
+    /** Start loading files on a background thread, publishing the SDBEs as versions of a book */
+    BookLoader(std::vector<std::string> filenames, VersionedBook& _versionedBook, const CSVReadOptions& options = CSVReadOptions{});
+
+    /** Stop loading at the next chunk and wait for the background thread */
+    ~BookLoader();
+
+    BookLoader(const BookLoader&) = delete;
+    BookLoader& operator=(const BookLoader&) = delete;
+
+    /** Return true if every SDBE at a timestamp has been published, a negative time standing for the first time step */
+    bool isTimeStepReady(std::int64_t time) const;
+
+    /** Block until every SDBE at a timestamp has been published, a negative time standing for the first time step */
+    void waitForTimeStep(std::int64_t time);
+
+    /** Block until loading has ended and its last version has been published */
+    void waitForCompletion();
+
+    /** Return the progress of the load */
+    BookLoadProgress getProgress() const;
+
+    /** Return the names of the files being loaded */
+    const std::vector<std::string>& getFilenames() const;
+
+private:
+    /** Parse the files, publishing SDBEs as they become available */
+    void loadLoop(CSVReadOptions options);
+
+    /** Publish the latest version extended with the SDBEs parsed since, along with the report once the load is complete */
+    void publishPendingEntries(const LoadReport* fileLoadReport);
+
+    /** Return true if every SDBE at a timestamp has been published, with the mutex held */
+    bool isTimeStepReadyLocked(std::int64_t time) const;
+
+    /** Return true if SDBEs up to a timestamp cover its time step, a negative time standing for the first time step */
+    bool coversTimeStep(std::int64_t latestTime, std::int64_t time) const;
+
+    std::vector<std::string> filenames;
+
+    // Book the loaded SDBEs are published into
+    VersionedBook& versionedBook;
+
+    // A single CSV file is published chunk by chunk; several files and archives once merged
+    bool progressive;
+
+    mutable std::mutex mutex;
+    std::condition_variable progressChanged;
+
+    // Parsed SDBEs not yet published, only touched by the loader thread
+    std::vector<StocksDataBookEntry> pendingEntries;
+
+    BookLoadProgress progress;
+    std::int64_t earliestTime = -1;
+    std::int64_t publishedLatestTime = -1;
+
+    // True while every SDBE parsed so far is in time order, which lets time steps be used before the load ends
+    bool inTimeOrder = true;
+
+    // Earliest time step a command is waiting for, published without waiting for the book to double
+    bool timeStepRequested = false;
+    std::int64_t requestedTime = -1;
+    std::chrono::steady_clock::time_point startTime;
+
+    std::atomic<bool> cancelled{ false };
+    std::thread loaderThread;
+};
@@ -0,0 +1,301 @@
+#include "BookSorter.h"
+#include "ParallelFor.h"
+#include <algorithm>
+#include <chrono>
+#include <queue>
+#include <string>
+#include <unordered_map>
+
+/** Compare sort keys by timestamp, product, type and finally position
+ *
+ *  @param other Key to be compared against
+ *  @return      true if this key orders first
+ *
+ */
+bool BookSorter::SortKey::operator<(const SortKey& other) const
+{
+    if (timestamp != other.timestamp)
+    {
+        return timestamp < other.timestamp;
+    }
+    if (productRank != other.productRank)
+    {
+        return productRank < other.productRank;
+    }
+    if (typeRank != other.typeRank)
+    {
+        return typeRank < other.typeRank;
+    }
+    return position < other.position;
+}
+
+/** Put SDBEs into (timestamp, product, type) order, asks before bids, unless they already are
+ *
+ *  Sorted input is detected with a single pass and left untouched. Otherwise sorted runs are counted while
+ *  building integer sort keys. Inputs made of a few sorted runs, such as
+ *  concatenated feeds, are merged pairwise; anything else is sorted in parallel chunks that are then merged.
+ *  Equal keys keep their input order, and the strategy, run count and time taken are recorded in the load report
+ *
+ *  @param entries    Collection of SDBE entries, reordered in place
+ *  @param loadReport Receives the sortedness of the input and the cost of sorting it
+ *
+ */
+void BookSorter::sortEntries(std::vector<StocksDataBookEntry>& entries, LoadReport& loadReport)
+{
+    auto startTime = std::chrono::steady_clock::now();
+
+    // Sorted input, the common case, is recognized without building any keys
+    std::vector<SortKey> keys;
+    std::size_t runs = isSorted(entries, 0) ? std::min<std::size_t>(1, entries.size()) : buildSortKeys(entries, keys);
+    loadReport.sortedRuns = runs;
+
+    if (runs <= 1)
+    {
+        loadReport.sortStrategy = "none";
+    }
+    else
+    {
+        std::vector<std::size_t> runStarts;
+        if (runs <= maxMergedRuns)
+        {
+            // Merge the runs already present in the input
+            loadReport.sortStrategy = "merge";
+            runStarts.push_back(0);
+            for (std::size_t i = 1; i < keys.size(); ++i)
+            {
+                if (keys[i] < keys[i - 1])
+                {
+                    runStarts.push_back(i);
+                }
+            }
+        }
+        else
+        {
+            // Sort one chunk per thread, turning the input into as many runs as there are threads
+            loadReport.sortStrategy = "sort";
+            std::size_t chunks = ParallelFor::getThreadCount();
+            for (std::size_t chunk = 0; chunk < chunks; ++chunk)
+            {
+                runStarts.push_back(keys.size() * chunk / chunks);
+            }
+            ParallelFor::run(chunks, [&](std::size_t chunk)
+            {
+                std::size_t end = chunk + 1 < chunks ? runStarts[chunk + 1] : keys.size();
+                std::sort(keys.begin() + runStarts[chunk], keys.begin() + end);
+            });
+        }
+        mergeRuns(keys, runStarts);
+
+        // Move the SDBEs into key order
+        std::vector<StocksDataBookEntry> sortedEntries;
+        sortedEntries.reserve(entries.size());
+        for (const SortKey& key : keys)
+        {
+            sortedEntries.push_back(std::move(entries[key.position]));
+        }
+        entries.swap(sortedEntries);
+    }
+
+    loadReport.phaseTimes.sortSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    loadReport.phaseTimes.totalSeconds += loadReport.phaseTimes.sortSeconds;
+}
+
+/** Merge collections that are each in (timestamp, product, type) order into one collection in that order
+ *
+ *  A k-way merge keeps the next SDBE of every collection in a heap, so each SDBE costs O(log k) compares.
+ *  SDBEs with equal keys are taken from the collections in order, and are moved rather than copied
+ *
+ *  @param sources Sorted collections of SDBE entries, left empty afterwards
+ *  @return        single sorted collection
+ *
+ */
+std::vector<StocksDataBookEntry> BookSorter::mergeSortedSources(std::vector<std::vector<StocksDataBookEntry>>& sources)
+{
+    std::size_t totalEntries = 0;
+    for (const std::vector<StocksDataBookEntry>& source : sources)
+    {
+        totalEntries += source.size();
+    }
+
+    // Next unmerged position within each collection
+    std::vector<std::size_t> positions(sources.size(), 0);
+
+    // Order the collections by their next SDBE, the smallest on top
+    auto comesLater = [&](std::size_t a, std::size_t b)
+    {
+        const StocksDataBookEntry& entryA = sources[a][positions[a]];
+        const StocksDataBookEntry& entryB = sources[b][positions[b]];
+        if (entryA.timestamp != entryB.timestamp)
+        {
+            return entryA.timestamp > entryB.timestamp;
+        }
+        int productOrder = entryA.product.compare(entryB.product);
+        if (productOrder != 0)
+        {
+            return productOrder > 0;
+        }
+        unsigned rankA = getTypeRank(entryA.SDBEtype);
+        unsigned rankB = getTypeRank(entryB.SDBEtype);
+        return rankA != rankB ? rankA > rankB : a > b;
+    };
+    std::priority_queue<std::size_t, std::vector<std::size_t>, decltype(comesLater)> heap{ comesLater };
+    for (std::size_t i = 0; i < sources.size(); ++i)
+    {
+        if (!sources[i].empty())
+        {
+            heap.push(i);
+        }
+    }
+
+    std::vector<StocksDataBookEntry> merged;
+    merged.reserve(totalEntries);
+    while (!heap.empty())
+    {
+        std::size_t i = heap.top();
+        heap.pop();
+        merged.push_back(std::move(sources[i][positions[i]]));
+        if (++positions[i] < sources[i].size())
+        {
+            heap.push(i);
+        }
+    }
+
+    for (std::vector<StocksDataBookEntry>& source : sources)
+    {
+        source.clear();
+    }
+    return merged;
+}
+
+/** Return true if the SDBEs from a position onwards continue the (timestamp, product, type) order
+ *
+ *  @param entries    Collection of SDBE entries
+ *  @param firstEntry Position of the first SDBE to be checked against its predecessor
+ *  @return           true if no SDBE from the position onwards orders before its predecessor
+ *
+ */
+bool BookSorter::isSorted(const std::vector<StocksDataBookEntry>& entries, std::size_t firstEntry)
+{
+    for (std::size_t i = std::max<std::size_t>(1, firstEntry); i < entries.size(); ++i)
+    {
+        const StocksDataBookEntry& previous = entries[i - 1];
+        const StocksDataBookEntry& entry = entries[i];
+        if (entry.timestamp != previous.timestamp)
+        {
+            if (entry.timestamp < previous.timestamp)
+            {
+                return false;
+            }
+            continue;
+        }
+        int productOrder = entry.product.compare(previous.product);
+        if (productOrder < 0 || (productOrder == 0 && getTypeRank(entry.SDBEtype) < getTypeRank(previous.SDBEtype)))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/** Return the rank of an SDBE type within a time step and product: asks, then bids, then unknown
+ *
+ *  @param type SDBE type - ask/bid/unknown
+ *  @return     rank of the type
+ *
+ */
+unsigned BookSorter::getTypeRank(StocksDataBookType type)
+{
+    switch (type)
+    {
+    case StocksDataBookType::ask:
+        return 0;
+    case StocksDataBookType::bid:
+        return 1;
+    default:
+        return 2;
+    }
+}
+
+/** Build the sort key of every SDBE, returning the number of sorted runs
+ *
+ *  Products are ranked in lexicographic order so that keys compare as integers
+ *
+ *  @param entries Collection of SDBE entries
+ *  @param keys    Receives one key per SDBE, in input order
+ *  @return        number of maximal sorted runs, 1 for sorted input and 0 for empty input
+ *
+ */
+std::size_t BookSorter::buildSortKeys(const std::vector<StocksDataBookEntry>& entries, std::vector<SortKey>& keys)
+{
+    // Rank the distinct products
+    std::unordered_map<std::string, std::uint32_t> productRanks;
+    for (const StocksDataBookEntry& entry : entries)
+    {
+        productRanks.emplace(entry.product, 0);
+    }
+    std::vector<const std::string*> products;
+    for (const auto& productRank : productRanks)
+    {
+        products.push_back(&productRank.first);
+    }
+    std::sort(products.begin(), products.end(), [](const std::string* a, const std::string* b) { return *a < *b; });
+    for (std::size_t i = 0; i < products.size(); ++i)
+    {
+        productRanks[*products[i]] = static_cast<std::uint32_t>(i);
+    }
+
+    keys.clear();
+    keys.reserve(entries.size());
+    std::size_t runs = entries.empty() ? 0 : 1;
+
+    // Products commonly repeat across consecutive SDBEs, so avoid rehashing the same name
+    const std::string* previousProduct = nullptr;
+    std::uint32_t productRank = 0;
+    for (std::size_t i = 0; i < entries.size(); ++i)
+    {
+        const StocksDataBookEntry& entry = entries[i];
+        if (previousProduct == nullptr || *previousProduct != entry.product)
+        {
+            productRank = productRanks[entry.product];
+            previousProduct = &entry.product;
+        }
+        keys.push_back(SortKey{ entry.timestamp, productRank, getTypeRank(entry.SDBEtype), static_cast<std::uint32_t>(i) });
+
+        if (i > 0 && keys[i] < keys[i - 1])
+        {
+            ++runs;
+        }
+    }
+    return runs;
+}
+
+/** Merge adjacent sorted runs pairwise, in parallel, until a single run remains
+ *
+ *  @param keys      Keys made of sorted runs, sorted in place
+ *  @param runStarts Position of the first key of each run, in increasing order starting at 0
+ *
+ */
+void BookSorter::mergeRuns(std::vector<SortKey>& keys, std::vector<std::size_t> runStarts)
+{
+    std::vector<SortKey> mergedKeys(keys.size());
+    while (runStarts.size() > 1)
+    {
+        // Each round merges runs 2i and 2i+1, carrying an odd run over unchanged
+        std::size_t pairs = (runStarts.size() + 1) / 2;
+        ParallelFor::run(pairs, [&](std::size_t pair)
+        {
+            std::size_t begin = runStarts[2 * pair];
+            std::size_t middle = 2 * pair + 1 < runStarts.size() ? runStarts[2 * pair + 1] : keys.size();
+            std::size_t end = 2 * pair + 2 < runStarts.size() ? runStarts[2 * pair + 2] : keys.size();
+            std::merge(keys.begin() + begin, keys.begin() + middle, keys.begin() + middle, keys.begin() + end, mergedKeys.begin() + begin);
+        });
+        keys.swap(mergedKeys);
+
+        std::vector<std::size_t> mergedRunStarts;
+        for (std::size_t pair = 0; pair < pairs; ++pair)
+        {
+            mergedRunStarts.push_back(runStarts[2 * pair]);
+        }
+        runStarts.swap(mergedRunStarts);
+    }
+}
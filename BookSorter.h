@@ -0,0 +1,43 @@
+#pragma once
+
+#include "StocksDataBookEntry.h"
+#include "LoadReport.h"
+#include <cstdint>
+#include <vector>
+
+class BookSorter
+{
+public:
+    /** Put SDBEs into (timestamp, product, type) order, asks before bids, unless they already are */
+    static void sortEntries(std::vector<StocksDataBookEntry>& entries, LoadReport& loadReport);
+
+    /** Merge collections that are each in (timestamp, product, type) order into one collection in that order */
+    static std::vector<StocksDataBookEntry> mergeSortedSources(std::vector<std::vector<StocksDataBookEntry>>& sources);
+
+    /** Return true if the SDBEs from a position onwards continue the (timestamp, product, type) order */
+    static bool isSorted(const std::vector<StocksDataBookEntry>& entries, std::size_t firstEntry);
+
+    /** Return the rank of an SDBE type within a time step and product: asks, then bids, then unknown */
+    static unsigned getTypeRank(StocksDataBookType type);
+
+    /** Inputs with at most this many sorted runs are merged rather than sorted */
+    static constexpr std::size_t maxMergedRuns = 64;
+
+private:
+    /** Structure is used to sort SDBEs by integer compares, with the position as the final key for stability */
+    struct SortKey
+    {
+        std::int64_t timestamp;
+        std::uint32_t productRank;
+        std::uint32_t typeRank;
+        std::uint32_t position;
+
+        bool operator<(const SortKey& other) const;
+    };
+
+    /** Build the sort key of every SDBE, returning the number of sorted runs */
+    static std::size_t buildSortKeys(const std::vector<StocksDataBookEntry>& entries, std::vector<SortKey>& keys);
+
+    /** Merge adjacent sorted runs pairwise, in parallel, until a single run remains */
+    static void mergeRuns(std::vector<SortKey>& keys, std::vector<std::size_t> runStarts);
+};
@@ -1,7 +1,17 @@
 #include "CSVFileReader.h"
+#include "AllocationCounter.h"
+#include "CSVScanner.h"
+#include "FixedPoint.h"
+#include "PipelinedFileReader.h"
+#include "TimeStamp.h"
 #include <iostream>
 #include <fstream>
 #include <algorithm>
+#include <chrono>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
 
 /** Initialize an instance of the CSV File Reader class */
 CSVFileReader::CSVFileReader() = default;
@@ -14,52 +24,405 @@ CSVFileReader::CSVFileReader() = default;
  */
 std::vector<StocksDataBookEntry> CSVFileReader::readCSVfile(std::string csvFilename)
 {
-    // Storage for valid SDBE entries 
+    // Discard the load report for callers that do not request it
+    LoadReport loadReport;
+    return readCSVfile(csvFilename, loadReport);
+}
+
+/** Parse the CSV file and record bytes, rows, rejects, phase times and memory usage in the load report
+ *
+ *  @param csvFilename The name of the CSV file to be parsed
+ *  @param loadReport  Report to be populated with statistics about the load
+ *  @return            container of SDBE objects constructed from each valid line of the CSV file
+ *
+ */
+std::vector<StocksDataBookEntry> CSVFileReader::readCSVfile(std::string csvFilename, LoadReport& loadReport)
+{
+    return readCSVfile(csvFilename, loadReport, CSVReadOptions{});
+}
+
+/** Parse the CSV file, validating every line without exceptions and treating malformed lines as the options request
+ *
+ *  Malformed lines are counted against their reason and, if a quarantine stream is provided, written to it
+ *  along with their line number. In lenient mode they are skipped; in strict mode the load stops at the
+ *  first one and fails once the report is complete. The file is parsed a chunk at a time, either read in turn
+ *  through a file stream or read ahead on a background thread so that disk and CPU are busy at the same time
+ *
+ *  @param csvFilename The name of the CSV file to be parsed
+ *  @param loadReport  Report to be populated with statistics about the load
+ *  @param options     Validation mode, quarantine stream and read method
+ *  @return            container of SDBE objects constructed from each valid line of the CSV file
+ *
+ */
+std::vector<StocksDataBookEntry> CSVFileReader::readCSVfile(std::string csvFilename, LoadReport& loadReport, const CSVReadOptions& options)
+{
+    using Clock = std::chrono::steady_clock;
+
+    // Sample heap activity so that only the allocations made by this load are reported
+    std::size_t allocationsAtStart = AllocationCounter::getAllocationCount();
+    std::size_t allocatedBytesAtStart = AllocationCounter::getAllocatedBytes();
+
+    // Start of the load, and the timestamp at which the current phase began
+    Clock::time_point loadStart = Clock::now();
+    Clock::time_point phaseStart = loadStart;
+
+    // Accumulate the elapsed time since the start of the phase and begin the next phase
+    auto endPhase = [&phaseStart](double& phaseSeconds)
+    {
+        Clock::time_point phaseEnd = Clock::now();
+        phaseSeconds += std::chrono::duration<double>(phaseEnd - phaseStart).count();
+        phaseStart = phaseEnd;
+    };
+
+    loadReport = LoadReport{};
+    loadReport.filename = csvFilename;
+
+    // Storage for valid SDBE entries
     std::vector<StocksDataBookEntry> entries;
 
-    // Request the vector capacity in advanced to prevent excessive memory allocations
-    entries.reserve(1022000);
+    // Request the vector capacity in advance from the file size, so that several files loaded together do not each
+    // reserve room for a full day, assuming lines of at least 50 bytes as in the exchange dumps
+    std::error_code sizeError;
+    std::uintmax_t fileBytes = std::filesystem::file_size(csvFilename, sizeError);
+    // A chunk consumer takes the SDBEs of every chunk, so only one chunk's worth is needed then
+    std::size_t expectedBytes = options.chunkConsumer ? readChunkBytes : static_cast<std::size_t>(fileBytes);
+    entries.reserve(!sizeError ? std::min(expectedBytes, static_cast<std::size_t>(fileBytes)) / 50 + 1 : 0);
+    loadReport.reservedCapacity = entries.capacity();
+
+    // Blank lines are counted as read, so that line numbers match the file, but are neither parsed nor rejected
+    std::size_t blankLines = 0;
+
+    // Line number and reason of the line that stopped a strict load, if any
+    std::size_t failedLineNumber = 0;
+    CSVRejectReason failedReason = CSVRejectReason::count;
 
-    // Create object associated with the CSV file to perform input/output operations on
-    std::ifstream csvFile{ csvFilename };
+    // Offsets of every comma and newline within the chunk being parsed
+    std::vector<std::uint32_t> delimiters;
 
-    // Ensure CSV file is open, and associated with the stream object
-    std::string line;
+    // Fields of the current line; a sixth field only signals that the line has too many
+    std::string_view fields[6];
+    CSVRow row;
 
-    if (csvFile.is_open())
+    // Parse the complete lines of a chunk of the file, returning the number of bytes of the unfinished line ending it
+    auto parseChunk = [&](const char* chunk, std::size_t chunkBytes, bool lastChunk) -> std::size_t
     {
-        // Continue processing line by line as end of file has not been reached 
-        while (std::getline(csvFile, line))
+        // Find the delimiters of the whole chunk in one vectorized pass, rather than searching field by field
+        delimiters.clear();
+        CSVScanner::findDelimiters(chunk, chunkBytes, ',', '\n', delimiters);
+
+        // The last line of the file need not end in a newline
+        if (lastChunk && chunkBytes > 0 && chunk[chunkBytes - 1] != '\n')
         {
-            // Attempt to process the CSV line 
-            try
+            delimiters.push_back(static_cast<std::uint32_t>(chunkBytes));
+        }
+        endPhase(loadReport.phaseTimes.tokenizeSeconds);
+
+        std::size_t lineStart = 0;
+        std::size_t fieldStart = 0;
+        std::size_t numFields = 0;
+        for (std::uint32_t delimiter : delimiters)
+        {
+            if (delimiter < chunkBytes && chunk[delimiter] == ',')
+            {
+                if (numFields < 6)
+                {
+                    fields[numFields++] = std::string_view{ chunk + fieldStart, delimiter - fieldStart };
+                }
+                fieldStart = delimiter + 1;
+                continue;
+            }
+
+            // The delimiter ends a line, which with its last field ends before any Windows carriage return
+            std::size_t lineEnd = delimiter;
+            if (lineEnd > fieldStart && chunk[lineEnd - 1] == '\r')
+            {
+                --lineEnd;
+            }
+            std::string_view line{ chunk + lineStart, lineEnd - lineStart };
+            if (numFields < 6)
+            {
+                fields[numFields++] = std::string_view{ chunk + fieldStart, lineEnd - fieldStart };
+            }
+            std::size_t lineFields = numFields;
+            lineStart = fieldStart = delimiter + 1;
+            numFields = 0;
+            ++loadReport.linesRead;
+
+            // Skip blank lines silently, wherever they appear
+            if (line.empty())
             {
-                // Split line into tokens based on comma delimiter 
-                std::vector<std::string> tokenizedCSVLine = tokenize(line, ',');
+                ++blankLines;
+                continue;
+            }
+
+            // Validate and convert the line, which only refers to the characters of the chunk
+            CSVRejectReason reason = parseCSVfields(fields, lineFields, row, options.fixedPoint);
+            endPhase(loadReport.phaseTimes.convertSeconds);
+
+            if (reason != CSVRejectReason::count)
+            {
+                loadReport.recordRejectedRow(reason);
+                if (options.quarantineStream != nullptr)
+                {
+                    *options.quarantineStream << csvFilename << ',' << loadReport.linesRead << ','
+                                              << LoadReport::rejectReasonToString(reason) << ',' << line << '\n';
+                }
+                endPhase(loadReport.phaseTimes.rejectSeconds);
 
-                // Insert the SDBE into the storage collection
-                if (tokenizedCSVLine.size() == 5)
+                if (options.mode == CSVValidationMode::strict)
                 {
-                    // Implicitly call the StocksDataBookEntry's parameterized constructor
-                    entries.emplace_back(std::stod(tokenizedCSVLine[3]), 
-                                         std::stod(tokenizedCSVLine[4]), 
-                                         tokenizedCSVLine[0], 
-                                         tokenizedCSVLine[1], 
-                                         StocksDataBookEntry::stringToStocksDataBookType(tokenizedCSVLine[2]));
+                    failedLineNumber = loadReport.linesRead;
+                    failedReason = reason;
+                    return std::size_t{ 0 };
                 }
+                continue;
             }
-            // Unsuccessful string to SDBE conversion 
-            catch (const std::exception& e)
+
+            // Record any growth of the storage beyond its reserved capacity
+            std::size_t capacityBefore = entries.capacity();
+
+            // Implicitly call the StocksDataBookEntry's parameterized constructor
+            entries.emplace_back(row.price,
+                                 row.amount,
+                                 row.timestamp,
+                                 std::string{ row.product },
+                                 row.SDBEtype);
+            StocksDataBookEntry& entry = entries.back();
+            entry.priceDecimals = row.priceDecimals;
+            entry.amountDecimals = row.amountDecimals;
+
+            if (entries.capacity() != capacityBefore)
             {
-                std::cout << "CSV File Reader parsed an invalid CSV line.\n";
+                ++loadReport.storageReallocations;
             }
+            endPhase(loadReport.phaseTimes.storeSeconds);
+        }
+
+        // Hand the SDBEs of the chunk over as soon as they are available
+        if (options.chunkConsumer)
+        {
+            options.chunkConsumer(entries, loadReport.bytesRead);
+            endPhase(loadReport.phaseTimes.storeSeconds);
+        }
+        return lineStart < chunkBytes ? chunkBytes - lineStart : 0;
+    };
+
+    if (options.readMethod == CSVReadMethod::pipelined)
+    {
+        // A background thread reads ahead into aligned buffers; the read phase only counts time spent waiting for it
+        PipelinedFileReader fileReader{ csvFilename };
+        if (fileReader.isOpen())
+        {
+            std::size_t carriedBytes = 0;
+            FileChunk chunk;
+            do
+            {
+                chunk = fileReader.nextChunk(carriedBytes);
+                loadReport.bytesRead += chunk.fileBytes;
+                endPhase(loadReport.phaseTimes.readSeconds);
+                carriedBytes = parseChunk(chunk.data, chunk.bytes, chunk.last);
+            } while (!chunk.last && failedReason == CSVRejectReason::count);
         }
     }
-    // Indicate the number of valid string to SDBE conversions across the entire file 
-    std::cout << "CSV File Reader has successfully processed " << entries.size() << " entries\n";
+    else
+    {
+        // Create object associated with the CSV file to perform input/output operations on
+        std::ifstream csvFile{ csvFilename, std::ios::binary };
+
+        // Raw bytes read from the file, the unfinished line carried over from the previous read at its start
+        std::vector<char> buffer;
+        std::size_t carriedBytes = 0;
+
+        // Ensure CSV file is open, and associated with the stream object
+        if (csvFile.is_open())
+        {
+            bool lastChunk = false;
+            while (!lastChunk && failedReason == CSVRejectReason::count)
+            {
+                // Read the next chunk behind the carried bytes, growing the buffer if a single line filled it
+                buffer.resize(std::max(buffer.size(), carriedBytes + readChunkBytes));
+                csvFile.read(buffer.data() + carriedBytes, static_cast<std::streamsize>(readChunkBytes));
+                std::size_t chunkBytes = static_cast<std::size_t>(csvFile.gcount());
+                lastChunk = chunkBytes < readChunkBytes;
+                loadReport.bytesRead += chunkBytes;
+                endPhase(loadReport.phaseTimes.readSeconds);
+
+                // Carry the unfinished line over to the start of the buffer
+                std::size_t bufferBytes = carriedBytes + chunkBytes;
+                carriedBytes = parseChunk(buffer.data(), bufferBytes, lastChunk);
+                std::memmove(buffer.data(), buffer.data() + bufferBytes - carriedBytes, carriedBytes);
+            }
+        }
+    }
+    endPhase(loadReport.phaseTimes.readSeconds);
+
+    // Complete the report
+    loadReport.rowsParsed = loadReport.linesRead - blankLines - loadReport.getRowsRejected();
+    loadReport.finalCapacity = entries.capacity();
+    loadReport.phaseTimes.totalSeconds = std::chrono::duration<double>(Clock::now() - loadStart).count();
+    loadReport.captureMemoryStatistics(allocationsAtStart, allocatedBytesAtStart);
+
+    // The application runs until interrupted, so the rejected lines are written out as soon as the file is done
+    if (options.quarantineStream != nullptr)
+    {
+        options.quarantineStream->flush();
+    }
+
+    // A strict load fails as a whole, once, rather than per line
+    if (failedReason != CSVRejectReason::count)
+    {
+        std::cout << "CSV File Reader stopped at line " << failedLineNumber << " of " << csvFilename << ": "
+                  << LoadReport::rejectReasonToString(failedReason) << "\n";
+        throw std::exception{};
+    }
+
+    // Indicate the number of valid string to SDBE conversions across the entire file
+    std::cout << "CSV File Reader has successfully processed " << loadReport.rowsParsed << " entries and rejected "
+              << loadReport.getRowsRejected() << " line(s). Type \"report\" for the full load report.\n";
     return entries;
 }
 
+/** Validate a CSV line and convert its fields, without allocating or throwing
+ *
+ *  @param csvLine    The CSV line to be validated, optionally ending in a carriage return
+ *  @param row        Receives the converted fields; its product refers to the characters of the line
+ *  @param fixedPoint Whether to parse the price and amount into units as well
+ *  @return           the reason the line is rejected, or CSVRejectReason::count if it is valid
+ *
+ */
+CSVRejectReason CSVFileReader::parseCSVline(std::string_view csvLine, CSVRow& row, bool fixedPoint)
+{
+    // Tolerate Windows line endings
+    if (!csvLine.empty() && csvLine.back() == '\r')
+    {
+        csvLine.remove_suffix(1);
+    }
+
+    // Split into at most six fields, any more than five being rejected anyway
+    std::string_view fields[6];
+    std::size_t numFields = 0;
+    std::size_t start = 0;
+    while (numFields < 6)
+    {
+        std::size_t end = csvLine.find(',', start);
+        fields[numFields++] = csvLine.substr(start, end == std::string_view::npos ? std::string_view::npos : end - start);
+        if (end == std::string_view::npos)
+        {
+            break;
+        }
+        start = end + 1;
+    }
+    return parseCSVfields(fields, numFields, row, fixedPoint);
+}
+
+/** Validate the fields of a CSV line and convert them, without allocating or throwing
+ *
+ *  @param fields     Fields of the line, without separators or line terminator
+ *  @param numFields  Number of fields in the line
+ *  @param row        Receives the converted fields; its product refers to the characters of the line
+ *  @param fixedPoint Whether to parse the price and amount into units as well
+ *  @return           the reason the line is rejected, or CSVRejectReason::count if it is valid
+ *
+ */
+CSVRejectReason CSVFileReader::parseCSVfields(const std::string_view* fields, std::size_t numFields, CSVRow& row, bool fixedPoint)
+{
+    if (numFields != 5)
+    {
+        return CSVRejectReason::wrongFieldCount;
+    }
+
+    row.timestamp = TimeStamp::parse(fields[0].data(), fields[0].size());
+    if (row.timestamp < 0)
+    {
+        return CSVRejectReason::invalidTimestamp;
+    }
+
+    row.product = fields[1];
+    if (row.product.empty())
+    {
+        return CSVRejectReason::emptyProduct;
+    }
+
+    if (fields[2] == "bid")
+    {
+        row.SDBEtype = StocksDataBookType::bid;
+    }
+    else if (fields[2] == "ask")
+    {
+        row.SDBEtype = StocksDataBookType::ask;
+    }
+    else
+    {
+        return CSVRejectReason::unknownType;
+    }
+
+    if (fixedPoint)
+    {
+        if (!parseNumber(fields[3], row.price, row.priceUnits, row.priceDecimals)
+            || !parseNumber(fields[4], row.amount, row.amountUnits, row.amountDecimals))
+        {
+            return CSVRejectReason::invalidNumber;
+        }
+        return CSVRejectReason::count;
+    }
+
+    row.priceUnits = row.amountUnits = 0;
+    row.priceDecimals = row.amountDecimals = FixedPoint::noDecimals;
+    if (!parseNumber(fields[3], row.price) || !parseNumber(fields[4], row.amount))
+    {
+        return CSVRejectReason::invalidNumber;
+    }
+    return CSVRejectReason::count;
+}
+
+/** Convert a field into a finite, non-negative number, ignoring surrounding spaces
+ *
+ *  @param field  Characters of the field
+ *  @param number Receives the number
+ *  @return       true if the whole field is a valid number, false otherwise
+ *
+ */
+bool CSVFileReader::parseNumber(std::string_view field, double& number)
+{
+    while (!field.empty() && (field.front() == ' ' || field.front() == '\t'))
+    {
+        field.remove_prefix(1);
+    }
+    while (!field.empty() && (field.back() == ' ' || field.back() == '\t'))
+    {
+        field.remove_suffix(1);
+    }
+
+    const char* end = field.data() + field.size();
+    std::from_chars_result result = std::from_chars(field.data(), end, number);
+    return result.ec == std::errc{} && result.ptr == end && std::isfinite(number) && number >= 0;
+}
+
+/** Convert a field into a finite, non-negative number, straight from the text into units where it is a plain decimal
+ *
+ *  Numbers written otherwise, such as with an exponent or too many digits, are still accepted as doubles but
+ *  carry no units
+ *
+ *  @param field    Characters of the field
+ *  @param number   Receives the number
+ *  @param units    Receives the number as a count of units of 10^-decimals
+ *  @param decimals Receives the number of decimals, or FixedPoint::noDecimals if the field is not a plain decimal
+ *  @return         true if the whole field is a valid number, false otherwise
+ *
+ */
+bool CSVFileReader::parseNumber(std::string_view field, double& number, std::int64_t& units, std::uint8_t& decimals)
+{
+    if (FixedPoint::parse(field, units, decimals))
+    {
+        number = FixedPoint::toDouble(units, decimals);
+        return true;
+    }
+
+    units = 0;
+    decimals = FixedPoint::noDecimals;
+    return parseNumber(field, number);
+}
+
 /** Split a CSV line into tokens based on a delimiter
  *
  *  @param csvLine    The CSV line to be parsed
@@ -69,31 +432,22 @@ std::vector<StocksDataBookEntry> CSVFileReader::readCSVfile(std::string csvFilen
  */
 std::vector<std::string> CSVFileReader::tokenize(std::string csvLine, char separator)
 {
-    // Storage for parsed tokens
-    std::vector<std::string> tokens;
-
-    // Index of start of string
-    signed int start = 0;
+    // Find every delimiter occurrence in one vectorized pass; the separator doubles as the line terminator
+    std::vector<std::uint32_t> delimiters;
+    CSVScanner::findDelimiters(csvLine.data(), csvLine.size(), separator, separator, delimiters);
 
-    // Index of first occurrence of delimiter
-    signed int end = csvLine.find_first_of(separator);
+    // Storage for parsed tokens, one more than there are delimiters
+    std::vector<std::string> tokens;
+    tokens.reserve(delimiters.size() + 1);
 
-    while (end <= std::string::npos)
+    // Insert substring between delimiter occurrences, and finally the remainder of the string
+    std::size_t start = 0;
+    for (std::uint32_t end : delimiters)
     {
-        // Insert substring between delimiter occurrences
-        tokens.emplace_back(csvLine.substr(start, end - start));
-
-        // End of string reached
-        if (end == std::string::npos)
-        {
-            break;
-        }
-        // Adjust start of next substring to be just beyond last delimiter occurrence
+        tokens.emplace_back(csvLine, start, end - start);
         start = end + 1;
-
-        // Find next occurrence of delimiter
-        end = csvLine.find_first_of(separator, start);
     }
+    tokens.emplace_back(csvLine, start);
     return tokens;
 }
 
@@ -128,10 +482,18 @@ StocksDataBookEntry CSVFileReader::stringsToSDBE(std::vector<std::string> tokens
         throw;
     }
 
+    // Convert the timestamp into microseconds
+    std::int64_t timestamp = TimeStamp::parse(tokens[0]);
+    if (timestamp < 0)
+    {
+        std::cout << "Unsuccessful conversion of timestamp for CSV line - " << tokens[0] << "\n";
+        throw std::exception{};
+    }
+
     // Instantiate SDBE with input parameters
     StocksDataBookEntry obe{price,
                             amount,
-                            tokens[0],
+                            timestamp,
                             tokens[1],
                             StocksDataBookEntry::stringToStocksDataBookType(tokens[2])};
 
@@ -171,10 +533,18 @@ StocksDataBookEntry CSVFileReader::stringsToSDBE(std::string priceString,
         throw;
     }
 
+    // Convert the timestamp into microseconds
+    std::int64_t timestampMicroseconds = TimeStamp::parse(timestamp);
+    if (timestampMicroseconds < 0)
+    {
+        std::cout << "CSVFileReader::stringsToSDBE Bad timestamp! " << timestamp << "\n";
+        throw std::exception{};
+    }
+
     // Instantiate SDBE with input parameters
     StocksDataBookEntry obe{ price,
                        amount,
-                       timestamp,
+                       timestampMicroseconds,
                        product,
                        SDBEtype };
 
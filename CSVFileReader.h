@@ -1,9 +1,66 @@
 #pragma once
 
 #include "StocksDataBookEntry.h"
+#include "LoadReport.h"
 #include <vector>
 #include <unordered_map>
 #include <string>
+#include <string_view>
+#include <ostream>
+#include <functional>
+
+/** Establish how malformed CSV lines are treated */
+enum class CSVValidationMode
+{
+    // Skip malformed lines and carry on
+    lenient,
+    // Stop at the first malformed line and fail the load
+    strict
+};
+
+/** Establish how the CSV file is read from disk */
+enum class CSVReadMethod
+{
+    // Read and parse in turn through an input file stream
+    stream,
+    // Read ahead on a background thread while the previous buffer is parsed
+    pipelined
+};
+
+/** Structure is used to pass validation and reading options to the CSV File Reader */
+struct CSVReadOptions
+{
+    CSVValidationMode mode = CSVValidationMode::lenient;
+
+    CSVReadMethod readMethod = CSVReadMethod::pipelined;
+
+    // Receives every rejected line as "file,line number,reason,line" if not null
+    std::ostream* quarantineStream = nullptr;
+
+    // Receives the SDBEs parsed so far after each chunk, along with the bytes read, if set; SDBEs it moves out of
+    // the vector are not returned by the reader
+    std::function<void(std::vector<StocksDataBookEntry>& entries, std::size_t bytesRead)> chunkConsumer;
+
+    // Parses prices and amounts written as plain decimals straight into scaled integers as well, for exact aggregation
+    bool fixedPoint = false;
+};
+
+/** Structure is used to hold the converted fields of a valid CSV line */
+struct CSVRow
+{
+    std::int64_t timestamp;
+    // Refers to the characters of the line
+    std::string_view product;
+    StocksDataBookType SDBEtype;
+    double price;
+    double amount;
+    // Price and amount as counts of units of 10^-decimals, parsed in fixed-point mode; the decimals are
+    // FixedPoint::noDecimals otherwise
+    std::int64_t priceUnits;
+    std::int64_t amountUnits;
+    std::uint8_t priceDecimals;
+    std::uint8_t amountDecimals;
+};
 
 class CSVFileReader
 {
@@ -14,6 +71,21 @@ public:
     /** Parse the CSV file and convert valid lines into SDBEs */
     static std::vector<StocksDataBookEntry> readCSVfile(std::string csvFile);
 
+    /** @overload static std::vector<StocksDataBookEntry> readCSVfile(std::string csvFile, LoadReport& loadReport)
+     *
+     *  Parse the CSV file and record bytes, rows, rejects, phase times and memory usage in the load report
+     */
+    static std::vector<StocksDataBookEntry> readCSVfile(std::string csvFile, LoadReport& loadReport);
+
+    /** @overload static std::vector<StocksDataBookEntry> readCSVfile(std::string csvFile, LoadReport& loadReport, const CSVReadOptions& options)
+     *
+     *  Parse the CSV file, validating every line without exceptions and treating malformed lines as the options request
+     */
+    static std::vector<StocksDataBookEntry> readCSVfile(std::string csvFile, LoadReport& loadReport, const CSVReadOptions& options);
+
+    /** Validate a CSV line and convert its fields, without allocating or throwing */
+    static CSVRejectReason parseCSVline(std::string_view csvLine, CSVRow& row, bool fixedPoint = false);
+
     /** Split a CSV line into tokens based on a delimiter */
     static std::vector<std::string> tokenize(std::string csvLine, char separator);
 
@@ -24,7 +96,22 @@ public:
                                             std::string product,
                                             StocksDataBookType StocksDataBookType);
 
+    // Number of bytes read from the file at a time by the stream method; lines straddling two reads are carried over
+    static constexpr std::size_t readChunkBytes = 1 << 20;
+
 private:
+    /** Validate the fields of a CSV line and convert them, without allocating or throwing */
+    static CSVRejectReason parseCSVfields(const std::string_view* fields, std::size_t numFields, CSVRow& row, bool fixedPoint);
+
+    /** Convert a field into a finite, non-negative number, ignoring surrounding spaces */
+    static bool parseNumber(std::string_view field, double& number);
+
+    /** @overload static bool parseNumber(std::string_view field, double& number, std::int64_t& units, std::uint8_t& decimals)
+     *
+     *  Convert a field into a finite, non-negative number, straight from the text into units where it is a plain decimal
+     */
+    static bool parseNumber(std::string_view field, double& number, std::int64_t& units, std::uint8_t& decimals);
+
     /** @overload static StocksDataBookEntry stringsToSDBE(std::vector<std::string> tokens)
      * 
      *  Convert a string into an SDBE based on its number of tokens and data types
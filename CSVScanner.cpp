@@ -0,0 +1,258 @@
+#include "CSVScanner.h"
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define ADVISORBOT_CSV_SCANNER_X86 1
+#include <immintrin.h>
+#endif
+
+namespace
+{
+    /** Return where the positions of the next 64-byte block are written, past the count already found
+     *
+     *  The room grows geometrically, so the output is sized in proportion to the delimiters found rather than
+     *  to the bytes scanned
+     */
+    inline std::uint32_t* makeRoomForBlock(std::vector<std::uint32_t>& positions, std::size_t count)
+    {
+        if (positions.size() - count < 64)
+        {
+            positions.resize(std::max(positions.size() * 2, count + 64));
+        }
+        return positions.data() + count;
+    }
+
+    /** Write the position of every set bit of a 64-byte block's match mask, lowest first */
+    inline std::size_t writeMatches(std::uint64_t mask, std::size_t blockStart, std::uint32_t* output)
+    {
+        std::size_t count = 0;
+        while (mask != 0)
+        {
+            output[count++] = static_cast<std::uint32_t>(blockStart + __builtin_ctzll(mask));
+            mask &= mask - 1;
+        }
+        return count;
+    }
+}
+
+/** Append the position of every separator and line terminator in a buffer, using the fastest supported instruction set
+ *
+ *  @param data       First byte of the buffer
+ *  @param length     Number of bytes in the buffer, less than 4 GiB
+ *  @param separator  Field separator, such as ','
+ *  @param terminator Line terminator, such as '\n' (pass the separator again to find separators only)
+ *  @param positions  Receives the offsets of the delimiters within the buffer, in increasing order
+ *
+ */
+void CSVScanner::findDelimiters(const char* data, std::size_t length, char separator, char terminator, std::vector<std::uint32_t>& positions)
+{
+    static const CSVScannerImplementation bestImplementation = getBestImplementation();
+    findDelimiters(data, length, separator, terminator, positions, bestImplementation);
+}
+
+/** Append the position of every separator and line terminator in a buffer, using the instruction set requested
+ *
+ *  Unsupported implementations fall back to the scalar scan
+ *
+ *  @param data           First byte of the buffer
+ *  @param length         Number of bytes in the buffer, less than 4 GiB
+ *  @param separator      Field separator, such as ','
+ *  @param terminator     Line terminator, such as '\n' (pass the separator again to find separators only)
+ *  @param positions      Receives the offsets of the delimiters within the buffer, in increasing order
+ *  @param implementation Instruction set to scan with
+ *
+ */
+void CSVScanner::findDelimiters(const char* data, std::size_t length, char separator, char terminator, std::vector<std::uint32_t>& positions, CSVScannerImplementation implementation)
+{
+    // The scans write past the positions found so far, into room grown block by block, which is trimmed afterwards
+    std::size_t count = positions.size();
+    if (implementation == CSVScannerImplementation::avx2 && isSupported(implementation))
+    {
+        count = scanAVX2(data, length, separator, terminator, positions, count);
+    }
+    else if (implementation == CSVScannerImplementation::sse2 && isSupported(implementation))
+    {
+        count = scanSSE2(data, length, separator, terminator, positions, count);
+    }
+    else
+    {
+        count = scanScalar(data, 0, length, separator, terminator, positions, count);
+    }
+    positions.resize(count);
+}
+
+/** Return the fastest implementation supported by the processor
+ *
+ *  @return AVX2 or SSE2 where available, scalar otherwise
+ *
+ */
+CSVScannerImplementation CSVScanner::getBestImplementation()
+{
+    if (isSupported(CSVScannerImplementation::avx2))
+    {
+        return CSVScannerImplementation::avx2;
+    }
+    if (isSupported(CSVScannerImplementation::sse2))
+    {
+        return CSVScannerImplementation::sse2;
+    }
+    return CSVScannerImplementation::scalar;
+}
+
+/** Return true if the processor supports an implementation
+ *
+ *  @param implementation Instruction set to be checked
+ *  @return               true if the implementation can run on this processor
+ *
+ */
+bool CSVScanner::isSupported(CSVScannerImplementation implementation)
+{
+    switch (implementation)
+    {
+#ifdef ADVISORBOT_CSV_SCANNER_X86
+    case CSVScannerImplementation::avx2:
+        return __builtin_cpu_supports("avx2");
+    case CSVScannerImplementation::sse2:
+        return __builtin_cpu_supports("sse2");
+#endif
+    case CSVScannerImplementation::scalar:
+        return true;
+    default:
+        return false;
+    }
+}
+
+/** Convert an implementation to a printable string
+ *
+ *  @param implementation Instruction set
+ *  @return               name of the instruction set
+ *
+ */
+const char* CSVScanner::implementationToString(CSVScannerImplementation implementation)
+{
+    switch (implementation)
+    {
+    case CSVScannerImplementation::avx2:
+        return "avx2";
+    case CSVScannerImplementation::sse2:
+        return "sse2";
+    default:
+        return "scalar";
+    }
+}
+
+/** Scan one byte at a time
+ *
+ *  @param data       First byte of the buffer
+ *  @param begin      Offset of the first byte to be scanned
+ *  @param length     Number of bytes in the buffer
+ *  @param separator  Field separator
+ *  @param terminator Line terminator
+ *  @param positions  Receives the offsets of the delimiters after the first count elements, with room to spare
+ *  @param count      Number of positions already found
+ *  @return           number of positions found, including those already found
+ *
+ */
+std::size_t CSVScanner::scanScalar(const char* data, std::size_t begin, std::size_t length, char separator, char terminator, std::vector<std::uint32_t>& positions, std::size_t count)
+{
+    for (std::size_t blockStart = begin; blockStart < length; blockStart += 64)
+    {
+        std::uint32_t* output = makeRoomForBlock(positions, count);
+        std::size_t blockEnd = std::min(length, blockStart + 64);
+        std::size_t found = 0;
+        for (std::size_t i = blockStart; i < blockEnd; ++i)
+        {
+            if (data[i] == separator || data[i] == terminator)
+            {
+                output[found++] = static_cast<std::uint32_t>(i);
+            }
+        }
+        count += found;
+    }
+    return count;
+}
+
+#ifdef ADVISORBOT_CSV_SCANNER_X86
+
+/** Scan 64 bytes at a time as four 16-byte SSE2 vectors
+ *
+ *  Each vector is compared against both delimiters, and the byte masks are combined into one 64-bit mask
+ *  per block whose set bits are turned into positions. The remaining bytes are scanned one at a time
+ *
+ *  @param data       First byte of the buffer
+ *  @param length     Number of bytes in the buffer
+ *  @param separator  Field separator
+ *  @param terminator Line terminator
+ *  @param positions  Receives the offsets of the delimiters after the first count elements, with room to spare
+ *  @param count      Number of positions already found
+ *  @return           number of positions found, including those already found
+ *
+ */
+__attribute__((target("sse2")))
+std::size_t CSVScanner::scanSSE2(const char* data, std::size_t length, char separator, char terminator, std::vector<std::uint32_t>& positions, std::size_t count)
+{
+    const __m128i separators = _mm_set1_epi8(separator);
+    const __m128i terminators = _mm_set1_epi8(terminator);
+
+    std::size_t i = 0;
+    for (; i + 64 <= length; i += 64)
+    {
+        // Combine the byte masks of the four vectors into one 64-bit mask
+        std::uint64_t mask = 0;
+        for (std::size_t vector = 0; vector < 4; ++vector)
+        {
+            __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + 16 * vector));
+            __m128i matches = _mm_or_si128(_mm_cmpeq_epi8(bytes, separators), _mm_cmpeq_epi8(bytes, terminators));
+            mask |= static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm_movemask_epi8(matches))) << (16 * vector);
+        }
+        count += writeMatches(mask, i, makeRoomForBlock(positions, count));
+    }
+    return scanScalar(data, i, length, separator, terminator, positions, count);
+}
+
+/** Scan 64 bytes at a time as two 32-byte AVX2 vectors
+ *
+ *  @param data       First byte of the buffer
+ *  @param length     Number of bytes in the buffer
+ *  @param separator  Field separator
+ *  @param terminator Line terminator
+ *  @param positions  Receives the offsets of the delimiters after the first count elements, with room to spare
+ *  @param count      Number of positions already found
+ *  @return           number of positions found, including those already found
+ *
+ */
+__attribute__((target("avx2")))
+std::size_t CSVScanner::scanAVX2(const char* data, std::size_t length, char separator, char terminator, std::vector<std::uint32_t>& positions, std::size_t count)
+{
+    const __m256i separators = _mm256_set1_epi8(separator);
+    const __m256i terminators = _mm256_set1_epi8(terminator);
+
+    std::size_t i = 0;
+    for (; i + 64 <= length; i += 64)
+    {
+        // Combine the byte masks of the two vectors into one 64-bit mask
+        __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + 32));
+        __m256i lowMatches = _mm256_or_si256(_mm256_cmpeq_epi8(low, separators), _mm256_cmpeq_epi8(low, terminators));
+        __m256i highMatches = _mm256_or_si256(_mm256_cmpeq_epi8(high, separators), _mm256_cmpeq_epi8(high, terminators));
+        std::uint64_t mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(lowMatches))
+                           | static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm256_movemask_epi8(highMatches))) << 32;
+        count += writeMatches(mask, i, makeRoomForBlock(positions, count));
+    }
+    return scanScalar(data, i, length, separator, terminator, positions, count);
+}
+
+#else
+
+// Other architectures only have the scalar scan
+std::size_t CSVScanner::scanSSE2(const char* data, std::size_t length, char separator, char terminator, std::vector<std::uint32_t>& positions, std::size_t count)
+{
+    return scanScalar(data, 0, length, separator, terminator, positions, count);
+}
+
+std::size_t CSVScanner::scanAVX2(const char* data, std::size_t length, char separator, char terminator, std::vector<std::uint32_t>& positions, std::size_t count)
+{
+    return scanScalar(data, 0, length, separator, terminator, positions, count);
+}
+
+#endif
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/** Establish the instruction sets the delimiter scan can use */
+enum class CSVScannerImplementation
+{
+    scalar,
+    sse2,
+    avx2
+};
+
+class CSVScanner
+{
+public:
+    /** Append the position of every separator and line terminator in a buffer, using the fastest supported instruction set */
+    static void findDelimiters(const char* data, std::size_t length, char separator, char terminator, std::vector<std::uint32_t>& positions);
+
+    /** @overload static void findDelimiters(const char* data, std::size_t length, char separator, char terminator, std::vector<std::uint32_t>& positions, CSVScannerImplementation implementation)
+     *
+     *  Append the position of every separator and line terminator in a buffer, using the instruction set requested
+     */
+    static void findDelimiters(const char* data, std::size_t length, char separator, char terminator, std::vector<std::uint32_t>& positions, CSVScannerImplementation implementation);
+
+    /** Return the fastest implementation supported by the processor */
+    static CSVScannerImplementation getBestImplementation();
+
+    /** Return true if the processor supports an implementation */
+    static bool isSupported(CSVScannerImplementation implementation);
+
+    /** Convert an implementation to a printable string */
+    static const char* implementationToString(CSVScannerImplementation implementation);
+
+private:
+    /** Scan one byte at a time */
+    static std::size_t scanScalar(const char* data, std::size_t begin, std::size_t length, char separator, char terminator, std::vector<std::uint32_t>& positions, std::size_t count);
+
+    /** Scan 64 bytes at a time as four 16-byte SSE2 vectors */
+    static std::size_t scanSSE2(const char* data, std::size_t length, char separator, char terminator, std::vector<std::uint32_t>& positions, std::size_t count);
+
+    /** Scan 64 bytes at a time as two 32-byte AVX2 vectors */
+    static std::size_t scanAVX2(const char* data, std::size_t length, char separator, char terminator, std::vector<std::uint32_t>& positions, std::size_t count);
+};
@@ -0,0 +1,266 @@
+#include "CandleEngine.h"
+#include "TimeStamp.h"
+#include <algorithm>
+
+namespace
+{
+    // Durations of the time-based resolutions from which coarser candles are derived
+    const std::int64_t microsecondsPerMinute = 60 * TimeStamp::microsecondsPerSecond;
+    const std::int64_t microsecondsPerHour = 60 * microsecondsPerMinute;
+}
+
+/** Initialize a candle engine over a StocksDataBook
+ *
+ *  @param _stocksDataBook Dataset from which candles are built
+ *
+ */
+CandleEngine::CandleEngine(const StocksDataBook& _stocksDataBook)
+    : stocksDataBook(_stocksDataBook)
+{
+}
+
+/** Parse a resolution such as "1t", "5t", "30s", "1m" or "1h"
+ *
+ *  @param resolutionName Positive count followed by t (time steps), s (seconds), m (minutes) or h (hours)
+ *  @param resolution     Receives the parsed resolution
+ *  @return               true if the resolution was recognized, false otherwise
+ *
+ */
+bool CandleEngine::parseResolution(const std::string& resolutionName, CandleResolution& resolution)
+{
+    if (resolutionName.size() < 2)
+    {
+        return false;
+    }
+
+    // Split into the count and the unit
+    std::int64_t count = 0;
+    for (std::size_t i = 0; i + 1 < resolutionName.size(); ++i)
+    {
+        if (resolutionName[i] < '0' || resolutionName[i] > '9' || count > 1000000)
+        {
+            return false;
+        }
+        count = count * 10 + (resolutionName[i] - '0');
+    }
+    if (count == 0)
+    {
+        return false;
+    }
+
+    resolution = CandleResolution{};
+    switch (resolutionName.back())
+    {
+    case 't':
+        resolution.timeSteps = count;
+        return true;
+    case 's':
+        resolution.microseconds = count * TimeStamp::microsecondsPerSecond;
+        return true;
+    case 'm':
+        resolution.microseconds = count * microsecondsPerMinute;
+        return true;
+    case 'h':
+        resolution.microseconds = count * microsecondsPerHour;
+        return true;
+    default:
+        return false;
+    }
+}
+
+/** Return the candles of a product and side at a resolution, deriving them from finer candles on first use
+ *
+ *  @param product    Product name
+ *  @param side       SDBE type - ask/bid
+ *  @param resolution Width of each candle
+ *  @return           candles in time order, covering only time steps in which the side has SDBEs
+ *
+ */
+const std::vector<Candle>& CandleEngine::getCandles(const std::string& product, StocksDataBookType side, const CandleResolution& resolution)
+{
+    std::string cacheKey = product + '|' + (side == StocksDataBookType::bid ? "bid" : "ask") + '|' + resolutionToString(resolution);
+
+    auto it = candleCache.find(cacheKey);
+    if (it != candleCache.end())
+    {
+        return it->second;
+    }
+
+    // Single time step candles are the base of every rollup
+    if (resolution.timeSteps == 1)
+    {
+        return candleCache[cacheKey] = buildTimeStepCandles(product, side);
+    }
+
+    // Derive the candles from the cached (or recursively derived) finer resolution rather than rescanning SDBEs
+    const std::vector<Candle>& finerCandles = getCandles(product, side, getParentResolution(resolution));
+    std::vector<Candle> candles = rollUp(finerCandles, resolution);
+    return candleCache[cacheKey] = std::move(candles);
+}
+
+/** Return a candle cut short so that it closes at a time step, refolding the time steps it still covers
+ *
+ *  @param product      Product name
+ *  @param side         SDBE type - ask/bid
+ *  @param candle       Candle of the product and side starting at or before lastTimeStep
+ *  @param lastTimeStep Position of the last time step the candle may cover
+ *  @return             the candle unchanged if it ends by lastTimeStep, otherwise the candle of its time steps up to lastTimeStep
+ *
+ */
+Candle CandleEngine::closeCandleAt(const std::string& product, StocksDataBookType side, const Candle& candle, std::size_t lastTimeStep)
+{
+    if (candle.lastTimeStep <= lastTimeStep)
+    {
+        return candle;
+    }
+
+    // Locate the single time step candles from the candle's first time step up to lastTimeStep
+    const std::vector<Candle>& timeStepCandles = getCandles(product, side, CandleResolution{ 1, 0 });
+    auto first = std::lower_bound(timeStepCandles.begin(), timeStepCandles.end(), candle.firstTimeStep,
+        [](const Candle& timeStepCandle, std::size_t timeStep) { return timeStepCandle.firstTimeStep < timeStep; });
+    auto last = std::upper_bound(first, timeStepCandles.end(), lastTimeStep,
+        [](std::size_t timeStep, const Candle& timeStepCandle) { return timeStep < timeStepCandle.firstTimeStep; });
+
+    Candle closedCandle = *first;
+    closedCandle.bucketStart = candle.bucketStart;
+    for (auto it = first + 1; it != last; ++it)
+    {
+        fold(closedCandle, *it);
+    }
+    return closedCandle;
+}
+
+/** Discard all cached candles */
+void CandleEngine::clearCache()
+{
+    candleCache.clear();
+}
+
+/** Build one candle per time step from the per time step aggregates
+ *
+ *  A single time step has no ordering of its SDBEs, so its open and close are both the volume-weighted
+ *  average price of the side, while its high and low are the extreme prices offered
+ *
+ *  @param product Product name
+ *  @param side    SDBE type - ask/bid
+ *  @return        one candle per time step in which the side has SDBEs
+ *
+ */
+std::vector<Candle> CandleEngine::buildTimeStepCandles(const std::string& product, StocksDataBookType side)
+{
+    const std::vector<std::int64_t>& timeStepMicroseconds = stocksDataBook.getTimeStampIndex().getTimes();
+    const std::vector<TimeStepAggregate>& aggregates = stocksDataBook.getTimeStepAggregates(product, side);
+
+    std::vector<Candle> candles;
+    for (std::size_t i = 0; i < aggregates.size(); ++i)
+    {
+        const TimeStepAggregate& aggregate = aggregates[i];
+        if (aggregate.entries == 0)
+        {
+            continue;
+        }
+
+        // Fall back to the unweighted average price if no amount was offered
+        double referencePrice = aggregate.sumAmount != 0 ? aggregate.sumPriceAmount / aggregate.sumAmount : aggregate.sumPrice / aggregate.entries;
+        candles.push_back(Candle{ timeStepMicroseconds[i], i, i, referencePrice, aggregate.maxPrice, aggregate.minPrice, referencePrice, aggregate.sumAmount });
+    }
+    return candles;
+}
+
+/** Merge consecutive finer candles into candles of a coarser resolution
+ *
+ *  @param finerCandles Candles of a resolution that divides the target resolution
+ *  @param resolution   Target resolution
+ *  @return             candles at the target resolution
+ *
+ */
+std::vector<Candle> CandleEngine::rollUp(const std::vector<Candle>& finerCandles, const CandleResolution& resolution)
+{
+    std::vector<Candle> candles;
+    std::int64_t currentBucket = 0;
+
+    for (const Candle& finerCandle : finerCandles)
+    {
+        // Bucket by position for time step resolutions, and by aligned time for time-based resolutions
+        std::int64_t bucket = resolution.timeSteps != 0
+            ? static_cast<std::int64_t>(finerCandle.firstTimeStep) / resolution.timeSteps
+            : (finerCandle.bucketStart - ((finerCandle.bucketStart % resolution.microseconds) + resolution.microseconds) % resolution.microseconds) / resolution.microseconds;
+
+        if (candles.empty() || bucket != currentBucket)
+        {
+            // Open a new candle from the first finer candle of the bucket
+            Candle candle = finerCandle;
+            candle.bucketStart = resolution.timeSteps != 0 ? finerCandle.bucketStart : bucket * resolution.microseconds;
+            candles.push_back(candle);
+            currentBucket = bucket;
+            continue;
+        }
+
+        // Fold the finer candle into the open candle
+        fold(candles.back(), finerCandle);
+    }
+    return candles;
+}
+
+/** Fold a later finer candle into a candle
+ *
+ *  @param candle      Candle being extended
+ *  @param finerCandle Candle following the time steps already folded into candle
+ *
+ */
+void CandleEngine::fold(Candle& candle, const Candle& finerCandle)
+{
+    candle.high = std::max(candle.high, finerCandle.high);
+    candle.low = std::min(candle.low, finerCandle.low);
+    candle.close = finerCandle.close;
+    candle.volume += finerCandle.volume;
+    candle.lastTimeStep = finerCandle.lastTimeStep;
+}
+
+/** Return the resolution from which candles of a resolution are derived
+ *
+ *  @param resolution Resolution to be derived
+ *  @return           hourly candles for multi-hour resolutions, minute candles for multi-minute resolutions,
+ *                    and single time step candles otherwise
+ *
+ */
+CandleResolution CandleEngine::getParentResolution(const CandleResolution& resolution)
+{
+    CandleResolution parentResolution;
+    if (resolution.microseconds > microsecondsPerHour && resolution.microseconds % microsecondsPerHour == 0)
+    {
+        parentResolution.microseconds = microsecondsPerHour;
+    }
+    else if (resolution.microseconds > microsecondsPerMinute && resolution.microseconds % microsecondsPerMinute == 0)
+    {
+        parentResolution.microseconds = microsecondsPerMinute;
+    }
+    else
+    {
+        parentResolution.timeSteps = 1;
+    }
+    return parentResolution;
+}
+
+/** Return the canonical name of a resolution
+ *
+ *  @param resolution Resolution to be named
+ *  @return           name such that equal resolutions share one name
+ *
+ */
+std::string CandleEngine::resolutionToString(const CandleResolution& resolution)
+{
+    if (resolution.timeSteps != 0)
+    {
+        return std::to_string(resolution.timeSteps) + "t";
+    }
+    if (resolution.microseconds % microsecondsPerHour == 0)
+    {
+        return std::to_string(resolution.microseconds / microsecondsPerHour) + "h";
+    }
+    if (resolution.microseconds % microsecondsPerMinute == 0)
+    {
+        return std::to_string(resolution.microseconds / microsecondsPerMinute) + "m";
+    }
+    return std::to_string(resolution.microseconds / TimeStamp::microsecondsPerSecond) + "s";
+}
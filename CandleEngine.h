@@ -0,0 +1,74 @@
+#pragma once
+
+#include "StocksDataBookEntry.h"
+#include "StocksDataBook.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <map>
+
+/** Structure is used to describe one OHLC/volume candle */
+struct Candle
+{
+    // Start of the candle's bucket, in microseconds since 1970/01/01
+    std::int64_t bucketStart;
+
+    // Positions of the first and last time steps within getTimeSteps() covered by the candle
+    std::size_t firstTimeStep;
+    std::size_t lastTimeStep;
+
+    double open;
+    double high;
+    double low;
+    double close;
+    double volume;
+};
+
+/** Structure is used to describe the width of a candle, either in time steps or in time */
+struct CandleResolution
+{
+    // Exactly one of the two is non-zero
+    std::int64_t timeSteps = 0;
+    std::int64_t microseconds = 0;
+};
+
+class CandleEngine
+{
+public:
+    /** Initialize a candle engine over a StocksDataBook */
+    CandleEngine(const StocksDataBook& _stocksDataBook);
+
+    /** Parse a resolution such as "1t", "5t", "30s", "1m" or "1h" */
+    static bool parseResolution(const std::string& resolutionName, CandleResolution& resolution);
+
+    /** Return the candles of a product and side at a resolution, deriving them from finer candles on first use */
+    const std::vector<Candle>& getCandles(const std::string& product, StocksDataBookType side, const CandleResolution& resolution);
+
+    /** Return a candle cut short so that it closes at a time step, refolding the time steps it still covers */
+    Candle closeCandleAt(const std::string& product, StocksDataBookType side, const Candle& candle, std::size_t lastTimeStep);
+
+    /** Discard all cached candles */
+    void clearCache();
+
+private:
+    /** Build one candle per time step from the per time step aggregates */
+    std::vector<Candle> buildTimeStepCandles(const std::string& product, StocksDataBookType side);
+
+    /** Merge consecutive finer candles into candles of a coarser resolution */
+    static std::vector<Candle> rollUp(const std::vector<Candle>& finerCandles, const CandleResolution& resolution);
+
+    /** Fold a later finer candle into a candle */
+    static void fold(Candle& candle, const Candle& finerCandle);
+
+    /** Return the resolution from which candles of a resolution are derived */
+    static CandleResolution getParentResolution(const CandleResolution& resolution);
+
+    /** Return the canonical name of a resolution */
+    static std::string resolutionToString(const CandleResolution& resolution);
+
+    /** Dataset from which candles are built */
+    const StocksDataBook& stocksDataBook;
+
+    /** Candles built so far, keyed by product, side and resolution */
+    std::map<std::string, std::vector<Candle>> candleCache;
+};
@@ -0,0 +1,130 @@
+#include "CorrelationMatrix.h"
+#include "ParallelFor.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+/** Compute the pairwise Pearson correlations of equally long series as a row-major square matrix
+ *
+ *  Each series is standardized once, after which a correlation is the dot product of two standardized
+ *  series. The upper triangle of the matrix is split into tiles that are computed in parallel, and each
+ *  tile walks the series in chunks so that the inputs of a tile are reused from cache
+ *
+ *  @param series Series of equal length, e.g. one per product
+ *  @return       series.size() x series.size() correlations, NaN for pairs involving a constant series
+ *
+ */
+std::vector<double> CorrelationMatrix::compute(const std::vector<std::vector<double>>& series)
+{
+    const std::size_t numSeries = series.size();
+    const double missing = std::numeric_limits<double>::quiet_NaN();
+    std::vector<double> matrix(numSeries * numSeries, missing);
+    if (numSeries == 0)
+    {
+        return matrix;
+    }
+    const std::size_t length = series[0].size();
+
+    // Standardize every series in parallel, a series without variance has no correlation
+    std::vector<std::vector<double>> standardized(numSeries);
+    std::vector<char> hasVariance(numSeries, 0);
+    ParallelFor::run(numSeries, [&](std::size_t i) { hasVariance[i] = standardize(series[i], standardized[i]); });
+
+    // Enumerate the tiles on or above the diagonal
+    const std::size_t numTileRows = (numSeries + seriesPerTile - 1) / seriesPerTile;
+    std::vector<std::pair<std::size_t, std::size_t>> tiles;
+    for (std::size_t tileRow = 0; tileRow < numTileRows; ++tileRow)
+    {
+        for (std::size_t tileColumn = tileRow; tileColumn < numTileRows; ++tileColumn)
+        {
+            tiles.emplace_back(tileRow, tileColumn);
+        }
+    }
+
+    ParallelFor::run(tiles.size(), [&](std::size_t tileIndex)
+    {
+        const std::size_t rowBegin = tiles[tileIndex].first * seriesPerTile;
+        const std::size_t rowEnd = std::min(rowBegin + seriesPerTile, numSeries);
+        const std::size_t columnBegin = tiles[tileIndex].second * seriesPerTile;
+        const std::size_t columnEnd = std::min(columnBegin + seriesPerTile, numSeries);
+
+        // Dot products of the tile, accumulated chunk by chunk
+        double dotProducts[seriesPerTile][seriesPerTile] = {};
+        for (std::size_t chunkBegin = 0; chunkBegin < length; chunkBegin += elementsPerChunk)
+        {
+            const std::size_t chunkEnd = std::min(chunkBegin + elementsPerChunk, length);
+            for (std::size_t row = rowBegin; row < rowEnd; ++row)
+            {
+                const double* x = standardized[row].data();
+                for (std::size_t column = std::max(row, columnBegin); column < columnEnd; ++column)
+                {
+                    const double* y = standardized[column].data();
+                    double sum = 0;
+                    for (std::size_t k = chunkBegin; k < chunkEnd; ++k)
+                    {
+                        sum += x[k] * y[k];
+                    }
+                    dotProducts[row - rowBegin][column - columnBegin] += sum;
+                }
+            }
+        }
+
+        // Mirror the tile into both triangles, each matrix cell is written by exactly one tile
+        for (std::size_t row = rowBegin; row < rowEnd; ++row)
+        {
+            for (std::size_t column = std::max(row, columnBegin); column < columnEnd; ++column)
+            {
+                double correlation = missing;
+                if (hasVariance[row] && hasVariance[column])
+                {
+                    // Clamp rounding error so that the result stays within [-1, 1]
+                    correlation = std::max(-1.0, std::min(1.0, dotProducts[row - rowBegin][column - columnBegin]));
+                }
+                matrix[row * numSeries + column] = correlation;
+                matrix[column * numSeries + row] = correlation;
+            }
+        }
+    });
+    return matrix;
+}
+
+/** Centre a series on its mean and scale it to unit length
+ *
+ *  @param values       Series to be standardized
+ *  @param standardized Receives the standardized series, all zeros if the series has no variance
+ *  @return             true if the series has a finite, non-zero variance, false otherwise
+ *
+ */
+bool CorrelationMatrix::standardize(const std::vector<double>& values, std::vector<double>& standardized)
+{
+    standardized.assign(values.size(), 0);
+    if (values.empty())
+    {
+        return false;
+    }
+
+    double mean = 0;
+    for (double value : values)
+    {
+        mean += value;
+    }
+    mean /= values.size();
+
+    double sumSquaredDeviations = 0;
+    for (double value : values)
+    {
+        sumSquaredDeviations += (value - mean) * (value - mean);
+    }
+    if (!(sumSquaredDeviations > 0) || !std::isfinite(sumSquaredDeviations))
+    {
+        return false;
+    }
+
+    const double scale = 1.0 / std::sqrt(sumSquaredDeviations);
+    for (std::size_t i = 0; i < values.size(); ++i)
+    {
+        standardized[i] = (values[i] - mean) * scale;
+    }
+    return true;
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+class CorrelationMatrix
+{
+public:
+    /** Compute the pairwise Pearson correlations of equally long series as a row-major square matrix */
+    static std::vector<double> compute(const std::vector<std::vector<double>>& series);
+
+    /** Number of series per side of a tile of the matrix */
+    static const std::size_t seriesPerTile = 8;
+
+    /** Number of elements of each series processed per pass over a tile, sized to keep a tile's inputs in cache */
+    static const std::size_t elementsPerChunk = 2048;
+
+private:
+    /** Centre a series on its mean and scale it to unit length */
+    static bool standardize(const std::vector<double>& values, std::vector<double>& standardized);
+};
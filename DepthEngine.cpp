@@ -0,0 +1,203 @@
+#include "DepthEngine.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // Upper bound on the number of cached ladders before the cache is discarded
+    const std::size_t maxCachedLadders = 16384;
+}
+
+/** Initialize a depth engine over a StocksDataBook
+ *
+ *  @param _stocksDataBook Dataset from which ladders are built
+ *
+ */
+DepthEngine::DepthEngine(const StocksDataBook& _stocksDataBook)
+    : stocksDataBook(_stocksDataBook)
+{
+}
+
+/** Return the level-aggregated bid and ask ladders of a product at a timestamp, building them on first use
+ *
+ *  @param product   Product name
+ *  @param timestamp Timestamp of the ladders
+ *  @return          bid and ask ladders, empty if the product has no SDBEs at the timestamp
+ *
+ */
+const DepthLadders& DepthEngine::getLadders(const std::string& product, const std::string& timestamp)
+{
+    std::string cacheKey = makeCacheKey(product, timestamp);
+
+    // Serve repeated queries on a time step from the cache
+    auto it = ladderCache.find(cacheKey);
+    if (it != ladderCache.end())
+    {
+        return it->second;
+    }
+
+    // Products absent from an already built time step have no ladders
+    if (builtTimeStamps.count(timestamp) != 0)
+    {
+        return emptyLadders;
+    }
+
+    buildLadders(timestamp);
+
+    it = ladderCache.find(cacheKey);
+    return it != ladderCache.end() ? it->second : emptyLadders;
+}
+
+/** Compute the price impact of filling an amount against the asks (buying) or bids (selling)
+ *
+ *  @param product   Product name
+ *  @param timestamp Timestamp of the book to fill against
+ *  @param side      Side of the book consumed by the fill - ask/bid
+ *  @param amount    Amount to be filled
+ *  @return          fill statistics, with a filled amount below the request if the side is too shallow
+ *
+ */
+PriceImpact DepthEngine::computePriceImpact(const std::string& product, const std::string& timestamp, StocksDataBookType side, double amount)
+{
+    const DepthLadders& ladders = getLadders(product, timestamp);
+    const std::vector<PriceLevel>& ladder = side == StocksDataBookType::ask ? ladders.asks : ladders.bids;
+
+    PriceImpact priceImpact{ amount, 0, 0, 0, 0, 0, 0 };
+    if (ladder.empty())
+    {
+        return priceImpact;
+    }
+
+    priceImpact.bestPrice = ladder.front().price;
+
+    // Walk the ladder from the best level until the amount is filled
+    double notional = 0;
+    for (const PriceLevel& level : ladder)
+    {
+        if (priceImpact.filledAmount >= amount)
+        {
+            break;
+        }
+        double fill = std::min(level.amount, amount - priceImpact.filledAmount);
+        priceImpact.filledAmount += fill;
+        notional += fill * level.price;
+        priceImpact.worstPrice = level.price;
+        ++priceImpact.levelsTouched;
+    }
+
+    if (priceImpact.filledAmount > 0)
+    {
+        priceImpact.averagePrice = notional / priceImpact.filledAmount;
+        priceImpact.impactBasisPoints = std::fabs(priceImpact.averagePrice - priceImpact.bestPrice) / priceImpact.bestPrice * 10000.0;
+    }
+    return priceImpact;
+}
+
+/** Discard all cached ladders */
+void DepthEngine::clearCache()
+{
+    ladderCache.clear();
+    builtTimeStamps.clear();
+}
+
+/** Build the ladders of every product at a timestamp in a single pass over its SDBEs
+ *
+ *  @param timestamp Timestamp of the ladders
+ *
+ */
+void DepthEngine::buildLadders(const std::string& timestamp)
+{
+    long timeStepIndex = stocksDataBook.findTimeStep(timestamp);
+    if (timeStepIndex < 0)
+    {
+        return;
+    }
+
+    // Bound the memory held by the cache
+    if (ladderCache.size() >= maxCachedLadders)
+    {
+        clearCache();
+    }
+    builtTimeStamps.insert(timestamp);
+
+    const TimeStepRange& timeStep = stocksDataBook.getTimeSteps()[timeStepIndex];
+    const std::vector<StocksDataBookEntry>& entries = stocksDataBook.getEntries();
+
+    // Distribute the SDBEs of the time step into per-product raw ladders
+    std::vector<std::string> productsAtTimeStep;
+    for (std::size_t i = timeStep.begin; i < timeStep.end; ++i)
+    {
+        const StocksDataBookEntry& entry = entries[i];
+        if (entry.SDBEtype == StocksDataBookType::unknown)
+        {
+            continue;
+        }
+
+        std::string cacheKey = makeCacheKey(entry.product, timestamp);
+        auto inserted = ladderCache.try_emplace(cacheKey);
+        if (inserted.second)
+        {
+            productsAtTimeStep.push_back(cacheKey);
+        }
+
+        std::vector<PriceLevel>& ladder = entry.SDBEtype == StocksDataBookType::bid ? inserted.first->second.bids : inserted.first->second.asks;
+        ladder.push_back(PriceLevel{ entry.price, entry.amount, 0, 1 });
+    }
+
+    // Sort and aggregate each raw ladder built in this pass
+    for (const std::string& cacheKey : productsAtTimeStep)
+    {
+        DepthLadders& ladders = ladderCache[cacheKey];
+        aggregateLevels(ladders.bids, true);
+        aggregateLevels(ladders.asks, false);
+    }
+}
+
+/** Sort and aggregate raw SDBE prices into a ladder with cumulative amounts
+ *
+ *  @param ladder     One level per SDBE on input, one level per distinct price on output
+ *  @param descending true to order the best (highest) bid first, false to order the best (lowest) ask first
+ *
+ */
+void DepthEngine::aggregateLevels(std::vector<PriceLevel>& ladder, bool descending)
+{
+    std::sort(ladder.begin(), ladder.end(), [descending](const PriceLevel& a, const PriceLevel& b)
+    {
+        return descending ? a.price > b.price : a.price < b.price;
+    });
+
+    // Merge levels sharing a price in place, and accumulate amounts from the best level outwards
+    std::size_t aggregatedLevels = 0;
+    double cumulativeAmount = 0;
+    for (std::size_t i = 0; i < ladder.size(); ++i)
+    {
+        if (aggregatedLevels > 0 && ladder[aggregatedLevels - 1].price == ladder[i].price)
+        {
+            ladder[aggregatedLevels - 1].amount += ladder[i].amount;
+            ladder[aggregatedLevels - 1].entries += ladder[i].entries;
+        }
+        else
+        {
+            ladder[aggregatedLevels++] = ladder[i];
+        }
+    }
+    ladder.resize(aggregatedLevels);
+
+    for (PriceLevel& level : ladder)
+    {
+        cumulativeAmount += level.amount;
+        level.cumulativeAmount = cumulativeAmount;
+    }
+}
+
+/** Build the cache key of a product at a timestamp
+ *
+ *  @param product   Product name
+ *  @param timestamp Timestamp of the ladders
+ *  @return          key unique to the product and timestamp
+ *
+ */
+std::string DepthEngine::makeCacheKey(const std::string& product, const std::string& timestamp)
+{
+    return product + '|' + timestamp;
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "StocksDataBookEntry.h"
+#include "StocksDataBook.h"
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+
+/** Structure is used to describe one aggregated price level of a ladder */
+struct PriceLevel
+{
+    // Price of the level, the amount offered at it, and the amount offered at this level or better
+    double price;
+    double amount;
+    double cumulativeAmount;
+
+    // Number of SDBEs aggregated into the level
+    unsigned int entries;
+};
+
+/** Structure is used to hold both sides of the book for one product at one timestamp */
+struct DepthLadders
+{
+    // Bids sorted by descending price, asks sorted by ascending price
+    std::vector<PriceLevel> bids;
+    std::vector<PriceLevel> asks;
+};
+
+/** Structure is used to return the cost of filling an amount against one side of the book */
+struct PriceImpact
+{
+    double requestedAmount;
+    double filledAmount;
+
+    // Best price on the side, volume-weighted fill price and the last price touched
+    double bestPrice;
+    double averagePrice;
+    double worstPrice;
+
+    // Distance of the average fill price from the best price, in basis points
+    double impactBasisPoints;
+    std::size_t levelsTouched;
+};
+
+class DepthEngine
+{
+public:
+    /** Initialize a depth engine over a StocksDataBook */
+    DepthEngine(const StocksDataBook& _stocksDataBook);
+
+    /** Return the level-aggregated bid and ask ladders of a product at a timestamp, building them on first use */
+    const DepthLadders& getLadders(const std::string& product, const std::string& timestamp);
+
+    /** Compute the price impact of filling an amount against the asks (buying) or bids (selling) */
+    PriceImpact computePriceImpact(const std::string& product, const std::string& timestamp, StocksDataBookType side, double amount);
+
+    /** Discard all cached ladders */
+    void clearCache();
+
+private:
+    /** Build the ladders of every product at a timestamp in a single pass over its SDBEs */
+    void buildLadders(const std::string& timestamp);
+
+    /** Sort and aggregate raw SDBE prices into a ladder with cumulative amounts */
+    static void aggregateLevels(std::vector<PriceLevel>& ladder, bool descending);
+
+    /** Build the cache key of a product at a timestamp */
+    static std::string makeCacheKey(const std::string& product, const std::string& timestamp);
+
+    /** Dataset from which ladders are built */
+    const StocksDataBook& stocksDataBook;
+
+    /** Ladders built so far, keyed by product and timestamp */
+    std::unordered_map<std::string, DepthLadders> ladderCache;
+
+    /** Timestamps whose ladders have been built for every product */
+    std::unordered_set<std::string> builtTimeStamps;
+
+    /** Empty ladders returned for products without SDBEs at a timestamp */
+    DepthLadders emptyLadders;
+};
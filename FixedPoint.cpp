@@ -0,0 +1,167 @@
+#include "FixedPoint.h"
+#include <cmath>
+
+namespace
+{
+    /** Powers of ten up to 10^18, exact both as 64-bit integers and, up to 10^22, as doubles */
+    constexpr std::int64_t powersOfTen[FixedPoint::maxDecimals + 1] = {
+        1LL,
+        10LL,
+        100LL,
+        1000LL,
+        10000LL,
+        100000LL,
+        1000000LL,
+        10000000LL,
+        100000000LL,
+        1000000000LL,
+        10000000000LL,
+        100000000000LL,
+        1000000000000LL,
+        10000000000000LL,
+        100000000000000LL,
+        1000000000000000LL,
+        10000000000000000LL,
+        100000000000000000LL,
+        1000000000000000000LL
+    };
+}
+
+/** Parse a plain decimal "digits[.digits]" straight into a count of units of 10^-decimals, ignoring surrounding spaces
+ *
+ *  The number of decimals is the number of digits written after the point, so "0.10" is 10 units of 10^-2.
+ *  Signs, exponents and counts beyond maxUnits are not parsed, so that the caller can fall back on
+ *  floating-point parsing for them
+ *
+ *  @param field    Characters of the field
+ *  @param units    Receives the count of units
+ *  @param decimals Receives the number of decimals
+ *  @return         true if the whole field is a plain decimal within range, false otherwise
+ *
+ */
+bool FixedPoint::parse(std::string_view field, std::int64_t& units, std::uint8_t& decimals)
+{
+    while (!field.empty() && (field.front() == ' ' || field.front() == '\t'))
+    {
+        field.remove_prefix(1);
+    }
+    while (!field.empty() && (field.back() == ' ' || field.back() == '\t'))
+    {
+        field.remove_suffix(1);
+    }
+
+    std::size_t point = field.find('.');
+    std::size_t integerDigits = point == std::string_view::npos ? field.size() : point;
+    std::size_t fractionDigits = point == std::string_view::npos ? 0 : field.size() - point - 1;
+
+    // Digits are required on both sides of a point
+    if (integerDigits == 0 || (point != std::string_view::npos && fractionDigits == 0) || fractionDigits > maxDecimals)
+    {
+        return false;
+    }
+
+    std::int64_t value = 0;
+    for (std::size_t i = 0; i < field.size(); ++i)
+    {
+        if (i == point)
+        {
+            continue;
+        }
+        unsigned digit = static_cast<unsigned>(field[i] - '0');
+        if (digit > 9 || value > (maxUnits - static_cast<std::int64_t>(digit)) / 10)
+        {
+            return false;
+        }
+        value = value * 10 + static_cast<std::int64_t>(digit);
+    }
+
+    units = value;
+    decimals = static_cast<std::uint8_t>(fractionDigits);
+    return true;
+}
+
+/** Convert a count of units of 10^-decimals into the nearest double
+ *
+ *  Both operands are exact doubles, so the single rounding of the division gives the same double as parsing the
+ *  decimal text
+ *
+ *  @param units    Count of units, at most maxUnits
+ *  @param decimals Number of decimals of the units
+ *  @return         value of the units
+ *
+ */
+double FixedPoint::toDouble(std::int64_t units, std::uint8_t decimals)
+{
+    return static_cast<double>(units) / static_cast<double>(powersOfTen[decimals]);
+}
+
+/** Recover the count of units of 10^-decimals that toDouble() converted into a double
+ *
+ *  The double is within a relative 2^-53 of the units, so for counts up to maxUnits it is within a quarter of a unit
+ *  of the count once scaled, and rounds back to it exactly
+ *
+ *  @param value    Double returned by toDouble()
+ *  @param decimals Number of decimals the double was converted from
+ *  @return         count of units
+ *
+ */
+std::int64_t FixedPoint::fromDouble(double value, std::uint8_t decimals)
+{
+    return std::llround(static_cast<long double>(value) * static_cast<long double>(powersOfTen[decimals]));
+}
+
+/** Convert a count of units of 10^-decimals, divided by a number of rows, into a double
+ *
+ *  @param units    Count of units, such as a sum of prices
+ *  @param decimals Number of decimals of the units
+ *  @param divisor  Number of rows the units are shared between
+ *  @return         value of the units per row, or 0 if there are no rows
+ *
+ */
+double FixedPoint::toDouble(std::int64_t units, std::uint8_t decimals, std::size_t divisor)
+{
+    if (divisor == 0)
+    {
+        return 0;
+    }
+
+    // Extended precision keeps sums beyond 2^53 exact until the division
+    long double value = static_cast<long double>(units) / (static_cast<long double>(divisor) * static_cast<long double>(powersOfTen[decimals]));
+    return static_cast<double>(value);
+}
+
+/** Express a count of units of 10^-fromDecimals in the finer units of 10^-toDecimals
+ *
+ *  @param units        Count of units of 10^-fromDecimals
+ *  @param fromDecimals Number of decimals of the units
+ *  @param toDecimals   Number of decimals to express the units in, no fewer than fromDecimals
+ *  @param scaled       Receives the count of units of 10^-toDecimals
+ *  @return             true if the count is within maxUnits, false otherwise
+ *
+ */
+bool FixedPoint::rescale(std::int64_t units, std::uint8_t fromDecimals, std::uint8_t toDecimals, std::int64_t& scaled)
+{
+    if (toDecimals < fromDecimals || toDecimals > maxDecimals)
+    {
+        return false;
+    }
+
+    std::int64_t factor = powersOfTen[toDecimals - fromDecimals];
+    if (units > maxUnits / factor)
+    {
+        return false;
+    }
+    scaled = units * factor;
+    return true;
+}
+
+/** Return 10 raised to a number of decimals
+ *
+ *  @param decimals Exponent, at most maxDecimals
+ *  @return         power of ten
+ *
+ */
+std::int64_t FixedPoint::pow10(std::uint8_t decimals)
+{
+    return powersOfTen[decimals];
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+class FixedPoint
+{
+public:
+    /** Parse a plain decimal "digits[.digits]" straight into a count of units of 10^-decimals, ignoring surrounding spaces */
+    static bool parse(std::string_view field, std::int64_t& units, std::uint8_t& decimals);
+
+    /** Convert a count of units of 10^-decimals into the nearest double */
+    static double toDouble(std::int64_t units, std::uint8_t decimals);
+
+    /** Recover the count of units of 10^-decimals that toDouble() converted into a double */
+    static std::int64_t fromDouble(double value, std::uint8_t decimals);
+
+    /** Convert a count of units of 10^-decimals, divided by a number of rows, into a double */
+    static double toDouble(std::int64_t units, std::uint8_t decimals, std::size_t divisor);
+
+    /** Express a count of units of 10^-fromDecimals in the finer units of 10^-toDecimals */
+    static bool rescale(std::int64_t units, std::uint8_t fromDecimals, std::uint8_t toDecimals, std::int64_t& scaled);
+
+    /** Return 10 raised to a number of decimals */
+    static std::int64_t pow10(std::uint8_t decimals);
+
+    /** Marks a number that was not parsed into units */
+    static constexpr std::uint8_t noDecimals = 0xff;
+
+    /** Largest number of decimals held, as 10^18 is the largest power of ten in 64 bits */
+    static constexpr std::uint8_t maxDecimals = 18;
+
+    /** Largest count of units held, so that every count converts to a double and back exactly */
+    static constexpr std::int64_t maxUnits = std::int64_t{ 1 } << 51;
+};
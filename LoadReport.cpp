@@ -0,0 +1,235 @@
+#include "LoadReport.h"
+#include "AllocationCounter.h"
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+/** Initialize an empty load report */
+LoadReport::LoadReport() = default;
+
+/** Record a rejected CSV line against its reason
+ *
+ *  @param reason Reason for which the line was rejected
+ *
+ */
+void LoadReport::recordRejectedRow(CSVRejectReason reason)
+{
+    ++rowsRejected[static_cast<std::size_t>(reason)];
+}
+
+/** Add the counters of the load of another file, so that one report describes a multi-file load
+ *
+ *  Phase times are summed across files, so with files loaded concurrently they measure work rather than elapsed time
+ *
+ *  @param other Report of the load of another file
+ *
+ */
+void LoadReport::merge(const LoadReport& other)
+{
+    filename += filename.empty() ? other.filename : ", " + other.filename;
+    bytesRead += other.bytesRead;
+    linesRead += other.linesRead;
+    rowsParsed += other.rowsParsed;
+    for (std::size_t reason = 0; reason < static_cast<std::size_t>(CSVRejectReason::count); ++reason)
+    {
+        rowsRejected[reason] += other.rowsRejected[reason];
+    }
+
+    phaseTimes.readSeconds += other.phaseTimes.readSeconds;
+    phaseTimes.tokenizeSeconds += other.phaseTimes.tokenizeSeconds;
+    phaseTimes.convertSeconds += other.phaseTimes.convertSeconds;
+    phaseTimes.rejectSeconds += other.phaseTimes.rejectSeconds;
+    phaseTimes.storeSeconds += other.phaseTimes.storeSeconds;
+    phaseTimes.sortSeconds += other.phaseTimes.sortSeconds;
+    phaseTimes.totalSeconds += other.phaseTimes.totalSeconds;
+    sortedRuns += other.sortedRuns;
+
+    reservedCapacity += other.reservedCapacity;
+    finalCapacity += other.finalCapacity;
+    storageReallocations += other.storageReallocations;
+    peakResidentKilobytes = std::max(peakResidentKilobytes, other.peakResidentKilobytes);
+    allocations += other.allocations;
+    allocatedBytes += other.allocatedBytes;
+}
+
+/** Return the total number of rejected CSV lines across all reasons
+ *
+ *  @return sum of the per-reason reject counters
+ *
+ */
+std::size_t LoadReport::getRowsRejected() const
+{
+    std::size_t total = 0;
+    for (std::size_t rejected : rowsRejected)
+    {
+        total += rejected;
+    }
+    return total;
+}
+
+/** Capture process-wide memory statistics at the end of the load
+ *
+ *  @param allocationsAtStart    Allocation count sampled before the load began
+ *  @param allocatedBytesAtStart Allocated bytes sampled before the load began
+ *
+ */
+void LoadReport::captureMemoryStatistics(std::size_t allocationsAtStart, std::size_t allocatedBytesAtStart)
+{
+    // Heap activity attributable to the load
+    allocations = AllocationCounter::getAllocationCount() - allocationsAtStart;
+    allocatedBytes = AllocationCounter::getAllocatedBytes() - allocatedBytesAtStart;
+
+#if defined(__unix__) || defined(__APPLE__)
+    // Peak resident set size of the process
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0)
+    {
+#if defined(__APPLE__)
+        // macOS reports the peak in bytes
+        peakResidentKilobytes = usage.ru_maxrss / 1024;
+#else
+        peakResidentKilobytes = usage.ru_maxrss;
+#endif
+    }
+#endif
+}
+
+/** Print the load report in a human-readable form
+ *
+ *  @param outputStream Stream on which the report is printed
+ *
+ */
+void LoadReport::print(std::ostream& outputStream) const
+{
+    outputStream << "======================================================================" << std::endl;
+    outputStream << "Load report for " << filename << std::endl;
+    outputStream << "======================================================================" << std::endl;
+    outputStream << "Bytes read:                " << bytesRead << std::endl;
+    outputStream << "Lines read:                " << linesRead << std::endl;
+    outputStream << "Rows parsed:               " << rowsParsed << std::endl;
+    outputStream << "Rows rejected:             " << getRowsRejected() << std::endl;
+
+    // Break the rejected rows down by reason
+    for (std::size_t reason = 0; reason < static_cast<std::size_t>(CSVRejectReason::count); ++reason)
+    {
+        outputStream << "  " << std::left << std::setw(24) << rejectReasonToString(static_cast<CSVRejectReason>(reason))
+                     << std::right << rowsRejected[reason] << std::endl;
+    }
+
+    outputStream << "Phase times (seconds):" << std::endl;
+    outputStream << "  read                    " << phaseTimes.readSeconds << std::endl;
+    outputStream << "  tokenize                " << phaseTimes.tokenizeSeconds << std::endl;
+    outputStream << "  convert                 " << phaseTimes.convertSeconds << std::endl;
+    outputStream << "  reject handling         " << phaseTimes.rejectSeconds << std::endl;
+    outputStream << "  store                   " << phaseTimes.storeSeconds << std::endl;
+    outputStream << "  sort                    " << phaseTimes.sortSeconds << std::endl;
+    outputStream << "  total                   " << phaseTimes.totalSeconds << std::endl;
+    outputStream << "Sorted runs in input:      " << sortedRuns << " (" << sortStrategy << ")" << std::endl;
+    outputStream << "Storage reserved/final:    " << reservedCapacity << " / " << finalCapacity
+                 << " (" << storageReallocations << " reallocation(s))" << std::endl;
+    outputStream << "Peak RSS (KiB):            " << peakResidentKilobytes << std::endl;
+    outputStream << "Heap allocations:          " << allocations << " (" << allocatedBytes << " bytes)" << std::endl;
+    outputStream << "======================================================================" << std::endl;
+}
+
+/** Serialize the load report to JSON
+ *
+ *  @return JSON object describing the load
+ *
+ */
+std::string LoadReport::toJSON() const
+{
+    std::ostringstream json;
+
+    // Escape the characters of the filename that are significant in JSON
+    std::string escapedFilename;
+    for (char character : filename)
+    {
+        if (character == '"' || character == '\\')
+        {
+            escapedFilename += '\\';
+        }
+        escapedFilename += character;
+    }
+
+    json << "{\n";
+    json << "  \"filename\": \"" << escapedFilename << "\",\n";
+    json << "  \"bytes_read\": " << bytesRead << ",\n";
+    json << "  \"lines_read\": " << linesRead << ",\n";
+    json << "  \"rows_parsed\": " << rowsParsed << ",\n";
+    json << "  \"rows_rejected\": {\n";
+    json << "    \"total\": " << getRowsRejected();
+    for (std::size_t reason = 0; reason < static_cast<std::size_t>(CSVRejectReason::count); ++reason)
+    {
+        json << ",\n    \"" << rejectReasonToString(static_cast<CSVRejectReason>(reason)) << "\": " << rowsRejected[reason];
+    }
+    json << "\n  },\n";
+    json << "  \"phase_seconds\": {\n";
+    json << "    \"read\": " << phaseTimes.readSeconds << ",\n";
+    json << "    \"tokenize\": " << phaseTimes.tokenizeSeconds << ",\n";
+    json << "    \"convert\": " << phaseTimes.convertSeconds << ",\n";
+    json << "    \"reject\": " << phaseTimes.rejectSeconds << ",\n";
+    json << "    \"store\": " << phaseTimes.storeSeconds << ",\n";
+    json << "    \"sort\": " << phaseTimes.sortSeconds << ",\n";
+    json << "    \"total\": " << phaseTimes.totalSeconds << "\n";
+    json << "  },\n";
+    json << "  \"sorted_runs\": " << sortedRuns << ",\n";
+    json << "  \"sort_strategy\": \"" << sortStrategy << "\",\n";
+    json << "  \"storage\": {\n";
+    json << "    \"reserved_capacity\": " << reservedCapacity << ",\n";
+    json << "    \"final_capacity\": " << finalCapacity << ",\n";
+    json << "    \"reallocations\": " << storageReallocations << "\n";
+    json << "  },\n";
+    json << "  \"peak_rss_kib\": " << peakResidentKilobytes << ",\n";
+    json << "  \"allocations\": " << allocations << ",\n";
+    json << "  \"allocated_bytes\": " << allocatedBytes << "\n";
+    json << "}\n";
+    return json.str();
+}
+
+/** Write the load report as JSON to the file provided
+ *
+ *  @param jsonFilename Name of the JSON file to be written
+ *  @return             true if the report was written, false otherwise
+ *
+ */
+bool LoadReport::writeJSON(const std::string& jsonFilename) const
+{
+    std::ofstream jsonFile{ jsonFilename };
+    if (!jsonFile.is_open())
+    {
+        return false;
+    }
+    jsonFile << toJSON();
+    return static_cast<bool>(jsonFile);
+}
+
+/** Convert a reject reason to a printable string
+ *
+ *  @param reason Reason for which a CSV line was rejected
+ *  @return       name of the reason
+ *
+ */
+const char* LoadReport::rejectReasonToString(CSVRejectReason reason)
+{
+    switch (reason)
+    {
+    case CSVRejectReason::wrongFieldCount:
+        return "wrong_field_count";
+    case CSVRejectReason::invalidNumber:
+        return "invalid_number";
+    case CSVRejectReason::invalidTimestamp:
+        return "invalid_timestamp";
+    case CSVRejectReason::emptyProduct:
+        return "empty_product";
+    case CSVRejectReason::unknownType:
+        return "unknown_type";
+    default:
+        return "unknown";
+    }
+}
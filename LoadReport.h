@@ -0,0 +1,90 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+#include <ostream>
+
+/** Establish reasons for which a CSV line is rejected during ingest, count standing for a valid line */
+enum class CSVRejectReason
+{
+    wrongFieldCount,
+    invalidNumber,
+    invalidTimestamp,
+    emptyProduct,
+    unknownType,
+    count
+};
+
+/** Structure is used to accumulate the time spent in each phase of loading a CSV file */
+struct LoadPhaseTimes
+{
+    // Seconds spent in each phase of the load
+    double readSeconds = 0;
+    double tokenizeSeconds = 0;
+    double convertSeconds = 0;
+    double rejectSeconds = 0;
+    double storeSeconds = 0;
+    double sortSeconds = 0;
+    double totalSeconds = 0;
+};
+
+class LoadReport
+{
+public:
+    /** Initialize an empty load report */
+    LoadReport();
+
+    /** Record a rejected CSV line against its reason */
+    void recordRejectedRow(CSVRejectReason reason);
+
+    /** Return the total number of rejected CSV lines across all reasons */
+    std::size_t getRowsRejected() const;
+
+    /** Add the counters of the load of another file, so that one report describes a multi-file load */
+    void merge(const LoadReport& other);
+
+    /** Capture process-wide memory statistics at the end of the load */
+    void captureMemoryStatistics(std::size_t allocationsAtStart, std::size_t allocatedBytesAtStart);
+
+    /** Print the load report in a human-readable form */
+    void print(std::ostream& outputStream) const;
+
+    /** Serialize the load report to JSON */
+    std::string toJSON() const;
+
+    /** Write the load report as JSON to the file provided */
+    bool writeJSON(const std::string& jsonFilename) const;
+
+    /** Convert a reject reason to a printable string */
+    static const char* rejectReasonToString(CSVRejectReason reason);
+
+    // Source file of the load
+    std::string filename;
+
+    // Input volume
+    std::size_t bytesRead = 0;
+    std::size_t linesRead = 0;
+
+    // Accepted rows
+    std::size_t rowsParsed = 0;
+
+    // Rejected rows indexed by CSVRejectReason
+    std::size_t rowsRejected[static_cast<std::size_t>(CSVRejectReason::count)] = {};
+
+    // Time spent per phase
+    LoadPhaseTimes phaseTimes;
+
+    // Number of sorted runs found in the input (1 if it was already in order) and how it was put in order
+    std::size_t sortedRuns = 0;
+    std::string sortStrategy = "none";
+
+    // Growth of the SDBE storage beyond its reserved capacity
+    std::size_t reservedCapacity = 0;
+    std::size_t finalCapacity = 0;
+    std::size_t storageReallocations = 0;
+
+    // Memory statistics (peak resident set size is process-wide)
+    long peakResidentKilobytes = 0;
+    std::size_t allocations = 0;
+    std::size_t allocatedBytes = 0;
+};
@@ -0,0 +1,84 @@
+#include "NumaTopology.h"
+#ifdef ADVISORBOT_HAVE_NUMA
+#include <numa.h>
+#endif
+
+/** Return true if memory and threads can be placed on NUMA nodes
+ *
+ *  @return true if the build has libnuma and the kernel supports NUMA placement
+ *
+ */
+bool NumaTopology::isAvailable()
+{
+#ifdef ADVISORBOT_HAVE_NUMA
+    static const bool available = numa_available() >= 0;
+    return available;
+#else
+    return false;
+#endif
+}
+
+/** Return the NUMA nodes this process may run on, a single node 0 when placement is unavailable
+ *
+ *  @return node numbers in ascending order
+ *
+ */
+const std::vector<int>& NumaTopology::getNodes()
+{
+    static const std::vector<int> nodes = []()
+    {
+        std::vector<int> allowedNodes;
+#ifdef ADVISORBOT_HAVE_NUMA
+        if (isAvailable())
+        {
+            for (int node = 0; node <= numa_max_node(); ++node)
+            {
+                if (numa_bitmask_isbitset(numa_all_nodes_ptr, node))
+                {
+                    allowedNodes.push_back(node);
+                }
+            }
+        }
+#endif
+        if (allowedNodes.empty())
+        {
+            allowedNodes.push_back(0);
+        }
+        return allowedNodes;
+    }();
+    return nodes;
+}
+
+/** Run the calling thread on a NUMA node and allocate its memory there until the binding goes out of scope
+ *
+ *  Memory first touched by the thread meanwhile is placed on the node. Without NUMA placement this does nothing
+ *
+ *  @param node NUMA node, as returned by NumaTopology::getNodes()
+ *
+ */
+NumaNodeBinding::NumaNodeBinding(int node)
+{
+#ifdef ADVISORBOT_HAVE_NUMA
+    if (NumaTopology::isAvailable() && NumaTopology::getNodes().size() > 1)
+    {
+        previousNodes = numa_get_run_node_mask();
+        numa_run_on_node(node);
+        numa_set_preferred(node);
+    }
+#else
+    (void)node;
+#endif
+}
+
+/** Restore the nodes and memory policy the thread had before */
+NumaNodeBinding::~NumaNodeBinding()
+{
+#ifdef ADVISORBOT_HAVE_NUMA
+    if (previousNodes != nullptr)
+    {
+        numa_run_on_node_mask(previousNodes);
+        numa_bitmask_free(previousNodes);
+        numa_set_localalloc();
+    }
+#endif
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <vector>
+
+class NumaTopology
+{
+public:
+    /** Return true if memory and threads can be placed on NUMA nodes */
+    static bool isAvailable();
+
+    /** Return the NUMA nodes this process may run on, a single node 0 when placement is unavailable */
+    static const std::vector<int>& getNodes();
+};
+
+class NumaNodeBinding
+{
+public:
+    /** Run the calling thread on a NUMA node and allocate its memory there until the binding goes out of scope */
+    NumaNodeBinding(int node);
+
+    /** Restore the nodes and memory policy the thread had before */
+    ~NumaNodeBinding();
+
+    NumaNodeBinding(const NumaNodeBinding&) = delete;
+    NumaNodeBinding& operator=(const NumaNodeBinding&) = delete;
+
+private:
+    /** Nodes the thread could run on before, or null if the thread was not bound */
+    struct bitmask* previousNodes = nullptr;
+};
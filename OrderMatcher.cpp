@@ -0,0 +1,153 @@
+#include "OrderMatcher.h"
+#include <algorithm>
+
+namespace
+{
+    // Amounts left after repeated floating-point subtractions are taken as zero within this fraction of the amount
+    const double relativeTolerance = 1e-9;
+}
+
+/** Initialize an order matcher with no ladders to fill against until setDepthEngine() is called */
+OrderMatcher::OrderMatcher()
+    : depthEngine(nullptr)
+{
+}
+
+/** Initialize an order matcher filling against the ladders of a depth engine
+ *
+ *  @param _depthEngine Depth engine providing the price-sorted ladders
+ *
+ */
+OrderMatcher::OrderMatcher(DepthEngine& _depthEngine)
+    : depthEngine(&_depthEngine)
+{
+}
+
+/** Fill later orders against the ladders of another depth engine, keeping the liquidity consumed so far
+ *
+ *  Each version of the dataset has its own depth engine, while fills belong to the simulation
+ *
+ *  @param _depthEngine Depth engine providing the price-sorted ladders
+ *
+ */
+void OrderMatcher::setDepthEngine(DepthEngine& _depthEngine)
+{
+    depthEngine = &_depthEngine;
+}
+
+/** Match a simulated bid (buy) or ask (sell) against the opposite side of the book, up to a limit price
+ *
+ *  Bids fill against the asks from the lowest price upwards and asks fill against the bids from the highest
+ *  price downwards, each level at its own price. Liquidity taken by a fill is not available to later orders
+ *  at the same timestamp, so a fill costs O(levels touched). Remainders within a small fraction of the order
+ *  or level amount are rounding errors of the subtractions, and count as filled or exhausted
+ *
+ *  @param product    Product name
+ *  @param timestamp  Timestamp of the book to be matched against
+ *  @param orderType  bid to buy the base currency, ask to sell it
+ *  @param amount     Base currency amount of the order
+ *  @param limitPrice Highest price paid by a bid, or lowest price accepted by an ask
+ *  @return           filled amount, exchanged quote amount and the fill at each level touched
+ *
+ */
+OrderFill OrderMatcher::matchOrder(const std::string& product, const std::string& timestamp, StocksDataBookType orderType, double amount, double limitPrice)
+{
+    OrderFill orderFill{ amount, 0, 0, 0, {} };
+
+    LadderPosition* position = nullptr;
+    const std::vector<PriceLevel>& ladder = getOppositeLadder(product, timestamp, orderType, position);
+
+    // Walk the ladder from the first level with liquidity left until the order is filled or the limit is reached
+    double tolerance = amount * relativeTolerance;
+    while (amount - orderFill.filledAmount > tolerance && position->level < ladder.size()
+        && isWithinLimit(orderType, ladder[position->level].price, limitPrice))
+    {
+        const PriceLevel& level = ladder[position->level];
+        double fill = std::min(level.amount - position->consumedAmount, amount - orderFill.filledAmount);
+        orderFill.filledAmount += fill;
+        orderFill.quoteAmount += fill * level.price;
+        orderFill.levelFills.push_back(LevelFill{ level.price, fill });
+
+        // Move to the next level once this one is exhausted
+        position->consumedAmount += fill;
+        if (level.amount - position->consumedAmount <= level.amount * relativeTolerance)
+        {
+            ++position->level;
+            position->consumedAmount = 0;
+        }
+    }
+
+    // Report an order filled but for rounding errors as filled in full
+    if (amount - orderFill.filledAmount <= tolerance)
+    {
+        orderFill.filledAmount = amount;
+    }
+
+    if (orderFill.filledAmount > 0)
+    {
+        orderFill.averagePrice = orderFill.quoteAmount / orderFill.filledAmount;
+    }
+    return orderFill;
+}
+
+/** Return the amount still available at or better than a limit price, after earlier fills
+ *
+ *  @param product    Product name
+ *  @param timestamp  Timestamp of the book
+ *  @param orderType  bid to buy the base currency, ask to sell it
+ *  @param limitPrice Highest price paid by a bid, or lowest price accepted by an ask
+ *  @return           base currency amount that an order could fill
+ *
+ */
+double OrderMatcher::getAvailableAmount(const std::string& product, const std::string& timestamp, StocksDataBookType orderType, double limitPrice)
+{
+    LadderPosition* position = nullptr;
+    const std::vector<PriceLevel>& ladder = getOppositeLadder(product, timestamp, orderType, position);
+
+    double available = 0;
+    for (std::size_t i = position->level; i < ladder.size() && isWithinLimit(orderType, ladder[i].price, limitPrice); ++i)
+    {
+        available += ladder[i].amount - (i == position->level ? position->consumedAmount : 0);
+    }
+    return available;
+}
+
+/** Forget the liquidity consumed by earlier fills */
+void OrderMatcher::clearConsumedLiquidity()
+{
+    ladderPositions.clear();
+}
+
+/** Return the ladder an order of a type fills against, and the position of earlier fills within it
+ *
+ *  The simulation only trades at its current time, which moves forward, so the positions of earlier timestamps
+ *  are dropped rather than kept for the whole session
+ *
+ *  @param product   Product name
+ *  @param timestamp Timestamp of the book
+ *  @param orderType bid to buy the base currency, ask to sell it
+ *  @param position  Receives the position of earlier fills within the returned ladder
+ *  @return          asks for a bid, bids for an ask
+ *
+ */
+const std::vector<PriceLevel>& OrderMatcher::getOppositeLadder(const std::string& product, const std::string& timestamp, StocksDataBookType orderType, LadderPosition*& position)
+{
+    const DepthLadders& ladders = depthEngine->getLadders(product, timestamp);
+    bool fillsAgainstAsks = orderType == StocksDataBookType::bid;
+    ladderPositions.erase(ladderPositions.begin(), ladderPositions.lower_bound(timestamp));
+    position = &ladderPositions[timestamp][product + (fillsAgainstAsks ? "|ask" : "|bid")];
+    return fillsAgainstAsks ? ladders.asks : ladders.bids;
+}
+
+/** Determine whether a level's price satisfies an order's limit price
+ *
+ *  @param orderType  bid to buy the base currency, ask to sell it
+ *  @param levelPrice Price of the level
+ *  @param limitPrice Highest price paid by a bid, or lowest price accepted by an ask
+ *  @return           true if the level may be filled, false otherwise
+ *
+ */
+bool OrderMatcher::isWithinLimit(StocksDataBookType orderType, double levelPrice, double limitPrice)
+{
+    return orderType == StocksDataBookType::bid ? levelPrice <= limitPrice : levelPrice >= limitPrice;
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "StocksDataBookEntry.h"
+#include "DepthEngine.h"
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+/** Structure is used to record the part of an order filled at one price level */
+struct LevelFill
+{
+    double price;
+    double amount;
+};
+
+/** Structure is used to return the outcome of matching an order against the book */
+struct OrderFill
+{
+    double requestedAmount;
+    double filledAmount;
+
+    // Quote currency exchanged, and the volume-weighted price of the fill
+    double quoteAmount;
+    double averagePrice;
+
+    std::vector<LevelFill> levelFills;
+};
+
+class OrderMatcher
+{
+public:
+    /** Initialize an order matcher with no ladders to fill against until setDepthEngine() is called */
+    OrderMatcher();
+
+    /** Initialize an order matcher filling against the ladders of a depth engine */
+    OrderMatcher(DepthEngine& _depthEngine);
+
+    /** Fill later orders against the ladders of another depth engine, keeping the liquidity consumed so far */
+    void setDepthEngine(DepthEngine& _depthEngine);
+
+    /** Match a simulated bid (buy) or ask (sell) against the opposite side of the book, up to a limit price */
+    OrderFill matchOrder(const std::string& product, const std::string& timestamp, StocksDataBookType orderType, double amount, double limitPrice);
+
+    /** Return the amount still available at or better than a limit price, after earlier fills */
+    double getAvailableAmount(const std::string& product, const std::string& timestamp, StocksDataBookType orderType, double limitPrice);
+
+    /** Forget the liquidity consumed by earlier fills */
+    void clearConsumedLiquidity();
+
+private:
+    /** Structure is used to track how far into a ladder earlier fills have reached */
+    struct LadderPosition
+    {
+        // First level with liquidity left, and the amount already taken from it
+        std::size_t level = 0;
+        double consumedAmount = 0;
+    };
+
+    /** Return the ladder an order of a type fills against, and the position of earlier fills within it */
+    const std::vector<PriceLevel>& getOppositeLadder(const std::string& product, const std::string& timestamp, StocksDataBookType orderType, LadderPosition*& position);
+
+    /** Determine whether a level's price satisfies an order's limit price */
+    static bool isWithinLimit(StocksDataBookType orderType, double levelPrice, double limitPrice);
+
+    /** Depth engine providing the price-sorted ladders */
+    DepthEngine* depthEngine;
+
+    /** Position of earlier fills, keyed by timestamp in time order, then by product and ladder side */
+    std::map<std::string, std::unordered_map<std::string, LadderPosition>> ladderPositions;
+};
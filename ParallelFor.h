@@ -0,0 +1,88 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ParallelFor
+{
+public:
+    /** Return the number of worker threads used by run(), at least one */
+    static unsigned getThreadCount()
+    {
+        unsigned hardwareThreads = std::thread::hardware_concurrency();
+        return hardwareThreads == 0 ? 1 : hardwareThreads;
+    }
+
+    /** Call function(i) for every i in [0, count), handing out indices to worker threads one at a time
+     *
+     *  Indices are claimed dynamically so that items of uneven cost balance across threads. The first
+     *  exception thrown by any call is rethrown on the calling thread once every worker has finished
+     *
+     *  @param count    Number of items
+     *  @param function Callable taking the index of an item
+     *
+     */
+    template <typename Function>
+    static void run(std::size_t count, Function function)
+    {
+        std::size_t numThreads = std::min<std::size_t>(getThreadCount(), count);
+
+        // Avoid thread creation when there is nothing to share
+        if (numThreads <= 1)
+        {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                function(i);
+            }
+            return;
+        }
+
+        std::atomic<std::size_t> nextIndex{ 0 };
+        std::exception_ptr firstException;
+        std::mutex exceptionMutex;
+
+        auto worker = [&]()
+        {
+            try
+            {
+                for (std::size_t i = nextIndex++; i < count; i = nextIndex++)
+                {
+                    function(i);
+                }
+            }
+            catch (...)
+            {
+                // Record the first failure and stop handing out work
+                std::lock_guard<std::mutex> lock(exceptionMutex);
+                if (!firstException)
+                {
+                    firstException = std::current_exception();
+                }
+                nextIndex = count;
+            }
+        };
+
+        // The calling thread works alongside the spawned threads
+        std::vector<std::thread> threads;
+        threads.reserve(numThreads - 1);
+        for (std::size_t t = 1; t < numThreads; ++t)
+        {
+            threads.emplace_back(worker);
+        }
+        worker();
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+
+        if (firstException)
+        {
+            std::rethrow_exception(firstException);
+        }
+    }
+};
@@ -0,0 +1,137 @@
+#include "ParameterSweep.h"
+#include "ParallelFor.h"
+#include <cmath>
+
+/** Return the EWMA spans evaluated by default
+ *
+ *  @return every span from 2 to 50 time steps
+ *
+ */
+std::vector<std::size_t> ParameterSweep::getDefaultSpans()
+{
+    std::vector<std::size_t> spans;
+    for (std::size_t span = 2; span <= 50; ++span)
+    {
+        spans.push_back(span);
+    }
+    return spans;
+}
+
+/** Return the strategy thresholds evaluated by default
+ *
+ *  @return fractional thresholds from 0 to 50 basis points
+ *
+ */
+std::vector<double> ParameterSweep::getDefaultThresholds()
+{
+    return { 0, 0.00005, 0.0001, 0.0002, 0.0005, 0.001, 0.002, 0.005 };
+}
+
+/** Evaluate the next time step prediction error of every span on every product, in parallel
+ *
+ *  The max or min price of each time step is taken from the per time step aggregates, matching computeMax()
+ *  and computeMin(). Time steps in which the side has no SDBEs are skipped
+ *
+ *  @param stocksDataBook  Dataset to be evaluated
+ *  @param products        Product names
+ *  @param side            SDBE type - ask/bid
+ *  @param predictMaxPrice true to predict the max price of each time step, false to predict the min price
+ *  @param spans           EWMA spans to be evaluated
+ *  @return                one entry per product and span, ordered by product then span
+ *
+ */
+std::vector<SpanError> ParameterSweep::sweepPredictionSpans(const StocksDataBook& stocksDataBook, const std::vector<std::string>& products,
+    StocksDataBookType side, bool predictMaxPrice, const std::vector<std::size_t>& spans)
+{
+    // Extract each product's price series up front, so that every grid cell reads a contiguous series of prices
+    std::vector<std::vector<double>> priceSeries(products.size());
+    for (std::size_t p = 0; p < products.size(); ++p)
+    {
+        for (const TimeStepAggregate& aggregate : stocksDataBook.getTimeStepAggregates(products[p], side))
+        {
+            if (aggregate.entries != 0)
+            {
+                priceSeries[p].push_back(predictMaxPrice ? aggregate.maxPrice : aggregate.minPrice);
+            }
+        }
+    }
+
+    // Every grid cell only reads its series and writes its own result
+    std::vector<SpanError> spanErrors(products.size() * spans.size());
+    ParallelFor::run(spanErrors.size(), [&](std::size_t cell)
+    {
+        std::size_t p = cell / spans.size();
+        spanErrors[cell].product = products[p];
+        evaluateSpan(priceSeries[p], spans[cell % spans.size()], spanErrors[cell]);
+    });
+    return spanErrors;
+}
+
+/** Backtest the EWMA strategy for every span and threshold on every product, in parallel
+ *
+ *  @param backtester Backtester providing the market ticks of each product
+ *  @param products   Product names
+ *  @param spans      EWMA spans to be evaluated
+ *  @param thresholds Strategy thresholds to be evaluated
+ *  @return           one entry per product, span and threshold, ordered by product, span, then threshold
+ *
+ */
+std::vector<StrategyScore> ParameterSweep::sweepStrategies(Backtester& backtester, const std::vector<std::string>& products,
+    const std::vector<std::size_t>& spans, const std::vector<double>& thresholds)
+{
+    // Build the market ticks up front so that the replays only read them
+    std::vector<const std::vector<MarketTick>*> marketTicks;
+    for (const std::string& product : products)
+    {
+        marketTicks.push_back(&backtester.getMarketTicks(product));
+    }
+
+    const std::size_t cellsPerProduct = spans.size() * thresholds.size();
+    std::vector<StrategyScore> scores(products.size() * cellsPerProduct);
+    ParallelFor::run(scores.size(), [&](std::size_t cell)
+    {
+        std::size_t p = cell / cellsPerProduct;
+        std::size_t span = spans[cell % cellsPerProduct / thresholds.size()];
+        double threshold = thresholds[cell % thresholds.size()];
+
+        // Each replay owns its strategy
+        EWMAStrategy strategy{ span, threshold };
+        BacktestResult result = Backtester::replay(*marketTicks[p], strategy, 1.0);
+        scores[cell] = StrategyScore{ products[p], span, threshold, result.profitAndLoss, result.maxDrawdown, result.trades.size() };
+    });
+    return scores;
+}
+
+/** Compute the error of predicting each price by the EWMA of the prices before it
+ *
+ *  @param prices    Prices in time order
+ *  @param span      EWMA span, giving a smoothing factor of 2 / (span + 1)
+ *  @param spanError Receives the span, errors and number of predictions
+ *
+ */
+void ParameterSweep::evaluateSpan(const std::vector<double>& prices, std::size_t span, SpanError& spanError)
+{
+    spanError.span = span;
+    spanError.meanAbsoluteError = 0;
+    spanError.rootMeanSquaredError = 0;
+    spanError.predictions = prices.size() > 1 ? prices.size() - 1 : 0;
+    if (spanError.predictions == 0)
+    {
+        return;
+    }
+
+    // Seed the EWMA with the earliest price, as computeEWMA() does
+    const double smoothingFactor = 2.0 / (span + 1);
+    double EWMA = prices[0];
+    double sumAbsoluteErrors = 0;
+    double sumSquaredErrors = 0;
+    for (std::size_t i = 1; i < prices.size(); ++i)
+    {
+        double error = prices[i] - EWMA;
+        sumAbsoluteErrors += std::fabs(error);
+        sumSquaredErrors += error * error;
+        EWMA = prices[i] * smoothingFactor + (1 - smoothingFactor) * EWMA;
+    }
+    spanError.meanAbsoluteError = sumAbsoluteErrors / spanError.predictions;
+    spanError.rootMeanSquaredError = std::sqrt(sumSquaredErrors / spanError.predictions);
+}
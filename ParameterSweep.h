@@ -0,0 +1,53 @@
+#pragma once
+
+#include "StocksDataBookEntry.h"
+#include "StocksDataBook.h"
+#include "Backtester.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/** Structure is used to return the prediction error of an EWMA span on one product */
+struct SpanError
+{
+    std::string product;
+    std::size_t span;
+
+    // Errors of the predictions against the next time step's actual price, and the number of predictions
+    double meanAbsoluteError;
+    double rootMeanSquaredError;
+    std::size_t predictions;
+};
+
+/** Structure is used to return the backtest outcome of one strategy parameter combination on one product */
+struct StrategyScore
+{
+    std::string product;
+    std::size_t span;
+    double threshold;
+
+    double profitAndLoss;
+    double maxDrawdown;
+    std::size_t trades;
+};
+
+class ParameterSweep
+{
+public:
+    /** Return the EWMA spans evaluated by default */
+    static std::vector<std::size_t> getDefaultSpans();
+
+    /** Return the strategy thresholds evaluated by default */
+    static std::vector<double> getDefaultThresholds();
+
+    /** Evaluate the next time step prediction error of every span on every product, in parallel */
+    static std::vector<SpanError> sweepPredictionSpans(const StocksDataBook& stocksDataBook, const std::vector<std::string>& products,
+        StocksDataBookType side, bool predictMaxPrice, const std::vector<std::size_t>& spans);
+
+    /** Backtest the EWMA strategy for every span and threshold on every product, in parallel */
+    static std::vector<StrategyScore> sweepStrategies(Backtester& backtester, const std::vector<std::string>& products,
+        const std::vector<std::size_t>& spans, const std::vector<double>& thresholds);
+
+    /** Compute the error of predicting each price by the EWMA of the prices before it */
+    static void evaluateSpan(const std::vector<double>& prices, std::size_t span, SpanError& spanError);
+};
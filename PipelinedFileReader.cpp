@@ -0,0 +1,180 @@
+#include "PipelinedFileReader.h"
+#include <cstring>
+#include <memory>
+
+/** Open a file and start reading it ahead of the parser on a background thread
+ *
+ *  Reads bypass the C library's own buffering and land directly in aligned buffers, which the reader thread
+ *  fills in turn while the parser works through the buffers filled before
+ *
+ *  @param filename     The name of the file to be read
+ *  @param _bufferBytes Bytes read from the file at a time
+ *  @param bufferCount  Number of buffers, at least two so that reading and parsing overlap
+ *
+ */
+PipelinedFileReader::PipelinedFileReader(const std::string& filename, std::size_t _bufferBytes, std::size_t bufferCount)
+    : bufferBytes(_bufferBytes == 0 ? defaultBufferBytes : _bufferBytes),
+      buffers(bufferCount < 2 ? 2 : bufferCount)
+{
+    file = std::fopen(filename.c_str(), "rb");
+    if (file == nullptr)
+    {
+        return;
+    }
+    std::setvbuf(file, nullptr, _IONBF, 0);
+
+    // Determine the file size for callers that size their storage from it
+    if (std::fseek(file, 0, SEEK_END) == 0)
+    {
+        long size = std::ftell(file);
+        fileBytes = size > 0 ? static_cast<std::size_t>(size) : 0;
+    }
+    std::rewind(file);
+
+    // Leave room for a carried line in front of each aligned read region
+    for (Buffer& buffer : buffers)
+    {
+        buffer.storage.resize(carryBytes + bufferBytes + bufferAlignment);
+        void* readRegion = buffer.storage.data() + carryBytes;
+        std::size_t space = bufferBytes + bufferAlignment;
+        buffer.readRegion = static_cast<char*>(std::align(bufferAlignment, bufferBytes, readRegion, space));
+    }
+
+    readerThread = std::thread{ &PipelinedFileReader::readLoop, this };
+}
+
+/** Stop the reader thread and close the file */
+PipelinedFileReader::~PipelinedFileReader()
+{
+    {
+        std::lock_guard<std::mutex> lock{ mutex };
+        stopping = true;
+    }
+    bufferEmptied.notify_all();
+    if (readerThread.joinable())
+    {
+        readerThread.join();
+    }
+    if (file != nullptr)
+    {
+        std::fclose(file);
+    }
+}
+
+/** Return true if the file could be opened
+ *
+ *  @return true if the file is open
+ *
+ */
+bool PipelinedFileReader::isOpen() const
+{
+    return file != nullptr;
+}
+
+/** Return the size of the file in bytes, or 0 if it could not be opened
+ *
+ *  @return size of the file in bytes
+ *
+ */
+std::size_t PipelinedFileReader::getFileBytes() const
+{
+    return fileBytes;
+}
+
+/** Wait for the next filled buffer, prefixed with bytes carried over from the current chunk, and recycle the current buffer
+ *
+ *  The carried bytes, typically a line straddling the two buffers, are copied into the room in front of the
+ *  next buffer so that the chunk is contiguous. Carries too long for that room are joined outside the buffers
+ *
+ *  @param carriedBytes Number of bytes at the end of the current chunk to be prefixed to the next one
+ *  @return             next chunk, with last set once the end of the file has been reached
+ *
+ */
+FileChunk PipelinedFileReader::nextChunk(std::size_t carriedBytes)
+{
+    FileChunk chunk;
+    chunk.last = true;
+
+    // Nothing follows an unopened file or the last chunk
+    if (file == nullptr || (holdingBuffer && buffers[currentBuffer].last))
+    {
+        return chunk;
+    }
+
+    std::size_t nextBuffer = holdingBuffer ? (currentBuffer + 1) % buffers.size() : 0;
+    Buffer& buffer = buffers[nextBuffer];
+    {
+        std::unique_lock<std::mutex> lock{ mutex };
+        bufferFilled.wait(lock, [&buffer]() { return buffer.filled; });
+    }
+    chunk.fileBytes = buffer.bytes;
+    chunk.last = buffer.last;
+
+    // The carried bytes end the current chunk, which is still held by the parser
+    const char* carried = currentChunkEnd - carriedBytes;
+    std::size_t carryRoom = static_cast<std::size_t>(buffer.readRegion - buffer.storage.data());
+    if (carriedBytes <= carryRoom)
+    {
+        char* chunkStart = buffer.readRegion - carriedBytes;
+        if (carriedBytes > 0)
+        {
+            std::memcpy(chunkStart, carried, carriedBytes);
+        }
+        chunk.data = chunkStart;
+    }
+    else
+    {
+        std::vector<char> joined(carried, carried + carriedBytes);
+        joined.insert(joined.end(), buffer.readRegion, buffer.readRegion + buffer.bytes);
+        overflow.swap(joined);
+        chunk.data = overflow.data();
+    }
+    chunk.bytes = carriedBytes + buffer.bytes;
+
+    // Hand the current buffer back to the reader thread
+    if (holdingBuffer)
+    {
+        {
+            std::lock_guard<std::mutex> lock{ mutex };
+            buffers[currentBuffer].filled = false;
+        }
+        bufferEmptied.notify_one();
+    }
+    currentBuffer = nextBuffer;
+    holdingBuffer = true;
+    currentChunkEnd = chunk.data + chunk.bytes;
+    return chunk;
+}
+
+/** Fill the buffers in turn until the end of the file or until stopped */
+void PipelinedFileReader::readLoop()
+{
+    for (std::size_t i = 0;; i = (i + 1) % buffers.size())
+    {
+        Buffer& buffer = buffers[i];
+        {
+            std::unique_lock<std::mutex> lock{ mutex };
+            bufferEmptied.wait(lock, [this, &buffer]() { return stopping || !buffer.filled; });
+            if (stopping)
+            {
+                return;
+            }
+        }
+
+        // Read outside the lock so that the parser can work through the other buffers meanwhile
+        std::size_t bytes = std::fread(buffer.readRegion, 1, bufferBytes, file);
+        bool last = bytes < bufferBytes;
+        {
+            std::lock_guard<std::mutex> lock{ mutex };
+            buffer.bytes = bytes;
+            buffer.last = last;
+            buffer.filled = true;
+        }
+        bufferFilled.notify_one();
+
+        if (last)
+        {
+            return;
+        }
+    }
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/** Structure is used to hand a filled buffer to the parser */
+struct FileChunk
+{
+    // Bytes carried over from the previous chunk, immediately followed by the bytes just read
+    const char* data = nullptr;
+    std::size_t bytes = 0;
+
+    // Bytes read from the file for this chunk, excluding the carried bytes
+    std::size_t fileBytes = 0;
+
+    // True once the end of the file has been reached; no chunk follows
+    bool last = false;
+};
+
+class PipelinedFileReader
+{
+public:
+    /** Open a file and start reading it ahead of the parser on a background thread */
+    PipelinedFileReader(const std::string& filename, std::size_t bufferBytes = defaultBufferBytes, std::size_t bufferCount = defaultBufferCount);
+
+    /** Stop the reader thread and close the file */
+    ~PipelinedFileReader();
+
+    PipelinedFileReader(const PipelinedFileReader&) = delete;
+    PipelinedFileReader& operator=(const PipelinedFileReader&) = delete;
+
+    /** Return true if the file could be opened */
+    bool isOpen() const;
+
+    /** Return the size of the file in bytes, or 0 if it could not be opened */
+    std::size_t getFileBytes() const;
+
+    /** Wait for the next filled buffer, prefixed with bytes carried over from the current chunk, and recycle the current buffer */
+    FileChunk nextChunk(std::size_t carriedBytes);
+
+    // Bytes read from the file at a time, and the number of buffers read ahead of the parser
+    static constexpr std::size_t defaultBufferBytes = 1 << 20;
+    static constexpr std::size_t defaultBufferCount = 2;
+
+    // Alignment of the region each read lands in
+    static constexpr std::size_t bufferAlignment = 4096;
+
+    // Bytes reserved in front of each buffer for a line carried over from the previous buffer
+    static constexpr std::size_t carryBytes = 64 << 10;
+
+private:
+    /** Structure is used to hold one buffer and its state */
+    struct Buffer
+    {
+        std::vector<char> storage;
+        // Aligned start of the region reads land in, carryBytes into the storage
+        char* readRegion = nullptr;
+        std::size_t bytes = 0;
+        bool filled = false;
+        bool last = false;
+    };
+
+    /** Fill the buffers in turn until the end of the file or until stopped */
+    void readLoop();
+
+    std::FILE* file = nullptr;
+    std::size_t fileBytes = 0;
+    std::size_t bufferBytes;
+    std::vector<Buffer> buffers;
+
+    // Buffer currently held by the parser, and whether it holds one
+    std::size_t currentBuffer = 0;
+    bool holdingBuffer = false;
+
+    // One past the last byte of the chunk returned last, which ends the bytes to be carried
+    const char* currentChunkEnd = nullptr;
+
+    // Line longer than the carry region, joined with the next buffer outside the buffers
+    std::vector<char> overflow;
+
+    std::mutex mutex;
+    std::condition_variable bufferFilled;
+    std::condition_variable bufferEmptied;
+    bool stopping = false;
+    std::thread readerThread;
+};
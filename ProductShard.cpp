@@ -0,0 +1,335 @@
+#include "ProductShard.h"
+#include "FixedPoint.h"
+#include <algorithm>
+
+/** Initialize an empty shard holding the SDBEs of one product
+ *
+ *  @param _product Product name
+ *
+ */
+ProductShard::ProductShard(std::string _product)
+    : product(std::move(_product))
+{
+}
+
+/** Append an SDBE of the product, in time order, at a time step of the dataset
+ *
+ *  @param entry    SDBE of the shard's product
+ *  @param timeStep Position of the SDBE's time step within StocksDataBook::getTimeSteps()
+ *
+ */
+void ProductShard::append(const StocksDataBookEntry& entry, std::size_t timeStep)
+{
+    // Open a new range whenever the time step changes
+    if (timeSteps.empty() || timeSteps.back().timeStep != timeStep)
+    {
+        timeSteps.push_back(ShardTimeStep{ timeStep, timestamps.size(), timestamps.size() });
+    }
+    ++timeSteps.back().end;
+
+    timestamps.push_back(entry.timestamp);
+    prices.push_back(entry.price);
+    amounts.push_back(entry.amount);
+    types.push_back(entry.SDBEtype);
+    sources.push_back(entry.source);
+
+    // The tick size of the product is the finest written in its SDBEs
+    if (fixedPoint && (!appendTicks(priceTicks, priceDecimals, entry.price, entry.priceDecimals)
+                       || !appendTicks(amountTicks, amountDecimals, entry.amount, entry.amountDecimals)))
+    {
+        dropFixedPoint();
+    }
+}
+
+/** Append a number written with a number of decimals to a tick column, refining the column's tick size if needed
+ *
+ *  @param ticks        Tick column
+ *  @param tickDecimals Number of decimals of the column's tick size, raised if the number has more
+ *  @param number       Number parsed in fixed-point mode
+ *  @param decimals     Number of decimals the number was written with, or FixedPoint::noDecimals
+ *  @return             true if the number and the column are held in ticks within range, false otherwise
+ *
+ */
+bool ProductShard::appendTicks(std::vector<std::int64_t>& ticks, std::uint8_t& tickDecimals, double number, std::uint8_t decimals)
+{
+    if (decimals == FixedPoint::noDecimals)
+    {
+        return false;
+    }
+    std::int64_t units = FixedPoint::fromDouble(number, decimals);
+
+    // A finer tick size rescales the rows already held
+    if (decimals > tickDecimals)
+    {
+        for (std::int64_t& tick : ticks)
+        {
+            if (!FixedPoint::rescale(tick, tickDecimals, decimals, tick))
+            {
+                return false;
+            }
+        }
+        tickDecimals = decimals;
+    }
+
+    std::int64_t scaled = 0;
+    if (!FixedPoint::rescale(units, decimals, tickDecimals, scaled))
+    {
+        return false;
+    }
+    ticks.push_back(scaled);
+    return true;
+}
+
+/** Stop holding the tick columns, once an SDBE cannot be expressed in ticks
+ *
+ *  Queries then fall back on the floating-point columns, which are always held
+ *
+ */
+void ProductShard::dropFixedPoint()
+{
+    fixedPoint = false;
+    std::vector<std::int64_t>().swap(priceTicks);
+    std::vector<std::int64_t>().swap(amountTicks);
+}
+
+/** Copy the columns into fresh memory, so that they are placed on the NUMA node of the calling thread
+ *
+ *  Pages are placed on the node of the thread that first touches them, so this is called from a thread
+ *  bound to the shard's node. The copies also drop any spare capacity
+ *
+ */
+void ProductShard::relocate()
+{
+    std::vector<std::int64_t>(timestamps).swap(timestamps);
+    std::vector<double>(prices).swap(prices);
+    std::vector<double>(amounts).swap(amounts);
+    std::vector<StocksDataBookType>(types).swap(types);
+    std::vector<std::uint16_t>(sources).swap(sources);
+    std::vector<std::int64_t>(priceTicks).swap(priceTicks);
+    std::vector<std::int64_t>(amountTicks).swap(amountTicks);
+    std::vector<ShardTimeStep>(timeSteps).swap(timeSteps);
+}
+
+/** Return the product of the shard
+ *
+ *  @return product name
+ *
+ */
+const std::string& ProductShard::getProduct() const
+{
+    return product;
+}
+
+/** Return the number of SDBEs in the shard
+ *
+ *  @return number of rows
+ *
+ */
+std::size_t ProductShard::size() const
+{
+    return timestamps.size();
+}
+
+/** Return the timestamp column of the shard
+ *
+ *  @return timestamps in microseconds since 1970/01/01, in time order
+ *
+ */
+const std::vector<std::int64_t>& ProductShard::getTimestamps() const
+{
+    return timestamps;
+}
+
+/** Return the price column of the shard
+ *
+ *  @return prices in time order
+ *
+ */
+const std::vector<double>& ProductShard::getPrices() const
+{
+    return prices;
+}
+
+/** Return the amount column of the shard
+ *
+ *  @return amounts in time order
+ *
+ */
+const std::vector<double>& ProductShard::getAmounts() const
+{
+    return amounts;
+}
+
+/** Return the type column of the shard
+ *
+ *  @return SDBE types in time order
+ *
+ */
+const std::vector<StocksDataBookType>& ProductShard::getTypes() const
+{
+    return types;
+}
+
+/** Return the source column of the shard
+ *
+ *  @return source tags in time order
+ *
+ */
+const std::vector<std::uint16_t>& ProductShard::getSources() const
+{
+    return sources;
+}
+
+/** Return whether every SDBE of the shard was parsed into units, so that its tick columns are held
+ *
+ *  @return true if the tick columns hold every row, false otherwise
+ *
+ */
+bool ProductShard::hasFixedPoint() const
+{
+    return fixedPoint && !timestamps.empty();
+}
+
+/** Return the price tick column of the shard
+ *
+ *  @return prices as counts of 10^-getPriceDecimals(), in time order
+ *
+ */
+const std::vector<std::int64_t>& ProductShard::getPriceTicks() const
+{
+    return priceTicks;
+}
+
+/** Return the amount tick column of the shard
+ *
+ *  @return amounts as counts of 10^-getAmountDecimals(), in time order
+ *
+ */
+const std::vector<std::int64_t>& ProductShard::getAmountTicks() const
+{
+    return amountTicks;
+}
+
+/** Return the number of decimals of the product's price tick size
+ *
+ *  @return number of decimals
+ *
+ */
+std::uint8_t ProductShard::getPriceDecimals() const
+{
+    return priceDecimals;
+}
+
+/** Return the number of decimals of the product's amount tick size
+ *
+ *  @return number of decimals
+ *
+ */
+std::uint8_t ProductShard::getAmountDecimals() const
+{
+    return amountDecimals;
+}
+
+/** Sum the price ticks of the rows of a type within a range exactly, returning false if the sum overflows
+ *
+ *  Each block of rows is summed without branches into a 64-bit integer, which cannot overflow as no tick
+ *  exceeds FixedPoint::maxUnits, so the inner loop vectorizes
+ *
+ *  @param begin First row of the range
+ *  @param end   Row after the range
+ *  @param type  SDBE type of the rows summed
+ *  @param sum   Receives the sum of the price ticks
+ *  @param count Receives the number of rows summed
+ *  @return      true if the sum fits in 64 bits, false otherwise
+ *
+ */
+bool ProductShard::sumPriceTicks(std::size_t begin, std::size_t end, StocksDataBookType type, std::int64_t& sum, std::size_t& count) const
+{
+    sum = 0;
+    count = 0;
+    for (std::size_t blockBegin = begin; blockBegin < end; blockBegin += sumBlockRows)
+    {
+        std::size_t blockEnd = std::min(end, blockBegin + sumBlockRows);
+        std::int64_t blockSum = 0;
+        std::size_t blockCount = 0;
+        for (std::size_t row = blockBegin; row < blockEnd; ++row)
+        {
+            bool matches = types[row] == type;
+            blockSum += matches ? priceTicks[row] : 0;
+            blockCount += matches;
+        }
+        if (__builtin_add_overflow(sum, blockSum, &sum))
+        {
+            return false;
+        }
+        count += blockCount;
+    }
+    return true;
+}
+
+/** Return the time steps of the dataset at which the product has SDBEs, in time order
+ *
+ *  @return one range of rows per time step holding the product
+ *
+ */
+const std::vector<ShardTimeStep>& ProductShard::getTimeSteps() const
+{
+    return timeSteps;
+}
+
+/** Return the rows at a time step of the dataset, an empty range if the product has no SDBEs then
+ *
+ *  @param timeStep Position of the time step within StocksDataBook::getTimeSteps()
+ *  @return         rows of the shard at the time step
+ *
+ */
+ShardTimeStep ProductShard::findTimeStep(std::size_t timeStep) const
+{
+    auto it = std::lower_bound(timeSteps.begin(), timeSteps.end(), timeStep,
+        [](const ShardTimeStep& shardTimeStep, std::size_t value) { return shardTimeStep.timeStep < value; });
+    if (it == timeSteps.end() || it->timeStep != timeStep)
+    {
+        return ShardTimeStep{ timeStep, 0, 0 };
+    }
+    return *it;
+}
+
+/** Return the first row at or after a timestamp in microseconds
+ *
+ *  @param time Timestamp in microseconds since 1970/01/01
+ *  @return     row position, size() if every SDBE is earlier
+ *
+ */
+std::size_t ProductShard::lowerBound(std::int64_t time) const
+{
+    return static_cast<std::size_t>(std::lower_bound(timestamps.begin(), timestamps.end(), time) - timestamps.begin());
+}
+
+/** Return the first row after a timestamp in microseconds
+ *
+ *  @param time Timestamp in microseconds since 1970/01/01
+ *  @return     row position, size() if no SDBE is later
+ *
+ */
+std::size_t ProductShard::upperBound(std::int64_t time) const
+{
+    return static_cast<std::size_t>(std::upper_bound(timestamps.begin(), timestamps.end(), time) - timestamps.begin());
+}
+
+/** Rebuild the SDBE stored at a row
+ *
+ *  @param row Row position within the shard
+ *  @return    SDBE with the shard's product
+ *
+ */
+StocksDataBookEntry ProductShard::getEntry(std::size_t row) const
+{
+    StocksDataBookEntry entry{ prices[row], amounts[row], timestamps[row], product, types[row] };
+    entry.source = sources[row];
+    if (fixedPoint)
+    {
+        entry.priceDecimals = priceDecimals;
+        entry.amountDecimals = amountDecimals;
+    }
+    return entry;
+}
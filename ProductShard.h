@@ -0,0 +1,106 @@
+#pragma once
+
+#include "StocksDataBookEntry.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/** Structure is used to locate the rows of a shard at one time step of the dataset */
+struct ShardTimeStep
+{
+    // Position of the time step within StocksDataBook::getTimeSteps()
+    std::size_t timeStep;
+
+    // Rows [begin, end) of the shard at the time step
+    std::size_t begin;
+    std::size_t end;
+};
+
+class ProductShard
+{
+public:
+    /** Initialize an empty shard holding the SDBEs of one product */
+    ProductShard(std::string _product);
+
+    /** Append an SDBE of the product, in time order, at a time step of the dataset */
+    void append(const StocksDataBookEntry& entry, std::size_t timeStep);
+
+    /** Copy the columns into fresh memory, so that they are placed on the NUMA node of the calling thread */
+    void relocate();
+
+    /** Return the product of the shard */
+    const std::string& getProduct() const;
+
+    /** Return the number of SDBEs in the shard */
+    std::size_t size() const;
+
+    /** Return the columns of the shard, one row per SDBE in time order */
+    const std::vector<std::int64_t>& getTimestamps() const;
+    const std::vector<double>& getPrices() const;
+    const std::vector<double>& getAmounts() const;
+    const std::vector<StocksDataBookType>& getTypes() const;
+    const std::vector<std::uint16_t>& getSources() const;
+
+    /** Return whether every SDBE of the shard was parsed into units, so that its tick columns are held */
+    bool hasFixedPoint() const;
+
+    /** Return the tick columns of the shard, prices and amounts as counts of the product's tick sizes */
+    const std::vector<std::int64_t>& getPriceTicks() const;
+    const std::vector<std::int64_t>& getAmountTicks() const;
+
+    /** Return the number of decimals of the product's price and amount tick sizes */
+    std::uint8_t getPriceDecimals() const;
+    std::uint8_t getAmountDecimals() const;
+
+    /** Sum the price ticks of the rows of a type within a range exactly, returning false if the sum overflows */
+    bool sumPriceTicks(std::size_t begin, std::size_t end, StocksDataBookType type, std::int64_t& sum, std::size_t& count) const;
+
+    /** Return the time steps of the dataset at which the product has SDBEs, in time order */
+    const std::vector<ShardTimeStep>& getTimeSteps() const;
+
+    /** Return the rows at a time step of the dataset, an empty range if the product has no SDBEs then */
+    ShardTimeStep findTimeStep(std::size_t timeStep) const;
+
+    /** Return the first row at or after a timestamp in microseconds */
+    std::size_t lowerBound(std::int64_t time) const;
+
+    /** Return the first row after a timestamp in microseconds */
+    std::size_t upperBound(std::int64_t time) const;
+
+    /** Rebuild the SDBE stored at a row */
+    StocksDataBookEntry getEntry(std::size_t row) const;
+
+    /** NUMA node the columns are placed on and the shard is processed on */
+    int numaNode = 0;
+
+private:
+    /** Append a number written with a number of decimals to a tick column, refining the column's tick size if needed */
+    static bool appendTicks(std::vector<std::int64_t>& ticks, std::uint8_t& tickDecimals, double number, std::uint8_t decimals);
+
+    /** Stop holding the tick columns, once an SDBE cannot be expressed in ticks */
+    void dropFixedPoint();
+
+    // Number of rows whose ticks are summed in 64 bits before being added to the total, so that no block overflows
+    static constexpr std::size_t sumBlockRows = 512;
+
+    std::string product;
+
+    // Columns of the SDBEs of the product, in time order
+    std::vector<std::int64_t> timestamps;
+    std::vector<double> prices;
+    std::vector<double> amounts;
+    std::vector<StocksDataBookType> types;
+    std::vector<std::uint16_t> sources;
+
+    // Prices and amounts as counts of the product's tick sizes, 10^-priceDecimals and 10^-amountDecimals, held
+    // while fixedPoint is set
+    std::vector<std::int64_t> priceTicks;
+    std::vector<std::int64_t> amountTicks;
+    std::uint8_t priceDecimals = 0;
+    std::uint8_t amountDecimals = 0;
+    bool fixedPoint = true;
+
+    /** Time steps at which the product has SDBEs, mapping the time steps of the dataset onto rows of the shard */
+    std::vector<ShardTimeStep> timeSteps;
+};
@@ -1,53 +1,262 @@
 #include "StocksDataBook.h"
 #include "CSVFileReader.h"
+#include "BookArchive.h"
+#include "BookSorter.h"
+#include "TimeStamp.h"
+#include "ParallelFor.h"
 #include <unordered_set>
 #include <algorithm>
 #include <iostream>
 #include <chrono>
+#include <cctype>
+#include <sstream>
+#include <iterator>
+
+/** Initialize an empty dataset, to be filled by appending SDBEs */
+StocksDataBook::StocksDataBook() = default;
 
 /** Parse the CSV file and convert valid lines into SDBEs
  *
- *  @param filename Name of CSV file
+ *  Files carrying the archive extension are decoded from the compressed columnar format instead
+ *
+ *  @param filename Name of CSV file or book archive
  *
  */
 StocksDataBook::StocksDataBook(std::string filename)
+    : StocksDataBook(std::vector<std::string>{ filename })
 {
-    // Convert valid lines into SDBEs
-    SDBEcollection = CSVFileReader::readCSVfile(filename);
 }
 
-/** Return all unique products in the dataset
+/** Parse several files covering the same session concurrently and merge them into one time-ordered dataset
+ *
+ *  Each file is loaded and sorted on its own thread, after which the sorted files are combined with a k-way
+ *  merge. Every SDBE keeps the position of its file as its source tag
  *
- *  @return container of unique products
+ *  @param filenames Names of CSV files or book archives
+ *  @param options   Validation mode and quarantine stream applied to every CSV file
  *
  */
-std::vector<std::string> StocksDataBook::getUniqueProducts()
+StocksDataBook::StocksDataBook(std::vector<std::string> filenames, const CSVReadOptions& options)
+    : sourceFilenames(filenames)
 {
-    // Executes given that unique products have not been cached
-    if (uniqueProducts.empty())
+    if (filenames.size() == 1)
+    {
+        SDBEcollection = loadFile(filenames[0], loadReport, options);
+
+        // Time step navigation relies on time order, which the input does not guarantee
+        BookSorter::sortEntries(SDBEcollection, loadReport);
+    }
+    else
     {
-        // Store unique products
-        std::unordered_set<std::string> prodUnorderedSet;
+        auto startTime = std::chrono::steady_clock::now();
+        std::vector<std::vector<StocksDataBookEntry>> sourceEntries(filenames.size());
+        std::vector<LoadReport> sourceReports(filenames.size());
+
+        // Quarantine each file separately so that concurrent loads do not interleave their lines
+        std::vector<std::ostringstream> sourceQuarantines(filenames.size());
 
-        // Insert all products
-        for (StocksDataBookEntry& SDBEentry : SDBEcollection)
+        ParallelFor::run(filenames.size(), [&](std::size_t source)
         {
-            prodUnorderedSet.insert(SDBEentry.product);
+            CSVReadOptions sourceOptions = options;
+            if (options.quarantineStream != nullptr)
+            {
+                sourceOptions.quarantineStream = &sourceQuarantines[source];
+            }
+
+            std::vector<StocksDataBookEntry>& entries = sourceEntries[source];
+            entries = loadFile(filenames[source], sourceReports[source], sourceOptions);
+
+            // Tag each SDBE with its file before the file is sorted
+            for (StocksDataBookEntry& entry : entries)
+            {
+                entry.source = static_cast<std::uint16_t>(source);
+            }
+            BookSorter::sortEntries(entries, sourceReports[source]);
+        });
+
+        for (std::size_t source = 0; source < filenames.size(); ++source)
+        {
+            loadReport.merge(sourceReports[source]);
+            if (options.quarantineStream != nullptr)
+            {
+                *options.quarantineStream << sourceQuarantines[source].str();
+            }
         }
 
-        // Flatten unordered set into vector
-        std::vector<std::string> products(prodUnorderedSet.begin(), prodUnorderedSet.end());
+        // Combine the sorted files, timing the merge as part of the sort phase
+        auto mergeStart = std::chrono::steady_clock::now();
+        SDBEcollection = BookSorter::mergeSortedSources(sourceEntries);
+        auto mergeEnd = std::chrono::steady_clock::now();
+        loadReport.phaseTimes.sortSeconds += std::chrono::duration<double>(mergeEnd - mergeStart).count();
+        loadReport.phaseTimes.totalSeconds = std::chrono::duration<double>(mergeEnd - startTime).count();
+        loadReport.sortStrategy = "k-way merge of " + std::to_string(filenames.size()) + " files";
+    }
 
-        // Cache the set of unique products to avoid redundant calls
-        uniqueProducts = products;
+    // Index the distinct timestamps so that a time step can be located without scanning the collection
+    buildTimeStepIndex(0);
 
-        return products;
+    // Split the SDBEs by product so that a query only touches the memory of its product
+    buildShards(0);
+}
+
+/** Load the SDBEs of a single CSV file or book archive, canonicalizing their products
+ *
+ *  Product symbols are canonicalized so that the same product spelled differently across dumps becomes a single
+ *  product, including in the SDBEs handed to a chunk consumer
+ *
+ *  @param filename   Name of CSV file or book archive
+ *  @param loadReport Report to be populated with statistics about the load
+ *  @param options    Validation mode, quarantine stream and chunk consumer, applied to CSV files
+ *  @return           SDBEs in file order, other than those taken by a chunk consumer
+ *
+ */
+std::vector<StocksDataBookEntry> StocksDataBook::loadFile(const std::string& filename, LoadReport& loadReport, const CSVReadOptions& options)
+{
+    if (!BookArchive::isArchiveFilename(filename))
+    {
+        CSVReadOptions fileOptions = options;
+        if (options.chunkConsumer)
+        {
+            fileOptions.chunkConsumer = [&options](std::vector<StocksDataBookEntry>& entries, std::size_t bytesRead)
+            {
+                canonicalizeProducts(entries);
+                options.chunkConsumer(entries, bytesRead);
+            };
+        }
+
+        // Convert valid lines into SDBEs
+        std::vector<StocksDataBookEntry> entries = CSVFileReader::readCSVfile(filename, loadReport, fileOptions);
+        canonicalizeProducts(entries);
+        return entries;
     }
 
-    // Return cached products
+    // Decode every block of the archive, which only ever holds valid SDBEs
+    auto startTime = std::chrono::steady_clock::now();
+    BookArchive bookArchive{ filename };
+    std::vector<StocksDataBookEntry> entries = bookArchive.readAll();
+    canonicalizeProducts(entries);
+
+    loadReport.filename = filename;
+    loadReport.rowsParsed = entries.size();
+    loadReport.phaseTimes.totalSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    loadReport.reservedCapacity = loadReport.finalCapacity = entries.capacity();
+    return entries;
+}
+
+/** Canonicalize a product symbol by removing surrounding whitespace and converting it to upper case
+ *
+ *  @param product Product symbol, modified in place
+ *
+ */
+void StocksDataBook::canonicalizeProduct(std::string& product)
+{
+    // Trim in place, which leaves symbols that are already canonical untouched
+    std::size_t last = product.find_last_not_of(" \t");
+    product.erase(last == std::string::npos ? 0 : last + 1);
+    product.erase(0, product.find_first_not_of(" \t"));
+    for (char& character : product)
+    {
+        character = static_cast<char>(std::toupper(static_cast<unsigned char>(character)));
+    }
+}
+
+/** Canonicalize the product symbol of every SDBE
+ *
+ *  @param entries SDBEs, modified in place
+ *
+ */
+void StocksDataBook::canonicalizeProducts(std::vector<StocksDataBookEntry>& entries)
+{
+    for (StocksDataBookEntry& entry : entries)
+    {
+        canonicalizeProduct(entry.product);
+    }
+}
+
+/** Return the names of the files the dataset was loaded from, indexed by source tag
+ *
+ *  @return container of filenames
+ *
+ */
+const std::vector<std::string>& StocksDataBook::getSourceFilenames() const
+{
+    return sourceFilenames;
+}
+
+/** Return all unique products in the dataset, as indexed by buildDerivedIndexes()
+ *
+ *  @return container of unique products, empty until the derived indexes are built
+ *
+ */
+const std::vector<std::string>& StocksDataBook::getUniqueProducts() const
+{
     return uniqueProducts;
 }
 
+/** Collect the unique products and index them by name regardless of case */
+void StocksDataBook::buildUniqueProducts()
+{
+    // Store unique products
+    std::unordered_set<std::string> prodUnorderedSet;
+
+    // Insert all products
+    for (const StocksDataBookEntry& SDBEentry : SDBEcollection)
+    {
+        prodUnorderedSet.insert(SDBEentry.product);
+    }
+
+    // Cache the set of unique products to avoid redundant calls
+    uniqueProducts.assign(prodUnorderedSet.begin(), prodUnorderedSet.end());
+
+    // Index the products by name regardless of case, so that commands validate them without copying or converting
+    productPositions.clear();
+    for (std::size_t i = 0; i < uniqueProducts.size(); ++i)
+    {
+        productPositions.emplace(hashProductName(uniqueProducts[i]), i);
+    }
+    uniqueProductsBuilt = true;
+}
+
+/** Return the dataset's name for a product matched regardless of case, or null if the dataset does not hold it
+ *
+ *  @param product Product name in any case
+ *  @return        product name as held in the dataset, or null
+ *
+ */
+const std::string* StocksDataBook::findProduct(std::string_view product) const
+{
+    // Names sharing a hash are told apart by comparing them
+    auto range = productPositions.equal_range(hashProductName(product));
+    for (auto it = range.first; it != range.second; ++it)
+    {
+        const std::string& uniqueProduct = uniqueProducts[it->second];
+        if (uniqueProduct.size() == product.size()
+            && std::equal(uniqueProduct.begin(), uniqueProduct.end(), product.begin(), [](char a, char b)
+               { return std::tolower(static_cast<unsigned char>(a)) == std::tolower(static_cast<unsigned char>(b)); }))
+        {
+            return &uniqueProduct;
+        }
+    }
+    return nullptr;
+}
+
+/** Hash a product name regardless of case
+ *
+ *  @param product Product name in any case
+ *  @return        FNV-1a hash of the lower case name
+ *
+ */
+std::uint64_t StocksDataBook::hashProductName(std::string_view product)
+{
+    std::uint64_t hash = 14695981039346656037ULL;
+    for (char character : product)
+    {
+        hash ^= static_cast<unsigned char>(std::tolower(static_cast<unsigned char>(character)));
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
 /** Return SDBEs according to the filter parameters
  *
  *  @param type      SDBE type - ask/bid/unknown
@@ -57,31 +266,180 @@ std::vector<std::string> StocksDataBook::getUniqueProducts()
  *
  */
 std::vector<StocksDataBookEntry> StocksDataBook::filterSDBEentries(StocksDataBookType type,
-                                                                   std::string product,
-                                                                   std::string timestamp)
+                                                                   const std::string& product,
+                                                                   const std::string& timestamp) const
 {
     // Filtered subset of the SDBE entries from dataset
     std::vector<StocksDataBookEntry> filteredSDBEs;
 
-    // Iterate through SDBE entries in dataset for comparison with filters
-    for (int i = 0; i < SDBEcollection.size(); ++i)
+    // Only the product's shard is visited
+    const ProductShard* shard = findShard(product);
+    if (shard == nullptr)
     {
-        // SDBE matches the filter parameters
-        if (SDBEcollection[i].SDBEtype == type && SDBEcollection[i].product == product && SDBEcollection[i].timestamp == timestamp)
+        return filteredSDBEs;
+    }
+
+    // Parse the timestamp once so that its rows are found by binary search
+    std::int64_t time = TimeStamp::parse(timestamp);
+    const std::vector<StocksDataBookType>& types = shard->getTypes();
+
+    // Iterate through the rows at the timestamp for comparison with the type
+    for (std::size_t row = shard->lowerBound(time), end = shard->upperBound(time); row < end; ++row)
+    {
+        if (types[row] == type)
         {
-            filteredSDBEs.push_back(SDBEcollection[i]);
+            filteredSDBEs.push_back(shard->getEntry(row));
         }
     }
     return filteredSDBEs;
 }
 
+/** Return the SDBEs of one source file according to the filter parameters
+ *
+ *  @param source    Position of the file within getSourceFilenames()
+ *  @param type      SDBE type - ask/bid/unknown
+ *  @param product   Product name
+ *  @param timestamp Current timestamp of simulation
+ *  @return          container of filtered SDBE entries loaded from the file
+ *
+ */
+std::vector<StocksDataBookEntry> StocksDataBook::filterSourceSDBEentries(std::uint16_t source,
+                                                                         StocksDataBookType type,
+                                                                         const std::string& product,
+                                                                         const std::string& timestamp) const
+{
+    std::vector<StocksDataBookEntry> filteredSDBEs = filterSDBEentries(type, product, timestamp);
+    filteredSDBEs.erase(std::remove_if(filteredSDBEs.begin(), filteredSDBEs.end(),
+        [source](const StocksDataBookEntry& entry) { return entry.source != source; }), filteredSDBEs.end());
+    return filteredSDBEs;
+}
+
+/** Return the SDBEs of a product and type within a time range and price range, visiting only the product's shard
+ *
+ *  The shard holds the product's SDBEs in time order, so the rows within the time range are found by binary search
+ *
+ *  @param type     SDBE type - ask/bid/unknown
+ *  @param product  Product name
+ *  @param fromTime Earliest timestamp, in microseconds since 1970/01/01
+ *  @param toTime   Latest timestamp, in microseconds since 1970/01/01
+ *  @param minPrice Lowest price
+ *  @param maxPrice Highest price
+ *  @return         matching SDBEs in collection order
+ *
+ */
+std::vector<StocksDataBookEntry> StocksDataBook::filterSDBEentries(StocksDataBookType type,
+                                                                   const std::string& product,
+                                                                   std::int64_t fromTime,
+                                                                   std::int64_t toTime,
+                                                                   double minPrice,
+                                                                   double maxPrice) const
+{
+    std::vector<StocksDataBookEntry> filteredSDBEs;
+
+    const ProductShard* shard = findShard(product);
+    if (shard == nullptr)
+    {
+        return filteredSDBEs;
+    }
+
+    const std::vector<StocksDataBookType>& types = shard->getTypes();
+    const std::vector<double>& prices = shard->getPrices();
+    for (std::size_t row = shard->lowerBound(fromTime), end = shard->upperBound(toTime); row < end; ++row)
+    {
+        if (types[row] == type && prices[row] >= minPrice && prices[row] <= maxPrice)
+        {
+            filteredSDBEs.push_back(shard->getEntry(row));
+        }
+    }
+    return filteredSDBEs;
+}
+
+/** Summarize the SDBEs of a product and type within a time range, visiting only the product's shard
+ *
+ *  @param type     SDBE type - ask/bid/unknown
+ *  @param product  Product name
+ *  @param fromTime Earliest timestamp, in microseconds since 1970/01/01
+ *  @param toTime   Latest timestamp, in microseconds since 1970/01/01
+ *  @return         counts, sums and price range of the matching SDBEs
+ *
+ */
+TimeStepAggregate StocksDataBook::aggregateSDBEentries(StocksDataBookType type, const std::string& product, std::int64_t fromTime, std::int64_t toTime) const
+{
+    TimeStepAggregate aggregate;
+
+    const ProductShard* shard = findShard(product);
+    if (shard == nullptr)
+    {
+        return aggregate;
+    }
+
+    const std::vector<StocksDataBookType>& types = shard->getTypes();
+    const std::vector<double>& prices = shard->getPrices();
+    const std::vector<double>& amounts = shard->getAmounts();
+    for (std::size_t row = shard->lowerBound(fromTime), end = shard->upperBound(toTime); row < end; ++row)
+    {
+        if (types[row] != type)
+        {
+            continue;
+        }
+
+        aggregate.minPrice = aggregate.entries == 0 ? prices[row] : std::min(aggregate.minPrice, prices[row]);
+        aggregate.maxPrice = aggregate.entries == 0 ? prices[row] : std::max(aggregate.maxPrice, prices[row]);
+        aggregate.sumPrice += prices[row];
+        aggregate.sumAmount += amounts[row];
+        aggregate.sumPriceAmount += prices[row] * amounts[row];
+        ++aggregate.entries;
+    }
+    return aggregate;
+}
+
+/** Append SDBEs to the dataset, maintaining the time step index and product shards
+ *
+ *  SDBEs that continue the time order extend the time step index and shards rather than rebuilding
+ *  them. Otherwise the dataset is merged back into order and all three are rebuilt. The product and aggregate
+ *  caches are discarded and rebuilt on next use
+ *
+ *  @param entries SDBEs to be appended, moved into the dataset
+ *
+ */
+void StocksDataBook::appendSDBEentries(std::vector<StocksDataBookEntry> entries)
+{
+    std::size_t firstEntry = SDBEcollection.size();
+    if (SDBEcollection.empty())
+    {
+        SDBEcollection.swap(entries);
+    }
+    else
+    {
+        SDBEcollection.insert(SDBEcollection.end(), std::make_move_iterator(entries.begin()), std::make_move_iterator(entries.end()));
+    }
+
+    if (BookSorter::isSorted(SDBEcollection, firstEntry))
+    {
+        buildTimeStepIndex(firstEntry);
+        buildShards(firstEntry);
+    }
+    else
+    {
+        BookSorter::sortEntries(SDBEcollection, loadReport);
+        buildTimeStepIndex(0);
+        buildShards(0);
+    }
+
+    uniqueProducts.clear();
+    productPositions.clear();
+    uniqueProductsBuilt = false;
+    timeStepAggregates.clear();
+    timeStepAggregatesBuilt = false;
+}
+
 /** Return the maximum and minimum price within SDBE collection
  *
  *  @param SDBEcollection Collection of SDBE entries
  *  @return               pair containing maximum and minimum price within container
  *
  */
-struct MinMaxPair StocksDataBook::getMinMaxPrice(std::vector<StocksDataBookEntry>& SDBEcollection)
+struct MinMaxPair StocksDataBook::getMinMaxPrice(const std::vector<StocksDataBookEntry>& SDBEcollection) const
 {
     // Number of SDBE entries in the SDBE collection
     int containerSize = SDBEcollection.size();
@@ -174,9 +532,9 @@ struct MinMaxPair StocksDataBook::getMinMaxPrice(std::vector<StocksDataBookEntry
  *  @return earliest timestamp in dataset
  *
  */
-std::string StocksDataBook::getEarliestTimeStamp()
+std::string StocksDataBook::getEarliestTimeStamp() const
 {
-    return SDBEcollection[0].timestamp;
+    return SDBEcollection[0].getTimestampString();
 }
 
 /** Return the next timestamp after the timestamp passed in, in a circular manner
@@ -185,7 +543,7 @@ std::string StocksDataBook::getEarliestTimeStamp()
  *  @return          next timestamp in dataset
  *
  */
-std::string StocksDataBook::getNextTimeStamp(std::string timestamp)
+std::string StocksDataBook::getNextTimeStamp(const std::string& timestamp) const
 {
     // Position of upper bound, the next timestamp
     signed int upperBoundTimeStamp = -1;
@@ -200,12 +558,15 @@ std::string StocksDataBook::getNextTimeStamp(std::string timestamp)
         return "Invalid StocksDataBook";
     }
 
+    // Parse the reference timestamp once so that the search compares integers
+    std::int64_t time = TimeStamp::parse(timestamp);
+
     /* Case in which reference timestamp is the latest timestamp
     Return initial timestamp to maintain a circular SDB */
-    if (timestamp == SDBEcollection[endTimeStamp - 1].timestamp)
+    if (time == SDBEcollection[endTimeStamp - 1].timestamp)
     {
-        std::cout << SDBEcollection[0].timestamp << std::endl;
-        return SDBEcollection[0].timestamp;
+        std::cout << SDBEcollection[0].getTimestampString() << std::endl;
+        return SDBEcollection[0].getTimestampString();
     }
 
     // Compute upper bound of reference timestamp via a modified binary search
@@ -223,7 +584,7 @@ std::string StocksDataBook::getNextTimeStamp(std::string timestamp)
         __builtin_prefetch(&SDBEcollection[(startTimeStamp + midTimeStamp - 1) / 2], 0, 1);
 
         // Reduce search space to the right half of timestamp collection
-        if (SDBEcollection[midTimeStamp].timestamp <= timestamp)
+        if (SDBEcollection[midTimeStamp].timestamp <= time)
             startTimeStamp = midTimeStamp + 1;
 
         // Reduce search space to the left half of timestamp collection
@@ -235,7 +596,7 @@ std::string StocksDataBook::getNextTimeStamp(std::string timestamp)
         }
     }
     // Next timestamp occurs at position of lower bound
-    std::string nextTimestamp = SDBEcollection[upperBoundTimeStamp].timestamp;
+    std::string nextTimestamp = SDBEcollection[upperBoundTimeStamp].getTimestampString();
     return nextTimestamp;
 }
 
@@ -245,7 +606,7 @@ std::string StocksDataBook::getNextTimeStamp(std::string timestamp)
 *   @return          previous timestamp in dataset
 *
 */
-std::string StocksDataBook::getPreviousTimeStamp(std::string timestamp)
+std::string StocksDataBook::getPreviousTimeStamp(const std::string& timestamp) const
 {
     // Position of lower bound, the previous timestamp
     signed int lowerBoundTimeStamp = -1;
@@ -260,11 +621,14 @@ std::string StocksDataBook::getPreviousTimeStamp(std::string timestamp)
         return "Invalid StocksDataBook";
     }
 
+    // Parse the reference timestamp once so that the search compares integers
+    std::int64_t time = TimeStamp::parse(timestamp);
+
     /* Case in which reference timestamp is the earliest timestamp
     Return latest timestamp to maintain a circular SDB */
-    if (timestamp == SDBEcollection[0].timestamp)
+    if (time == SDBEcollection[0].timestamp)
     {
-        return SDBEcollection[endTimeStamp - 1].timestamp;
+        return SDBEcollection[endTimeStamp - 1].getTimestampString();
     }
 
     // Compute lower bound of reference timestamp via a modified binary search
@@ -282,7 +646,7 @@ std::string StocksDataBook::getPreviousTimeStamp(std::string timestamp)
         __builtin_prefetch(&SDBEcollection[(startTimeStamp + midTimeStamp - 1) / 2], 0, 1);
 
         // Reduce search space to the left half of timestamp collection
-        if ((SDBEcollection[midTimeStamp].timestamp) >= timestamp)
+        if ((SDBEcollection[midTimeStamp].timestamp) >= time)
         {
             endTimeStamp = midTimeStamp - 1;
         }
@@ -296,6 +660,308 @@ std::string StocksDataBook::getPreviousTimeStamp(std::string timestamp)
         }
     }
     // Previous timestamp occurs at position of lower bound
-    std::string previousTimestamp = SDBEcollection[lowerBoundTimeStamp].timestamp;
+    std::string previousTimestamp = SDBEcollection[lowerBoundTimeStamp].getTimestampString();
     return previousTimestamp;
-}
\ No newline at end of file
+}
+
+/** Return the report generated while loading the CSV file
+ *
+ *  @return load report of the dataset
+ *
+ */
+const LoadReport& StocksDataBook::getLoadReport() const
+{
+    return loadReport;
+}
+
+/** Record the files and load report of a dataset whose SDBEs were appended as they were parsed
+ *
+ *  Any sorting needed while appending is kept in the report
+ *
+ *  @param filenames      Names of the files the SDBEs were parsed from
+ *  @param fileLoadReport Report generated while parsing the files
+ *
+ */
+void StocksDataBook::recordLoad(const std::vector<std::string>& filenames, const LoadReport& fileLoadReport)
+{
+    sourceFilenames = filenames;
+
+    LoadReport appendReport = loadReport;
+    loadReport = fileLoadReport;
+    loadReport.sortStrategy = appendReport.sortStrategy;
+    loadReport.sortedRuns = std::max<std::size_t>(appendReport.sortedRuns, SDBEcollection.empty() ? 0 : 1);
+    loadReport.phaseTimes.sortSeconds = appendReport.phaseTimes.sortSeconds;
+    loadReport.phaseTimes.totalSeconds += appendReport.phaseTimes.sortSeconds;
+}
+
+/** Return all SDBEs in the dataset in time order
+ *
+ *  @return collection of SDBE entries
+ *
+ */
+const std::vector<StocksDataBookEntry>& StocksDataBook::getEntries() const
+{
+    return SDBEcollection;
+}
+
+/** Return the distinct timestamps of the dataset along with the positions of their SDBEs
+ *
+ *  @return container of time step ranges in time order
+ *
+ */
+const std::vector<TimeStepRange>& StocksDataBook::getTimeSteps() const
+{
+    return timeSteps;
+}
+
+/** Return the position of a timestamp among the distinct timestamps, or -1 if it does not occur
+ *
+ *  @param timestamp Timestamp to be located
+ *  @return          index into getTimeSteps(), or -1 if the timestamp is not in the dataset
+ *
+ */
+long StocksDataBook::findTimeStep(const std::string& timestamp) const
+{
+    std::int64_t time = TimeStamp::parse(timestamp);
+    return time < 0 ? -1 : findTimeStep(time);
+}
+
+/** Return the position of a timestamp in microseconds among the distinct timestamps, or -1 if it does not occur
+ *
+ *  @param time Microseconds since 1970/01/01
+ *  @return     index into getTimeSteps(), or -1 if the timestamp is not in the dataset
+ *
+ */
+long StocksDataBook::findTimeStep(std::int64_t time) const
+{
+    // Binary search over the distinct timestamps
+    const std::vector<std::int64_t>& times = timeStampIndex.getTimes();
+    auto it = std::lower_bound(times.begin(), times.end(), time);
+
+    if (it == times.end() || *it != time)
+    {
+        return -1;
+    }
+    return static_cast<long>(it - times.begin());
+}
+
+/** Group the time-ordered SDBEs from a position onwards into ranges sharing one timestamp
+ *
+ *  @param firstEntry Position of the first SDBE not yet indexed, 0 to rebuild the whole index
+ *
+ */
+void StocksDataBook::buildTimeStepIndex(std::size_t firstEntry)
+{
+    if (firstEntry == 0)
+    {
+        timeSteps.clear();
+    }
+
+    // Open a new range whenever the timestamp changes, formatting only the distinct timestamps for display
+    std::vector<std::int64_t> times = firstEntry == 0 ? std::vector<std::int64_t>{} : timeStampIndex.getTimes();
+    for (std::size_t i = firstEntry; i < SDBEcollection.size(); ++i)
+    {
+        if (timeSteps.empty() || SDBEcollection[i].timestamp != timeSteps.back().time)
+        {
+            timeSteps.push_back(TimeStepRange{ SDBEcollection[i].getTimestampString(), SDBEcollection[i].timestamp, i, i });
+            times.push_back(SDBEcollection[i].timestamp);
+        }
+        timeSteps.back().end = i + 1;
+    }
+    timeStampIndex = TimeStampIndex{ std::move(times) };
+}
+
+/** Return the index of the distinct timestamps parsed into microseconds, for seeks and range queries
+ *
+ *  @return index with one timestamp per entry of getTimeSteps()
+ *
+ */
+const TimeStampIndex& StocksDataBook::getTimeStampIndex() const
+{
+    return timeStampIndex;
+}
+
+/** Return the per time step aggregates of a product and type, as built by buildDerivedIndexes()
+ *
+ *  @param product Product name
+ *  @param type    SDBE type - ask/bid
+ *  @return        one aggregate per distinct timestamp, empty if the product does not exist or the aggregates are not built
+ *
+ */
+const std::vector<TimeStepAggregate>& StocksDataBook::getTimeStepAggregates(const std::string& product, StocksDataBookType type) const
+{
+    // Aggregates returned for unknown products and types
+    static const std::vector<TimeStepAggregate> noAggregates;
+
+    auto it = timeStepAggregates.find(product);
+    if (it == timeStepAggregates.end() || type == StocksDataBookType::unknown)
+    {
+        return noAggregates;
+    }
+    return type == StocksDataBookType::bid ? it->second.bids : it->second.asks;
+}
+
+/** Build the unique products and per time step aggregates, which the const accessors only read
+ *
+ *  A book shared between threads is only read once published, so everything derived from its SDBEs is built beforehand
+ *
+ */
+void StocksDataBook::buildDerivedIndexes()
+{
+    if (!uniqueProductsBuilt)
+    {
+        buildUniqueProducts();
+    }
+    if (!timeStepAggregatesBuilt)
+    {
+        buildTimeStepAggregates();
+    }
+}
+
+/** Summarize the SDBEs of every product, type and time step, each shard on its own node
+ *
+ *  Every product's aggregates are created up front, so that the shards can then fill their own concurrently
+ *
+ */
+void StocksDataBook::buildTimeStepAggregates()
+{
+    timeStepAggregatesBuilt = true;
+    for (const ProductShard& shard : shards)
+    {
+        timeStepAggregates[shard.getProduct()];
+    }
+
+    forEachShard([this](ProductShard& shard)
+    {
+        ProductAggregates& productAggregates = timeStepAggregates.find(shard.getProduct())->second;
+        productAggregates.bids.resize(timeSteps.size());
+        productAggregates.asks.resize(timeSteps.size());
+
+        const std::vector<StocksDataBookType>& types = shard.getTypes();
+        const std::vector<double>& prices = shard.getPrices();
+        const std::vector<double>& amounts = shard.getAmounts();
+        for (const ShardTimeStep& shardTimeStep : shard.getTimeSteps())
+        {
+            for (std::size_t row = shardTimeStep.begin; row < shardTimeStep.end; ++row)
+            {
+                if (types[row] == StocksDataBookType::unknown)
+                {
+                    continue;
+                }
+
+                // Fold the SDBE into the aggregate of its type and time step
+                TimeStepAggregate& aggregate = types[row] == StocksDataBookType::bid ? productAggregates.bids[shardTimeStep.timeStep] : productAggregates.asks[shardTimeStep.timeStep];
+                if (aggregate.entries == 0)
+                {
+                    aggregate.minPrice = prices[row];
+                    aggregate.maxPrice = prices[row];
+                }
+                else
+                {
+                    aggregate.minPrice = std::min(aggregate.minPrice, prices[row]);
+                    aggregate.maxPrice = std::max(aggregate.maxPrice, prices[row]);
+                }
+                ++aggregate.entries;
+                aggregate.sumPrice += prices[row];
+                aggregate.sumAmount += amounts[row];
+                aggregate.sumPriceAmount += prices[row] * amounts[row];
+            }
+        }
+    });
+}
+
+/** Return the shard holding the SDBEs of a product, or null if the product does not exist
+ *
+ *  @param product Product name
+ *  @return        shard of the product
+ *
+ */
+const ProductShard* StocksDataBook::findShard(const std::string& product) const
+{
+    auto it = shardPositions.find(product);
+    return it == shardPositions.end() ? nullptr : &shards[it->second];
+}
+
+/** Return the per-product shards, in order of each product's first SDBE
+ *
+ *  @return shards of every product in the dataset
+ *
+ */
+const std::vector<ProductShard>& StocksDataBook::getShards() const
+{
+    return shards;
+}
+
+/** Spread the shards across the NUMA nodes and move the columns of each shard onto its node
+ *
+ *  The largest shards are placed first, each on the node holding the fewest SDBEs so far. Nothing moves
+ *  on a machine with a single node
+ *
+ */
+void StocksDataBook::placeShards()
+{
+    const std::vector<int>& nodes = NumaTopology::getNodes();
+    if (nodes.size() < 2)
+    {
+        return;
+    }
+
+    std::vector<std::size_t> order(shards.size());
+    for (std::size_t i = 0; i < order.size(); ++i)
+    {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [this](std::size_t a, std::size_t b) { return shards[a].size() > shards[b].size(); });
+
+    std::vector<std::size_t> nodeEntries(nodes.size(), 0);
+    for (std::size_t i : order)
+    {
+        std::size_t node = static_cast<std::size_t>(std::min_element(nodeEntries.begin(), nodeEntries.end()) - nodeEntries.begin());
+        shards[i].numaNode = nodes[node];
+        nodeEntries[node] += shards[i].size();
+    }
+
+    // Copy each shard from a thread on its node, which places the copy's pages there
+    forEachShard([](ProductShard& shard) { shard.relocate(); });
+}
+
+/** Split the time-ordered SDBEs from a position onwards into the shards of their products
+ *
+ *  @param firstEntry Position of the first SDBE not yet sharded, 0 to rebuild every shard
+ *
+ */
+void StocksDataBook::buildShards(std::size_t firstEntry)
+{
+    if (firstEntry == 0)
+    {
+        shards.clear();
+        shardPositions.clear();
+    }
+
+    // Start at the time step holding the first new SDBE, which may continue the last time step already sharded
+    auto timeStep = std::upper_bound(timeSteps.begin(), timeSteps.end(), firstEntry,
+        [](std::size_t position, const TimeStepRange& range) { return position < range.end; });
+
+    // Products commonly repeat across consecutive SDBEs, so avoid rehashing the same name
+    const std::string* previousProduct = nullptr;
+    ProductShard* shard = nullptr;
+
+    for (std::size_t timeStepIndex = static_cast<std::size_t>(timeStep - timeSteps.begin()); timeStepIndex < timeSteps.size(); ++timeStepIndex)
+    {
+        for (std::size_t i = std::max(timeSteps[timeStepIndex].begin, firstEntry); i < timeSteps[timeStepIndex].end; ++i)
+        {
+            const StocksDataBookEntry& entry = SDBEcollection[i];
+            if (previousProduct == nullptr || *previousProduct != entry.product)
+            {
+                auto inserted = shardPositions.try_emplace(entry.product, shards.size());
+                if (inserted.second)
+                {
+                    shards.emplace_back(entry.product);
+                }
+                shard = &shards[inserted.first->second];
+                previousProduct = &entry.product;
+            }
+            shard->append(entry, timeStepIndex);
+        }
+    }
+}
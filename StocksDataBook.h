@@ -2,8 +2,52 @@
 
 #include "StocksDataBookEntry.h"
 #include "CSVFileReader.h"
+#include "LoadReport.h"
+#include "TimeStampIndex.h"
+#include "ProductShard.h"
+#include "NumaTopology.h"
+#include "ParallelFor.h"
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
+#include <unordered_map>
+
+/** Structure is used to locate the SDBEs sharing one timestamp within the time-ordered collection */
+struct TimeStepRange
+{
+    // Timestamp shared by the SDBEs, formatted for display and in microseconds since 1970/01/01
+    std::string timestamp;
+    std::int64_t time;
+
+    // Positions [begin, end) of the SDBEs within the collection
+    std::size_t begin;
+    std::size_t end;
+};
+
+/** Structure is used to summarize the SDBEs of one product and type within one time step */
+struct TimeStepAggregate
+{
+    // Number of SDBEs summarized
+    std::size_t entries = 0;
+
+    // Sums used for unweighted and volume-weighted averages
+    double sumPrice = 0;
+    double sumAmount = 0;
+    double sumPriceAmount = 0;
+
+    // Price range, only meaningful when entries is non-zero
+    double minPrice = 0;
+    double maxPrice = 0;
+};
+
+/** Structure is used to hold the per time step aggregates of both sides of one product */
+struct ProductAggregates
+{
+    // Indexed by the position of the time step within getTimeSteps()
+    std::vector<TimeStepAggregate> bids;
+    std::vector<TimeStepAggregate> asks;
+};
 
 /** Structure is used to return two values from getMinMaxPrice() */
 struct MinMaxPair
@@ -16,33 +60,166 @@ struct MinMaxPair
 class StocksDataBook
 {
 public:
+    /** Initialize an empty dataset, to be filled by appending SDBEs */
+    StocksDataBook();
+
     /** Parse the CSV file and convert valid lines into SDBEs */
     StocksDataBook(std::string filename);
 
-    /** Return all unique products in the dataset */
-    std::vector<std::string> getUniqueProducts();
+    /** Parse several files covering the same session concurrently and merge them into one time-ordered dataset */
+    StocksDataBook(std::vector<std::string> filenames, const CSVReadOptions& options = CSVReadOptions{});
+
+    /** Return the names of the files the dataset was loaded from, indexed by source tag */
+    const std::vector<std::string>& getSourceFilenames() const;
+
+    /** Return all unique products in the dataset, as indexed by buildDerivedIndexes() */
+    const std::vector<std::string>& getUniqueProducts() const;
+
+    /** Return the dataset's name for a product matched regardless of case, or null if the dataset does not hold it */
+    const std::string* findProduct(std::string_view product) const;
 
     /** Return SDBEs according to the filter parameters */
     std::vector<StocksDataBookEntry> filterSDBEentries(StocksDataBookType type,
-                                                  std::string product,
-                                                  std::string timestamp);
+                                                  const std::string& product,
+                                                  const std::string& timestamp) const;
+
+    /** Return the SDBEs of one source file according to the filter parameters */
+    std::vector<StocksDataBookEntry> filterSourceSDBEentries(std::uint16_t source,
+                                                        StocksDataBookType type,
+                                                        const std::string& product,
+                                                        const std::string& timestamp) const;
+
+    /** Return the SDBEs of a product and type within a time range and price range, visiting only the product's shard */
+    std::vector<StocksDataBookEntry> filterSDBEentries(StocksDataBookType type,
+                                                  const std::string& product,
+                                                  std::int64_t fromTime,
+                                                  std::int64_t toTime,
+                                                  double minPrice,
+                                                  double maxPrice) const;
+
+    /** Summarize the SDBEs of a product and type within a time range, visiting only the product's shard */
+    TimeStepAggregate aggregateSDBEentries(StocksDataBookType type, const std::string& product, std::int64_t fromTime, std::int64_t toTime) const;
+
+    /** Append SDBEs to the dataset, keeping it in time order and maintaining the time step index and product shards */
+    void appendSDBEentries(std::vector<StocksDataBookEntry> entries);
 
     /** Return the maximum and minimum price within SDBE collection */
-    MinMaxPair getMinMaxPrice(std::vector<StocksDataBookEntry>& SDBEcollection);
+    MinMaxPair getMinMaxPrice(const std::vector<StocksDataBookEntry>& SDBEcollection) const;
 
     /** Return the initial timestamp in the StocksDataBook */
-    std::string getEarliestTimeStamp();
+    std::string getEarliestTimeStamp() const;
 
     /** Return the next timestamp after the timestamp passed in, in a circular manner */
-    std::string getNextTimeStamp(std::string timestamp);
+    std::string getNextTimeStamp(const std::string& timestamp) const;
 
     /** Return the timestamp before the timestamp passed in, in a circular manner */
-    std::string getPreviousTimeStamp(std::string timestamp);
+    std::string getPreviousTimeStamp(const std::string& timestamp) const;
+
+    /** Return the report generated while loading the CSV file */
+    const LoadReport& getLoadReport() const;
+
+    /** Record the files and load report of a dataset whose SDBEs were appended as they were parsed */
+    void recordLoad(const std::vector<std::string>& filenames, const LoadReport& fileLoadReport);
+
+    /** Return all SDBEs in the dataset in time order */
+    const std::vector<StocksDataBookEntry>& getEntries() const;
+
+    /** Return the distinct timestamps of the dataset along with the positions of their SDBEs */
+    const std::vector<TimeStepRange>& getTimeSteps() const;
+
+    /** Return the position of a timestamp among the distinct timestamps, or -1 if it does not occur */
+    long findTimeStep(const std::string& timestamp) const;
+
+    /** Return the position of a timestamp in microseconds among the distinct timestamps, or -1 if it does not occur */
+    long findTimeStep(std::int64_t time) const;
+
+    /** Return the index of the distinct timestamps parsed into microseconds, for seeks and range queries */
+    const TimeStampIndex& getTimeStampIndex() const;
+
+    /** Return the per time step aggregates of a product and type, as built by buildDerivedIndexes() */
+    const std::vector<TimeStepAggregate>& getTimeStepAggregates(const std::string& product, StocksDataBookType type) const;
+
+    /** Build the unique products and per time step aggregates, which the const accessors only read */
+    void buildDerivedIndexes();
+
+    /** Return the shard holding the SDBEs of a product, or null if the product does not exist */
+    const ProductShard* findShard(const std::string& product) const;
+
+    /** Return the per-product shards, in order of each product's first SDBE */
+    const std::vector<ProductShard>& getShards() const;
+
+    /** Spread the shards across the NUMA nodes and move the columns of each shard onto its node */
+    void placeShards();
+
+    /** Call a function with each shard, on a thread running on the shard's NUMA node */
+    template <typename Function>
+    void forEachShard(Function function)
+    {
+        ParallelFor::run(shards.size(), [&](std::size_t i)
+        {
+            NumaNodeBinding binding{ shards[i].numaNode };
+            function(shards[i]);
+        });
+    }
+
+    /** Load the SDBEs of a single CSV file or book archive, canonicalizing their products */
+    static std::vector<StocksDataBookEntry> loadFile(const std::string& filename, LoadReport& loadReport, const CSVReadOptions& options);
 
 private:
+    /** Canonicalize a product symbol by removing surrounding whitespace and converting it to upper case */
+    static void canonicalizeProduct(std::string& product);
+
+    /** Canonicalize the product symbol of every SDBE */
+    static void canonicalizeProducts(std::vector<StocksDataBookEntry>& entries);
+
+    /** Group the time-ordered SDBEs from a position onwards into ranges sharing one timestamp */
+    void buildTimeStepIndex(std::size_t firstEntry);
+
+    /** Collect the unique products and index them by name regardless of case */
+    void buildUniqueProducts();
+
+    /** Summarize the SDBEs of every product, type and time step, each shard on its own node */
+    void buildTimeStepAggregates();
+
+    /** Split the time-ordered SDBEs from a position onwards into the shards of their products */
+    void buildShards(std::size_t firstEntry);
+
+    /** Hash a product name regardless of case */
+    static std::uint64_t hashProductName(std::string_view product);
+
+    /** Files the dataset was loaded from, indexed by source tag */
+    std::vector<std::string> sourceFilenames;
+
     /** Collection of SDBE entries */
     std::vector<StocksDataBookEntry> SDBEcollection;
 
+    /** Distinct timestamps in time order, with the range of SDBEs at each */
+    std::vector<TimeStepRange> timeSteps;
+
+    /** Distinct timestamps in microseconds, parallel to timeSteps */
+    TimeStampIndex timeStampIndex;
+
+    /** Columns and time step index of each product's SDBEs */
+    std::vector<ProductShard> shards;
+
+    /** Position of each product's shard within shards */
+    std::unordered_map<std::string, std::size_t> shardPositions;
+
+    /** Per time step aggregates of each product, empty until built by buildDerivedIndexes() */
+    std::unordered_map<std::string, ProductAggregates> timeStepAggregates;
+
+    /** True once timeStepAggregates has been built, as it stays empty for an empty dataset */
+    bool timeStepAggregatesBuilt = false;
+
     /** All unique products in the dataset */
     std::vector<std::string> uniqueProducts;
+
+    /** Positions within uniqueProducts keyed by the case-insensitive hash of each name, built along with them */
+    std::unordered_multimap<std::uint64_t, std::size_t> productPositions;
+
+    /** True once uniqueProducts and productPositions have been built, as they stay empty for an empty dataset */
+    bool uniqueProductsBuilt = false;
+
+    /** Statistics gathered while loading the CSV file */
+    LoadReport loadReport;
 };
\ No newline at end of file
@@ -1,17 +1,18 @@
 #include "StocksDataBookEntry.h"
+#include "TimeStamp.h"
 
 /** Initialize the fields of a baseline SDBE in the dataset
  *
  *  @param _price Entry price
  *  @param _amount Entry amount
- *  @param _timestamp Current timestamp in simulation
+ *  @param _timestamp Timestamp in microseconds since 1970/01/01
  *  @param _product Product name
  *  @param _SDBEtype SDBE type - ask/bid/unknown
  * 
  */
 StocksDataBookEntry::StocksDataBookEntry(double _price,
     double _amount,
-    std::string _timestamp,
+    std::int64_t _timestamp,
     std::string _product,
     StocksDataBookType _SDBEtype)
     : price(_price),
@@ -22,13 +23,23 @@ StocksDataBookEntry::StocksDataBookEntry(double _price,
 { 
 }
 
+/** Return the timestamp formatted for display
+ *
+ *  @return timestamp in the "YYYY/MM/DD HH:MM:SS.ffffff" format of the exchange dumps
+ *
+ */
+std::string StocksDataBookEntry::getTimestampString() const
+{
+    return TimeStamp::format(timestamp);
+}
+
 /** Convert a string to a StocksDataBookType (SDBT)
  *
  *  @param inputString String to be matched against an enumeration constant
  *  @return enumerator representing the StocksDataBookType
  *
  */
-StocksDataBookType StocksDataBookEntry::stringToStocksDataBookType(std::string inputString)
+StocksDataBookType StocksDataBookEntry::stringToStocksDataBookType(std::string_view inputString)
 {
     // Match input string to ask 
     if (inputString == "ask")
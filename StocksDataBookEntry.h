@@ -1,6 +1,9 @@
 #pragma once
 
+#include "FixedPoint.h"
+#include <cstdint>
 #include <string>
+#include <string_view>
 
 /** Establish valid SDBE types */
 enum class StocksDataBookType
@@ -16,17 +19,27 @@ public:
     /** Initialize the fields of a baseline SDBE in the dataset */
     StocksDataBookEntry(double _price,
                         double _amount,
-                        std::string _timestamp,
+                        std::int64_t _timestamp,
                         std::string _product,
                         StocksDataBookType _SDBEtype);
 
+    /** Return the timestamp formatted for display */
+    std::string getTimestampString() const;
+
     /** Convert a string to an SDBT */
-    static StocksDataBookType stringToStocksDataBookType(std::string inputString);
+    static StocksDataBookType stringToStocksDataBookType(std::string_view inputString);
 
     // Parameters for each SDBE
     double price;
     double amount;
-    std::string timestamp;
+    // Microseconds since 1970/01/01, parsed once at ingest
+    std::int64_t timestamp;
     std::string product;
     StocksDataBookType SDBEtype;
+    // Position of the file the SDBE was loaded from, within the list of files the dataset was built from
+    std::uint16_t source = 0;
+    // Number of decimals the price and amount were written with, FixedPoint::noDecimals if not parsed in fixed-point
+    // mode. Their units are recovered from the doubles with FixedPoint::fromDouble(), so that they take no space here
+    std::uint8_t priceDecimals = FixedPoint::noDecimals;
+    std::uint8_t amountDecimals = FixedPoint::noDecimals;
 };
\ No newline at end of file
@@ -0,0 +1,229 @@
+#include "TimeStamp.h"
+#include <cstdio>
+
+namespace
+{
+    /** Read a fixed number of decimal digits, returning -1 if any character is not a digit */
+    inline int readDigits(const char* text, int count)
+    {
+        int value = 0;
+        for (int i = 0; i < count; ++i)
+        {
+            unsigned digit = static_cast<unsigned>(text[i] - '0');
+            if (digit > 9)
+            {
+                return -1;
+            }
+            value = value * 10 + static_cast<int>(digit);
+        }
+        return value;
+    }
+
+    /** Write a non-negative value as a fixed number of decimal digits, most significant first */
+    inline void writeDigits(char* text, int count, std::int64_t value)
+    {
+        for (int i = count - 1; i >= 0; --i)
+        {
+            text[i] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        }
+    }
+}
+
+/** Convert a "YYYY/MM/DD HH:MM:SS.ffffff" timestamp into microseconds since 1970/01/01, or -1 if it is malformed
+ *
+ *  @param timestamp Timestamp in the format of the exchange dumps, the fractional part being optional
+ *  @return          microseconds since 1970/01/01, or -1 if the timestamp cannot be parsed
+ *
+ */
+std::int64_t TimeStamp::parse(const std::string& timestamp)
+{
+    return parse(timestamp.data(), timestamp.size());
+}
+
+/** Convert a "YYYY/MM/DD HH:MM:SS.ffffff" timestamp held in a character range into microseconds since 1970/01/01, or -1 if it is malformed
+ *
+ *  The zero-padded layout of the exchange dumps is decoded at fixed offsets without any library calls.
+ *  Other layouts, such as single-digit fields, fall back to a slower variable-width parse
+ *
+ *  @param text   First character of the timestamp, not necessarily null-terminated
+ *  @param length Number of characters in the timestamp
+ *  @return       microseconds since 1970/01/01, or -1 if the timestamp cannot be parsed
+ *
+ */
+std::int64_t TimeStamp::parse(const char* text, std::size_t length)
+{
+    // Fixed layout: "YYYY/MM/DD HH:MM:SS" followed by nothing or by '.' and one to six fractional digits
+    if (length >= 19 && length != 20 && length <= 26 && text[4] == '/' && text[7] == '/' && text[10] == ' '
+        && text[13] == ':' && text[16] == ':' && (length == 19 || text[19] == '.'))
+    {
+        int year = readDigits(text, 4);
+        int month = readDigits(text + 5, 2);
+        int day = readDigits(text + 8, 2);
+        int hour = readDigits(text + 11, 2);
+        int minute = readDigits(text + 14, 2);
+        int second = readDigits(text + 17, 2);
+
+        // Scale the fractional digits to microseconds
+        int fractionDigits = length > 20 ? static_cast<int>(length) - 20 : 0;
+        int fraction = readDigits(text + 20, fractionDigits);
+        static const int scale[7] = { 1000000, 100000, 10000, 1000, 100, 10, 1 };
+
+        if ((year | month | day | hour | minute | second | fraction) >= 0)
+        {
+            return toMicroseconds(year, month, day, hour, minute, second, static_cast<std::int64_t>(fraction) * scale[fractionDigits]);
+        }
+    }
+    return parseVariableWidth(std::string(text, length));
+}
+
+/** Parse timestamps whose fields are not zero-padded to a fixed width
+ *
+ *  @param timestamp Timestamp such as "2020/6/1 9:05:30.5"
+ *  @return          microseconds since 1970/01/01, or -1 if the timestamp cannot be parsed
+ *
+ */
+std::int64_t TimeStamp::parseVariableWidth(const std::string& timestamp)
+{
+    int year, month, day, hour, minute, second;
+    char fraction[8] = "";
+    int secondsEnd = -1;
+    int fractionEnd = -1;
+
+    // The fractional seconds are read as digits so that "5" means 500000 microseconds
+    int fields = std::sscanf(timestamp.c_str(), "%d/%d/%d %d:%d:%d%n.%7[0-9]%n", &year, &month, &day, &hour, &minute, &second, &secondsEnd, fraction, &fractionEnd);
+    if (fields < 6)
+    {
+        return -1;
+    }
+
+    // The fields must make up the whole timestamp, without trailing characters
+    int fieldsEnd = fields == 7 ? fractionEnd : secondsEnd;
+    if (fieldsEnd < 0 || static_cast<std::size_t>(fieldsEnd) != timestamp.size())
+    {
+        return -1;
+    }
+
+    // Scale the fractional digits to microseconds
+    std::int64_t microsecond = 0;
+    int digits = 0;
+    for (; digits < 6 && fraction[digits] != '\0'; ++digits)
+    {
+        microsecond = microsecond * 10 + (fraction[digits] - '0');
+    }
+    for (; digits < 6; ++digits)
+    {
+        microsecond *= 10;
+    }
+
+    // Out of range months, days, hours, minutes and seconds are rejected there
+    return toMicroseconds(year, month, day, hour, minute, second, microsecond);
+}
+
+/** Combine validated date and time fields into microseconds since 1970/01/01
+ *
+ *  @param year        Year
+ *  @param month       Month in [1, 12]
+ *  @param day         Day in [1, 31]
+ *  @param hour        Hour in [0, 23]
+ *  @param minute      Minute in [0, 59]
+ *  @param second      Second in [0, 60]
+ *  @param microsecond Microsecond within the second
+ *  @return            microseconds since 1970/01/01, or -1 if a field is out of range
+ *
+ */
+std::int64_t TimeStamp::toMicroseconds(int year, int month, int day, int hour, int minute, int second, std::int64_t microsecond)
+{
+    if (month < 1 || month > 12 || day < 1 || day > 31 || hour < 0 || hour > 23 || minute < 0 || minute > 59 || second < 0 || second > 60)
+    {
+        return -1;
+    }
+    return daysFromCivil(year, month, day) * microsecondsPerDay
+        + ((hour * 60LL + minute) * 60LL + second) * microsecondsPerSecond + microsecond;
+}
+
+/** Convert microseconds since 1970/01/01 into a "YYYY/MM/DD HH:MM:SS.ffffff" timestamp
+ *
+ *  @param microseconds Microseconds since 1970/01/01
+ *  @return             timestamp in the format of the exchange dumps
+ *
+ */
+std::string TimeStamp::format(std::int64_t microseconds)
+{
+    // Split into the day and the time within the day, rounding towards the past
+    std::int64_t days = microseconds / microsecondsPerDay;
+    std::int64_t timeOfDay = microseconds % microsecondsPerDay;
+    if (timeOfDay < 0)
+    {
+        timeOfDay += microsecondsPerDay;
+        --days;
+    }
+
+    std::int64_t year;
+    unsigned month, day;
+    civilFromDays(days, year, month, day);
+
+    // Years outside four digits are rare enough to take the general path
+    if (year < 0 || year > 9999)
+    {
+        char buffer[48];
+        std::snprintf(buffer, sizeof(buffer), "%04lld/%02u/%02u %02lld:%02lld:%02lld.%06lld",
+            static_cast<long long>(year), month, day,
+            static_cast<long long>(timeOfDay / (3600 * microsecondsPerSecond)),
+            static_cast<long long>(timeOfDay / (60 * microsecondsPerSecond) % 60),
+            static_cast<long long>(timeOfDay / microsecondsPerSecond % 60),
+            static_cast<long long>(timeOfDay % microsecondsPerSecond));
+        return buffer;
+    }
+
+    // Write the fixed layout digit by digit
+    std::string timestamp = "0000/00/00 00:00:00.000000";
+    writeDigits(&timestamp[0], 4, year);
+    writeDigits(&timestamp[5], 2, month);
+    writeDigits(&timestamp[8], 2, day);
+    writeDigits(&timestamp[11], 2, timeOfDay / (3600 * microsecondsPerSecond));
+    writeDigits(&timestamp[14], 2, timeOfDay / (60 * microsecondsPerSecond) % 60);
+    writeDigits(&timestamp[17], 2, timeOfDay / microsecondsPerSecond % 60);
+    writeDigits(&timestamp[20], 6, timeOfDay % microsecondsPerSecond);
+    return timestamp;
+}
+
+/** Convert a civil date into the number of days since 1970/01/01
+ *
+ *  @param year  Year
+ *  @param month Month in [1, 12]
+ *  @param day   Day in [1, 31]
+ *  @return      days since 1970/01/01, negative for earlier dates
+ *
+ */
+std::int64_t TimeStamp::daysFromCivil(std::int64_t year, unsigned month, unsigned day)
+{
+    // Count years from March so that the leap day falls at the end of the year
+    year -= month <= 2;
+    const std::int64_t era = (year >= 0 ? year : year - 399) / 400;
+    const unsigned yearOfEra = static_cast<unsigned>(year - era * 400);
+    const unsigned dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    const unsigned dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + static_cast<std::int64_t>(dayOfEra) - 719468;
+}
+
+/** Convert a number of days since 1970/01/01 into a civil date
+ *
+ *  @param days  Days since 1970/01/01
+ *  @param year  Receives the year
+ *  @param month Receives the month in [1, 12]
+ *  @param day   Receives the day in [1, 31]
+ *
+ */
+void TimeStamp::civilFromDays(std::int64_t days, std::int64_t& year, unsigned& month, unsigned& day)
+{
+    days += 719468;
+    const std::int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+    const unsigned dayOfEra = static_cast<unsigned>(days - era * 146097);
+    const unsigned yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    const unsigned dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    const unsigned monthPrime = (5 * dayOfYear + 2) / 153;
+    day = dayOfYear - (153 * monthPrime + 2) / 5 + 1;
+    month = monthPrime < 10 ? monthPrime + 3 : monthPrime - 9;
+    year = static_cast<std::int64_t>(yearOfEra) + era * 400 + (month <= 2);
+}
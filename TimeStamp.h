@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+class TimeStamp
+{
+public:
+    /** Convert a "YYYY/MM/DD HH:MM:SS.ffffff" timestamp into microseconds since 1970/01/01, or -1 if it is malformed */
+    static std::int64_t parse(const std::string& timestamp);
+
+    /** Convert a "YYYY/MM/DD HH:MM:SS.ffffff" timestamp held in a character range into microseconds since 1970/01/01, or -1 if it is malformed */
+    static std::int64_t parse(const char* text, std::size_t length);
+
+    /** Convert microseconds since 1970/01/01 into a "YYYY/MM/DD HH:MM:SS.ffffff" timestamp */
+    static std::string format(std::int64_t microseconds);
+
+    /** Number of microseconds in one second */
+    static constexpr std::int64_t microsecondsPerSecond = 1000000;
+
+    /** Number of microseconds in one day */
+    static constexpr std::int64_t microsecondsPerDay = 86400 * microsecondsPerSecond;
+
+private:
+    /** Parse timestamps whose fields are not zero-padded to a fixed width */
+    static std::int64_t parseVariableWidth(const std::string& timestamp);
+
+    /** Combine validated date and time fields into microseconds since 1970/01/01 */
+    static std::int64_t toMicroseconds(int year, int month, int day, int hour, int minute, int second, std::int64_t microsecond);
+
+    /** Convert a civil date into the number of days since 1970/01/01 */
+    static std::int64_t daysFromCivil(std::int64_t year, unsigned month, unsigned day);
+
+    /** Convert a number of days since 1970/01/01 into a civil date */
+    static void civilFromDays(std::int64_t days, std::int64_t& year, unsigned& month, unsigned& day);
+};
@@ -0,0 +1,139 @@
+#include "TimeStampIndex.h"
+#include "TimeStamp.h"
+#include <algorithm>
+#include <utility>
+
+/** Initialize an empty index */
+TimeStampIndex::TimeStampIndex()
+{
+}
+
+/** Initialize an index over the distinct timestamps of a dataset, in microseconds and in time order
+ *
+ *  @param _times Distinct timestamps in microseconds since 1970/01/01, in time order
+ *
+ */
+TimeStampIndex::TimeStampIndex(std::vector<std::int64_t> _times)
+    : times(std::move(_times))
+{
+}
+
+/** Return the number of distinct timestamps
+ *
+ *  @return number of distinct timestamps
+ *
+ */
+std::size_t TimeStampIndex::size() const
+{
+    return times.size();
+}
+
+/** Return the distinct timestamps in microseconds, in time order
+ *
+ *  @return timestamps, one per time step of the dataset
+ *
+ */
+const std::vector<std::int64_t>& TimeStampIndex::getTimes() const
+{
+    return times;
+}
+
+/** Return the position of the latest timestamp at or before a time, or -1 if the index is empty
+ *
+ *  @param time Microseconds since 1970/01/01
+ *  @return     position of the time step in effect at the time, 0 for times before the first timestamp
+ *
+ */
+long TimeStampIndex::seek(std::int64_t time) const
+{
+    if (times.empty())
+    {
+        return -1;
+    }
+
+    // Binary search over the distinct timestamps only
+    auto it = std::upper_bound(times.begin(), times.end(), time);
+    return it == times.begin() ? 0 : static_cast<long>(it - times.begin()) - 1;
+}
+
+/** Find the positions [begin, end) of the timestamps within a closed time range
+ *
+ *  @param from  Start of the range in microseconds, inclusive
+ *  @param to    End of the range in microseconds, inclusive
+ *  @param begin Receives the position of the first timestamp in the range
+ *  @param end   Receives the position after the last timestamp in the range, equal to begin if the range is empty
+ *
+ */
+void TimeStampIndex::findRange(std::int64_t from, std::int64_t to, std::size_t& begin, std::size_t& end) const
+{
+    begin = static_cast<std::size_t>(std::lower_bound(times.begin(), times.end(), from) - times.begin());
+    end = std::max(begin, static_cast<std::size_t>(std::upper_bound(times.begin(), times.end(), to) - times.begin()));
+}
+
+/** Convert a full timestamp, or a time of day on the date of a reference time, into microseconds
+ *
+ *  @param text          "YYYY/MM/DD HH:MM:SS.ffffff", or "HH:MM", "HH:MM:SS" or "HH:MM:SS.ffffff"
+ *  @param referenceTime Microseconds since 1970/01/01 whose date applies to a time of day
+ *  @return              microseconds since 1970/01/01, or -1 if the text cannot be parsed
+ *
+ */
+std::int64_t TimeStampIndex::resolve(const std::string& text, std::int64_t referenceTime)
+{
+    // A full timestamp carries its own date
+    if (text.find('/') != std::string::npos)
+    {
+        return TimeStamp::parse(text);
+    }
+
+    // Seconds may be omitted from a time of day
+    std::string timeOfDay = text;
+    if (std::count(timeOfDay.begin(), timeOfDay.end(), ':') == 1)
+    {
+        timeOfDay += ":00";
+    }
+    return TimeStamp::parse(TimeStamp::format(referenceTime).substr(0, 10) + " " + timeOfDay);
+}
+
+/** Parse a time range such as "11:57-12:03" into its bounds, resolved against a reference time
+ *
+ *  @param text          Two times of day, or two full timestamps without spaces, separated by '-'
+ *  @param referenceTime Microseconds since 1970/01/01 whose date applies to times of day
+ *  @param from          Receives the start of the range
+ *  @param to            Receives the end of the range
+ *  @return              true if both bounds were parsed and the range is not reversed, false otherwise
+ *
+ */
+bool TimeStampIndex::parseRange(const std::string& text, std::int64_t referenceTime, std::int64_t& from, std::int64_t& to)
+{
+    std::size_t separator = text.find('-');
+    if (separator == std::string::npos)
+    {
+        return false;
+    }
+
+    std::string toText = text.substr(separator + 1);
+    from = resolve(text.substr(0, separator), referenceTime);
+    to = resolve(toText, referenceTime);
+    if (from < 0 || to < 0 || to < from)
+    {
+        return false;
+    }
+
+    // An end bound without seconds covers its whole minute, and one without fractional seconds its whole second
+    if (toText.find('.') == std::string::npos)
+    {
+        to += (std::count(toText.begin(), toText.end(), ':') == 1 ? 60 : 1) * TimeStamp::microsecondsPerSecond - 1;
+    }
+    return true;
+}
+
+/** Determine whether a command argument is a time range rather than a count
+ *
+ *  @param text Command argument
+ *  @return     true if the argument contains a range separator and a time, false otherwise
+ *
+ */
+bool TimeStampIndex::isRange(const std::string& text)
+{
+    return text.find('-') != std::string::npos && text.find(':') != std::string::npos;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class TimeStampIndex
+{
+public:
+    /** Initialize an empty index */
+    TimeStampIndex();
+
+    /** Initialize an index over the distinct timestamps of a dataset, in microseconds and in time order */
+    TimeStampIndex(std::vector<std::int64_t> _times);
+
+    /** Return the number of distinct timestamps */
+    std::size_t size() const;
+
+    /** Return the distinct timestamps in microseconds, in time order */
+    const std::vector<std::int64_t>& getTimes() const;
+
+    /** Return the position of the latest timestamp at or before a time, or -1 if the index is empty */
+    long seek(std::int64_t time) const;
+
+    /** Find the positions [begin, end) of the timestamps within a closed time range */
+    void findRange(std::int64_t from, std::int64_t to, std::size_t& begin, std::size_t& end) const;
+
+    /** Convert a full timestamp, or a time of day on the date of a reference time, into microseconds */
+    static std::int64_t resolve(const std::string& text, std::int64_t referenceTime);
+
+    /** Parse a time range such as "11:57-12:03" into its bounds, resolved against a reference time */
+    static bool parseRange(const std::string& text, std::int64_t referenceTime, std::int64_t& from, std::int64_t& to);
+
+    /** Determine whether a command argument is a time range rather than a count */
+    static bool isRange(const std::string& text);
+
+private:
+    /** Distinct timestamps in microseconds since 1970/01/01, in time order */
+    std::vector<std::int64_t> times;
+};
@@ -6,7 +6,7 @@ UserCommands::UserCommands() = default;
 /** Command 1: HELP - List all available commands */
 void UserCommands::Command1_HELP()
 {
-	std::cout << "The available commands are help, help <cmd>, prod, min, max, avg, predict, time, step, and median." << std::endl;
+	std::cout << "The available commands are help, help <cmd>, prod, min, max, avg, predict, time, step, median, report, depth, impact, vwap, vwmedian, volume, spread, candles, vol, zscore, corr, backtest, sweep, wallet, buy, sell, goto, back, forward, and status." << std::endl;
 }
 
 /** Command 2: HELP PROD - output help for the prod command */
@@ -36,7 +36,7 @@ void UserCommands::Command2_HELP_avg()
 /** Command 2: HELP PREDICT - output help for the predict command */
 void UserCommands::Command2_HELP_predict()
 {
-    std::cout << "Predict - this command predicts the max or min ask or bid for the sent product for the next time step.\nCommand syntax: predict max/min product ask/bid" << std::endl;
+    std::cout << "Predict - this command predicts the max or min ask or bid for the sent product for the next time step.\nCommand syntax: predict max/min product ask/bid, or predict max/min product ask/bid resolution to predict from candles" << std::endl;
 }
 
 /** Command 2: HELP TIME - output help for the time command */
@@ -57,11 +57,131 @@ void UserCommands::Command2_HELP_median()
     std::cout << "Median - this command finds the median ask or bid for the sent product over the sent number of time steps.\nCommand syntax: median product ask/bid time steps" << std::endl;
 }
 
+/** Command 2: HELP REPORT - output help for the report command */
+void UserCommands::Command2_HELP_report()
+{
+    std::cout << "Report - this command prints the bytes, rows, rejected rows, phase times and memory usage of the dataset load, or writes them to loadreport.json.\nCommand syntax: report, report json" << std::endl;
+}
+
+/** Command 2: HELP DEPTH - output help for the depth command */
+void UserCommands::Command2_HELP_depth()
+{
+    std::cout << "Depth - this command lists the best price levels of both sides of the book for a product in the current time step, with the cumulative amount at each level.\nCommand syntax: depth product levels" << std::endl;
+}
+
+/** Command 2: HELP IMPACT - output help for the impact command */
+void UserCommands::Command2_HELP_impact()
+{
+    std::cout << "Impact - this command computes the average fill price and price impact of filling an amount against the asks (buying) or bids (selling) of a product in the current time step.\nCommand syntax: impact product ask/bid amount" << std::endl;
+}
+
+/** Command 2: HELP VWAP - output help for the vwap command */
+void UserCommands::Command2_HELP_vwap()
+{
+    std::cout << "Vwap - this command finds the volume-weighted average ask or bid price for the sent product over the sent number of time steps.\nCommand syntax: vwap product ask/bid time steps\nThe time steps may also be given as a time range on the current date, e.g. 11:57-12:03, or as a duration up to the current time, e.g. 60s, 5m or 1h" << std::endl;
+}
+
+/** Command 2: HELP VWMEDIAN - output help for the vwmedian command */
+void UserCommands::Command2_HELP_vwmedian()
+{
+    std::cout << "Vwmedian - this command finds the price below which half of the ask or bid amount for the sent product lies over the sent number of time steps.\nCommand syntax: vwmedian product ask/bid time steps\nThe time steps may also be given as a time range on the current date, e.g. 11:57-12:03, or as a duration up to the current time, e.g. 60s, 5m or 1h" << std::endl;
+}
+
+/** Command 2: HELP VOLUME - output help for the volume command */
+void UserCommands::Command2_HELP_volume()
+{
+    std::cout << "Volume - this command finds the total ask or bid amount for the sent product over the sent number of time steps.\nCommand syntax: volume product ask/bid time steps\nThe time steps may also be given as a time range on the current date, e.g. 11:57-12:03, or as a duration up to the current time, e.g. 60s, 5m or 1h" << std::endl;
+}
+
+/** Command 2: HELP SPREAD - output help for the spread command */
+void UserCommands::Command2_HELP_spread()
+{
+    std::cout << "Spread - this command lists the best bid, best ask, spread, mid price and relative spread for the sent product over the sent number of time steps.\nCommand syntax: spread product time steps\nThe time steps may also be given as a time range on the current date, e.g. 11:57-12:03, or as a duration up to the current time, e.g. 60s, 5m or 1h" << std::endl;
+}
+
+/** Command 2: HELP VOL - output help for the vol command */
+void UserCommands::Command2_HELP_vol()
+{
+    std::cout << "Vol - this command computes the rolling standard deviation of the ask or bid price, and of its log returns, for the sent product over the sent number of time steps.\nCommand syntax: vol product ask/bid time steps" << std::endl;
+}
+
+/** Command 2: HELP ZSCORE - output help for the zscore command */
+void UserCommands::Command2_HELP_zscore()
+{
+    std::cout << "Zscore - this command computes how many standard deviations the current ask or bid price of the sent product lies from its mean over the sent number of time steps.\nCommand syntax: zscore product ask/bid time steps" << std::endl;
+}
+
+/** Command 2: HELP CORR - output help for the corr command */
+void UserCommands::Command2_HELP_corr()
+{
+    std::cout << "Corr - this command computes the correlation between the mid prices of every pair of products over the sent number of time steps.\nCommand syntax: corr time steps\nThe time steps may also be given as a time range on the current date, e.g. 11:57-12:03, or as a duration up to the current time, e.g. 60s, 5m or 1h" << std::endl;
+}
+
+/** Command 2: HELP BACKTEST - output help for the backtest command */
+void UserCommands::Command2_HELP_backtest()
+{
+    std::cout << "Backtest - this command replays every time step of the sent product through an EWMA strategy with the sent span, buying one unit when the predicted mid price exceeds the best ask and selling when it falls below the best bid, by more than the sent fractional threshold.\nCommand syntax: backtest product span threshold" << std::endl;
+}
+
+/** Command 2: HELP SWEEP - output help for the sweep command */
+void UserCommands::Command2_HELP_sweep()
+{
+    std::cout << "Sweep - this command evaluates EWMA spans from 2 to 50 time steps on every product, reporting the span with the lowest error when predicting the next time step's max and min ask or bid price, and the span and threshold for which the backtest strategy earned the most.\nCommand syntax: sweep ask/bid" << std::endl;
+}
+
+/** Command 2: HELP WALLET - output help for the wallet command */
+void UserCommands::Command2_HELP_wallet()
+{
+    std::cout << "Wallet - this command lists the balance of every currency in the simulated wallet, which starts with 10 BTC.\nCommand syntax: wallet" << std::endl;
+}
+
+/** Command 2: HELP BUY - output help for the buy command */
+void UserCommands::Command2_HELP_buy()
+{
+    std::cout << "Buy - this command buys up to the sent amount of the product's first currency from the asks of the current time step, at the sent price or lower, paying in its second currency. Any unfilled amount is cancelled.\nCommand syntax: buy product amount price" << std::endl;
+}
+
+/** Command 2: HELP SELL - output help for the sell command */
+void UserCommands::Command2_HELP_sell()
+{
+    std::cout << "Sell - this command sells up to the sent amount of the product's first currency to the bids of the current time step, at the sent price or higher, receiving its second currency. Any unfilled amount is cancelled.\nCommand syntax: sell product amount price" << std::endl;
+}
+
+/** Command 2: HELP GOTO - output help for the goto command */
+void UserCommands::Command2_HELP_goto()
+{
+    std::cout << "Goto - this command moves the simulation to the time step in effect at the sent timestamp, or at the sent time of day on the current date.\nCommand syntax: goto YYYY/MM/DD HH:MM:SS or goto HH:MM[:SS]" << std::endl;
+}
+
+/** Command 2: HELP BACK - output help for the back command */
+void UserCommands::Command2_HELP_back()
+{
+    std::cout << "Back - this command moves the simulation the sent number of time steps into the past, stopping at the earliest time step.\nCommand syntax: back time steps" << std::endl;
+}
+
+/** Command 2: HELP FORWARD - output help for the forward command */
+void UserCommands::Command2_HELP_forward()
+{
+    std::cout << "Forward - this command moves the simulation the sent number of time steps into the future, stopping at the latest time step.\nCommand syntax: forward time steps" << std::endl;
+}
+
+/** Command 2: HELP STATUS - output help for the status command */
+void UserCommands::Command2_HELP_status()
+{
+    std::cout << "Status - this command reports how much of the dataset has been loaded, as commands can run while the rest is loading.\nCommand syntax: status" << std::endl;
+}
+
+/** Command 2: HELP CANDLES - output help for the candles command */
+void UserCommands::Command2_HELP_candles()
+{
+    std::cout << "Candles - this command lists the open, high, low, close and volume of the ask or bid side of the sent product up to the current time step, at a resolution of time steps (e.g. 1t, 5t) or time (e.g. 30s, 1m, 1h).\nCommand syntax: candles product ask/bid resolution number of candles" << std::endl;
+}
+
 /** Command 3: PROD - list available products in the dataset */
 void UserCommands::Command3_PROD(AdvisorBot *advisorBot)
 {
     // Retrieve unique products from the dataset
-    std::vector<std::string> products = advisorBot->stocksDataBook.getUniqueProducts();
+    const std::vector<std::string>& products = advisorBot->book().getUniqueProducts();
 
     // Indicate that a product list will be displayed
     std::cout << "The unique products in the simulation include: ";
@@ -70,7 +190,7 @@ void UserCommands::Command3_PROD(AdvisorBot *advisorBot)
     int index = 0; 
 
     // Display formatted products to user
-    for (std::vector<std::string>::iterator it = products.begin(), end = products.end(); it != end; ++it, ++index)
+    for (std::vector<std::string>::const_iterator it = products.begin(), end = products.end(); it != end; ++it, ++index)
     {
         if (index != products.size() - 1)
         {
@@ -88,36 +208,27 @@ void UserCommands::Command3_PROD(AdvisorBot *advisorBot)
  *  @param SDBEtype    SDBE type - ask/bid/unknown
  *  @param product     Product name
  *  @param currentTime Current timestamp of simulation
- *  @return            Minimum price within filtered SDBE entries
+ *  @return            Minimum price within filtered SDBE entries, or 0 if there are none
  *
  */
-double UserCommands::Command4_MIN(std::string SDBEtype, std::string product, std::string currentTime, AdvisorBot *advisorBot)
+double UserCommands::Command4_MIN(const std::string& SDBEtype, const std::string& product, const std::string& currentTime, AdvisorBot *advisorBot)
 {
-    // Validate StocksDataBookEntry type
-    if (!validateSDBEtype(SDBEtype))
+    TimeStepAggregate aggregate = aggregateCurrentTimeStep(SDBEtype, product, currentTime, advisorBot);
+
+    // Provide feedback to user about minimum price and filter parameters entered
+    std::cout << "====================================" << std::endl;
+    if (aggregate.entries == 0)
     {
-        std::cout << "Three token user command failed. StocksDataBookEntry type not recognized." << std::endl;
-        throw std::exception{};
+        std::cout << "There are no " << SDBEtype << " entries for " << product << " in the current time step" << std::endl;
     }
-
-    // Validate product
-    if (!validateProduct(product,advisorBot))
+    else
     {
-        std::cout << "Three token user command failed. Product not recognized." << std::endl;
-        throw std::exception{};
+        std::cout << "The min " << SDBEtype << " for " << product << " is " << aggregate.minPrice << std::endl;
     }
-
-    // Filter out the dataset based on the SDBE type, product, and current time step of the simulation
-    std::vector<StocksDataBookEntry> StocksDataBookEntries = advisorBot->stocksDataBook.filterSDBEentries(StocksDataBookEntry::stringToStocksDataBookType(SDBEtype),
-        product, currentTime);
-
-    // Provide feedback to user about minimum price and filter parameters entered
-    std::cout << "====================================" << std::endl;
-    std::cout << "The min " << SDBEtype << " for " << product << " is " << advisorBot->stocksDataBook.getMinMaxPrice(StocksDataBookEntries).min << std::endl;
     std::cout << "====================================" << std::endl;
 
     // Retrieve the minimum price among the filtered entries
-    return advisorBot->stocksDataBook.getMinMaxPrice(StocksDataBookEntries).min;
+    return aggregate.minPrice;
 }
 
 /* Auxiliary function to compute minimum bid or ask for product in current time step without providing user feedback
@@ -127,28 +238,9 @@ double UserCommands::Command4_MIN(std::string SDBEtype, std::string product, std
  * @param currentTime Current timestamp of simulation
  *
  */
-double UserCommands::computeMin(std::string SDBEtype, std::string product, std::string currentTime, AdvisorBot* advisorBot)
+double UserCommands::computeMin(const std::string& SDBEtype, const std::string& product, const std::string& currentTime, AdvisorBot* advisorBot)
 {
-    // Validate StocksDataBookEntry type
-    if (!validateSDBEtype(SDBEtype))
-    {
-        std::cout << "Three token user command failed. StocksDataBookEntry type not recognized." << std::endl;
-        throw std::exception{};
-    }
-
-    // Validate product
-    if (!validateProduct(product, advisorBot))
-    {
-        std::cout << "Three token user command failed. Product not recognized." << std::endl;
-        throw std::exception{};
-    }
-
-    // Filter out the dataset based on the SDBE type, product, and current time step of the simulation
-    std::vector<StocksDataBookEntry> StocksDataBookEntries = advisorBot->stocksDataBook.filterSDBEentries(StocksDataBookEntry::stringToStocksDataBookType(SDBEtype),
-        product, currentTime);
-
-    // Retrieve the minimum price among the filtered entries
-    return advisorBot->stocksDataBook.getMinMaxPrice(StocksDataBookEntries).min;
+    return aggregateCurrentTimeStep(SDBEtype, product, currentTime, advisorBot).minPrice;
 }
 
 /** Command 5: MAX - find maximum bid or ask for product in current time step
@@ -156,39 +248,27 @@ double UserCommands::computeMin(std::string SDBEtype, std::string product, std::
  *  @param SDBEtype    SDBE type - ask/bid/unknown
  *  @param product     Product name
  *  @param currentTime Current timestamp of simulation
- *  @return            Maximum price within filtered SDBE entries
+ *  @return            Maximum price within filtered SDBE entries, or 0 if there are none
  *
  */
-double UserCommands::Command5_MAX(std::string SDBEtype, std::string product, std::string currentTime, AdvisorBot *advisorBot)
+double UserCommands::Command5_MAX(const std::string& SDBEtype, const std::string& product, const std::string& currentTime, AdvisorBot *advisorBot)
 {
-    // Validate StocksDataBookEntry type
-    if (!validateSDBEtype(SDBEtype))
+    TimeStepAggregate aggregate = aggregateCurrentTimeStep(SDBEtype, product, currentTime, advisorBot);
+
+    // Provide feedback to user about maximum price and filter parameters entered
+    std::cout << "====================================" << std::endl;
+    if (aggregate.entries == 0)
     {
-        std::cout << "Three token user command failed. StocksDataBookEntry type not recognized." << std::endl;
-        throw std::exception{};
+        std::cout << "There are no " << SDBEtype << " entries for " << product << " in the current time step" << std::endl;
     }
-
-    // Validate product
-    if (!validateProduct(product, advisorBot))
+    else
     {
-        std::cout << "Three token user command failed. Product not recognized." << std::endl;
-        throw std::exception{};
+        std::cout << "The max " << SDBEtype << " for " << product << " is " << aggregate.maxPrice << std::endl;
     }
-
-    // Filter out the dataset based on the SDBE type, product, and current time step of the simulation
-    std::vector<StocksDataBookEntry> StocksDataBookEntries = advisorBot->stocksDataBook.filterSDBEentries(StocksDataBookEntry::stringToStocksDataBookType(SDBEtype),
-        product, currentTime);
-
-    // Provide feedback to user about maximum price and filter parameters entered
-    std::cout << "====================================" << std::endl;
-    std::cout << "The max " << SDBEtype << " for " << product << " is " << advisorBot->stocksDataBook.getMinMaxPrice(StocksDataBookEntries).max << std::endl;
     std::cout << "====================================" << std::endl;
 
-    advisorBot->stocksDataBook.getMinMaxPrice(StocksDataBookEntries);
-
-
     // Retrieve the maximum price among the filtered entries
-    return advisorBot->stocksDataBook.getMinMaxPrice(StocksDataBookEntries).max;
+    return aggregate.maxPrice;
 }
 
 /* Auxiliary function to compute maximum bid or ask for product in current time step without providing user feedback 
@@ -198,7 +278,22 @@ double UserCommands::Command5_MAX(std::string SDBEtype, std::string product, std
  * @param currentTime Current timestamp of simulation
  * 
  */
-double UserCommands::computeMax(std::string SDBEtype, std::string product, std::string currentTime, AdvisorBot* advisorBot)
+double UserCommands::computeMax(const std::string& SDBEtype, const std::string& product, const std::string& currentTime, AdvisorBot* advisorBot)
+{
+    return aggregateCurrentTimeStep(SDBEtype, product, currentTime, advisorBot).maxPrice;
+}
+
+/** Validate the arguments of the min and max commands and summarize the SDBEs they select
+ *
+ *  The SDBEs of the current time step are summarized in place, rather than copied out of the dataset
+ *
+ *  @param SDBEtype    SDBE type - ask/bid/unknown
+ *  @param product     Product name
+ *  @param currentTime Current timestamp of simulation
+ *  @return            Count, min and max price of the SDBEs of the product and type at the current time step
+ *
+ */
+TimeStepAggregate UserCommands::aggregateCurrentTimeStep(const std::string& SDBEtype, const std::string& product, const std::string& currentTime, AdvisorBot* advisorBot)
 {
     // Validate StocksDataBookEntry type
     if (!validateSDBEtype(SDBEtype))
@@ -214,12 +309,8 @@ double UserCommands::computeMax(std::string SDBEtype, std::string product, std::
         throw std::exception{};
     }
 
-    // Filter out the dataset based on the SDBE type, product, and current time step of the simulation
-    std::vector<StocksDataBookEntry> StocksDataBookEntries = advisorBot->stocksDataBook.filterSDBEentries(StocksDataBookEntry::stringToStocksDataBookType(SDBEtype),
-        product, currentTime);
-
-    // Retrieve the maximum price among the filtered entries
-    return advisorBot->stocksDataBook.getMinMaxPrice(StocksDataBookEntries).max;
+    std::int64_t time = TimeStamp::parse(currentTime);
+    return advisorBot->book().aggregateSDBEentries(StocksDataBookEntry::stringToStocksDataBookType(SDBEtype), product, time, time);
 }
 
 /** Advance the timestamp in a circular manner */
@@ -230,7 +321,7 @@ void UserCommands::gotoNextTimeframe(AdvisorBot *advisorBot)
 
     /* Set current time to next timestamp
        If current timestamp is the last timestamp in the dataset, then it is set to the first timestamp */
-    advisorBot->currentTime = advisorBot->stocksDataBook.getNextTimeStamp(advisorBot->currentTime);
+    advisorBot->currentTime = advisorBot->book().getNextTimeStamp(advisorBot->currentTime);
 }
 
 /** Command 6: AVG - compute average bid or ask for product over sent number of time steps
@@ -242,7 +333,7 @@ void UserCommands::gotoNextTimeframe(AdvisorBot *advisorBot)
  *  @return             Average bid or ask price of a product for a given time frame
  *
  */
-double UserCommands::Command6_AVG(std::string SDBEtype, std::string product, std::string currentTime, std::string numTimesteps, AdvisorBot *advisorBot)
+double UserCommands::Command6_AVG(const std::string& SDBEtype, const std::string& product, const std::string& currentTime, const std::string& numTimesteps, AdvisorBot *advisorBot)
 {
     // Validate SDBE type
     if (!validateSDBEtype(SDBEtype))
@@ -259,8 +350,9 @@ double UserCommands::Command6_AVG(std::string SDBEtype, std::string product, std
     }
 
     // Validate time step
-    if (!validateTimeStep(numTimesteps))
+    if (isTimeWindow(numTimesteps) || !validateTimeStep(numTimesteps))
     {
+        // Time ranges are only served by the aggregate-backed commands
         std::cout << "Four token user command failed. Time step not recognized." << std::endl;
         throw std::exception{};
     }
@@ -277,33 +369,49 @@ double UserCommands::Command6_AVG(std::string SDBEtype, std::string product, std
     // Record the sum of the averages of the number of time steps considered
     double totalAvgAllTimesteps = 0;
 
+    // Products loaded in fixed-point mode are summed exactly in ticks
+    const ProductShard* shard = advisorBot->book().findShard(product);
+    bool fixedPoint = shard != nullptr && shard->hasFixedPoint();
+
     // Compute averages for each time step
     for (size_t i = 0; i < totalTimesteps; ++i)
     {
-        // Filter dataset into relevant subset of entries based on input parameters
-        StocksDataBookEntries = advisorBot->stocksDataBook.filterSDBEentries(StocksDataBookEntry::stringToStocksDataBookType(SDBEtype),
-            product, currentTimeStep);
-
         double avgPriceOneTimestep = 0;
+        std::int64_t sumPriceTicks = 0;
+        std::size_t numTicks = 0;
+        std::int64_t time = fixedPoint ? TimeStamp::parse(currentTimeStep) : 0;
 
-        // Compute total price accumulated over one time step
-        for (const StocksDataBookEntry& e : StocksDataBookEntries)
+        if (fixedPoint && shard->sumPriceTicks(shard->lowerBound(time), shard->upperBound(time),
+            StocksDataBookEntry::stringToStocksDataBookType(SDBEtype), sumPriceTicks, numTicks))
         {
-            avgPriceOneTimestep += e.price;
+            // Convert to a price only once the time step is summed
+            avgPriceOneTimestep = FixedPoint::toDouble(sumPriceTicks, shard->getPriceDecimals(), numTicks);
         }
+        else
+        {
+            // Filter dataset into relevant subset of entries based on input parameters
+            StocksDataBookEntries = advisorBot->book().filterSDBEentries(StocksDataBookEntry::stringToStocksDataBookType(SDBEtype),
+                product, currentTimeStep);
 
-        // Record the number of entries in the filtered subset
-        int numEntries = StocksDataBookEntries.size();
+            // Compute total price accumulated over one time step
+            for (const StocksDataBookEntry& e : StocksDataBookEntries)
+            {
+                avgPriceOneTimestep += e.price;
+            }
 
-        /* Compute average price for one time step
-        Avoid divide by zero exception if the filtered subset is empty */
-        avgPriceOneTimestep = numEntries != 0 ? avgPriceOneTimestep / StocksDataBookEntries.size() : 0;
+            // Record the number of entries in the filtered subset
+            int numEntries = StocksDataBookEntries.size();
+
+            /* Compute average price for one time step
+            Avoid divide by zero exception if the filtered subset is empty */
+            avgPriceOneTimestep = numEntries != 0 ? avgPriceOneTimestep / StocksDataBookEntries.size() : 0;
+        }
 
         // Provide user feedback for the average price for each time step before the initial timestamp
         std::cout << "Average price " << i << " time step(s) ago: " << avgPriceOneTimestep << " - Time: " << currentTimeStep << std::endl;
 
         // Move simulation one time step into the past in a circular manner
-        currentTimeStep = advisorBot->stocksDataBook.getPreviousTimeStamp(currentTimeStep);
+        currentTimeStep = advisorBot->book().getPreviousTimeStamp(currentTimeStep);
 
         // Add average price of individual time step to total sum
         totalAvgAllTimesteps += avgPriceOneTimestep;
@@ -327,7 +435,7 @@ double UserCommands::Command6_AVG(std::string SDBEtype, std::string product, std
  *  @return            Predicted price based on a 10 time step EWMA
  *
  */
-double UserCommands::Command7_PREDICT(std::string product, std::string maxOrMin, std::string currentTime, std::string SDBEtype, AdvisorBot *advisorBot)
+double UserCommands::Command7_PREDICT(const std::string& product, const std::string& maxOrMin, const std::string& currentTime, const std::string& SDBEtype, AdvisorBot *advisorBot)
 {
     // Validate product
     if (!validateProduct(product,advisorBot))
@@ -384,6 +492,52 @@ double UserCommands::Command7_PREDICT(std::string product, std::string maxOrMin,
     return EWMAresult;
 }
 
+/** Command 7: PREDICT - predict max or min bid or ask for sent product for the next candle based on an EWMA of candle highs or lows
+ *
+ *  @param maxOrMin    Maximum or minimum price to predict
+ *  @param product     Product name
+ *  @param SDBEtype    SDBE type - ask/bid/unknown
+ *  @param resolution  Candle resolution, e.g. 5t or 1m
+ *  @param currentTime Current timestamp of simulation
+ *  @return            Predicted price based on a 10 candle EWMA
+ *
+ */
+double UserCommands::Command7_PREDICT_candles(const std::string& maxOrMin, const std::string& product, const std::string& SDBEtype, const std::string& resolution, const std::string& currentTime, AdvisorBot *advisorBot)
+{
+    // Validate max or min
+    if (!validateMaxMin(maxOrMin))
+    {
+        std::cout << "Five token user command failed. Max or min not recognized." << std::endl;
+        throw std::exception{};
+    }
+
+    // Retrieve up to ten candles ending with the candle of the current time step
+    std::vector<Candle> candles = getCandlesUpToTime(product, SDBEtype, resolution, 10, currentTime, advisorBot);
+    if (candles.empty())
+    {
+        std::cout << "Five token user command failed. No candles up to the current time step." << std::endl;
+        throw std::exception{};
+    }
+
+    // Stack the candle highs or lows in the same order as the time step based prediction, newest at the bottom
+    std::stack<double> priceRecords;
+    enum MaxMinType maxMinType = stringToMaxMinType(maxOrMin);
+    for (std::size_t i = candles.size(); i-- > 0;)
+    {
+        priceRecords.push(maxMinType == MaxMinType::max ? candles[i].high : candles[i].low);
+    }
+
+    // Delegate computation of EWMA to auxiliary function
+    std::vector<double> intermediateEWMAs;
+    std::size_t numCandles = priceRecords.size();
+    double EWMAresult = computeEWMA(priceRecords, priceRecords.size(), intermediateEWMAs);
+
+    std::cout << "======================================================================================================================" << std::endl;
+    std::cout << "The predicted " << maxOrMin << " " << product << " " << SDBEtype << " price for the next " << resolution << " candle is " << EWMAresult << " based on a " << numCandles << " candle EWMA with an SF of 2/11" << std::endl;
+    std::cout << "======================================================================================================================" << std::endl;
+    return EWMAresult;
+}
+
 /** Compute the Exponential Weighted Moving Average (EWMA) by analyzing historical data in the past sent number of time steps
  *
  *  @param priceRecords       Price records spanning ten historical time steps
@@ -454,7 +608,7 @@ void UserCommands::Command9_STEP(AdvisorBot *advisorBot)
  *  @param numTimesteps Number of historical time steps to consider
  *
  */
-void UserCommands::computeMaxForPeriod(std::stack<double>& priceRecords, std::string SDBEtype, std::string product, std::string currentTime, std::string numTimesteps, AdvisorBot *advisorBot)
+void UserCommands::computeMaxForPeriod(std::stack<double>& priceRecords, const std::string& SDBEtype, const std::string& product, const std::string& currentTime, const std::string& numTimesteps, AdvisorBot *advisorBot)
 {
     // Record current timestamp in simulation
     std::string currentTimeStep = currentTime;
@@ -470,7 +624,7 @@ void UserCommands::computeMaxForPeriod(std::stack<double>& priceRecords, std::st
         priceRecords.push(maxPriceOneTimestep);
 
         // Move simulation one time step into the past
-        currentTimeStep = advisorBot->stocksDataBook.getPreviousTimeStamp(currentTimeStep);
+        currentTimeStep = advisorBot->book().getPreviousTimeStamp(currentTimeStep);
     }
 }
 
@@ -483,7 +637,7 @@ void UserCommands::computeMaxForPeriod(std::stack<double>& priceRecords, std::st
  *  @param numTimesteps Number of historical time steps to consider
  *
  */
-void UserCommands::computeMinForPeriod(std::stack<double>& priceRecords, std::string SDBEtype, std::string product, std::string currentTime, std::string numTimesteps, AdvisorBot *advisorBot)
+void UserCommands::computeMinForPeriod(std::stack<double>& priceRecords, const std::string& SDBEtype, const std::string& product, const std::string& currentTime, const std::string& numTimesteps, AdvisorBot *advisorBot)
 {
     // Record current timestamp in simulation
     std::string currentTimeStep = currentTime;
@@ -499,7 +653,7 @@ void UserCommands::computeMinForPeriod(std::stack<double>& priceRecords, std::st
         priceRecords.push(minPriceOneTimestep);
 
         // Move simulation one time step into the past
-        currentTimeStep = advisorBot->stocksDataBook.getPreviousTimeStamp(currentTimeStep);
+        currentTimeStep = advisorBot->book().getPreviousTimeStamp(currentTimeStep);
     }
 }
 
@@ -512,7 +666,7 @@ void UserCommands::computeMinForPeriod(std::stack<double>& priceRecords, std::st
  *  @return             Median price over a given time frame
  *
  */
-double UserCommands::Command10_MEDIAN(std::string SDBEtype, std::string product, std::string currentTime, std::string numTimesteps, AdvisorBot *advisorBot)
+double UserCommands::Command10_MEDIAN(const std::string& SDBEtype, const std::string& product, const std::string& currentTime, const std::string& numTimesteps, AdvisorBot *advisorBot)
 {
     // Validate SDBE type
     if (!validateSDBEtype(SDBEtype))
@@ -529,8 +683,9 @@ double UserCommands::Command10_MEDIAN(std::string SDBEtype, std::string product,
     }
 
     // Validate time step
-    if (!validateTimeStep(numTimesteps))
+    if (isTimeWindow(numTimesteps) || !validateTimeStep(numTimesteps))
     {
+        // Time ranges are only served by the aggregate-backed commands
         std::cout << "Four token user command failed. Time step not recognized." << std::endl;
         throw std::exception{};
     }
@@ -547,28 +702,49 @@ double UserCommands::Command10_MEDIAN(std::string SDBEtype, std::string product,
     // Store all prices for the specified number of time steps
     std::vector<double> priceRecords;
 
+    // Store all prices as ticks instead for products loaded in fixed-point mode
+    std::vector<std::int64_t> priceTickRecords;
+    const ProductShard* shard = advisorBot->book().findShard(product);
+    bool fixedPoint = shard != nullptr && shard->hasFixedPoint();
+
     // Storage for the median price of all relevant time steps
     double medianPrice = 0;
 
     // Begin from initial timestamp and iterate into past timestamps
     for (size_t i = 0; i < totalTimesteps; ++i)
     {
-        // Filter a subset of the dataset based on the SDBE type, product, and current time step
-        StocksDataBookEntries = advisorBot->stocksDataBook.filterSDBEentries(StocksDataBookEntry::stringToStocksDataBookType(SDBEtype),
-            product, currentTimeStep);
-
-        // Record each entry's price
-        for (const StocksDataBookEntry& e : StocksDataBookEntries)
+        if (fixedPoint)
+        {
+            // Record the price ticks of the rows at the time step
+            StocksDataBookType type = StocksDataBookEntry::stringToStocksDataBookType(SDBEtype);
+            std::int64_t time = TimeStamp::parse(currentTimeStep);
+            for (std::size_t row = shard->lowerBound(time), end = shard->upperBound(time); row < end; ++row)
+            {
+                if (shard->getTypes()[row] == type)
+                {
+                    priceTickRecords.push_back(shard->getPriceTicks()[row]);
+                }
+            }
+        }
+        else
         {
-            priceRecords.emplace_back(e.price);
+            // Filter a subset of the dataset based on the SDBE type, product, and current time step
+            StocksDataBookEntries = advisorBot->book().filterSDBEentries(StocksDataBookEntry::stringToStocksDataBookType(SDBEtype),
+                product, currentTimeStep);
+
+            // Record each entry's price
+            for (const StocksDataBookEntry& e : StocksDataBookEntries)
+            {
+                priceRecords.emplace_back(e.price);
+            }
         }
 
         // Move simulation one time step into the past
-        currentTimeStep = advisorBot->stocksDataBook.getPreviousTimeStamp(currentTimeStep);
+        currentTimeStep = advisorBot->book().getPreviousTimeStamp(currentTimeStep);
     }
 
     // Delegate computation of the price median to an auxiliary function
-    medianPrice = computeMedian(priceRecords);
+    medianPrice = fixedPoint ? computeMedian(priceTickRecords, shard->getPriceDecimals()) : computeMedian(priceRecords);
     std::cout << "======================================================================" << std::endl;
     std::cout << "The median " << product << " " << SDBEtype << " price over the last " << numTimesteps << " time step(s) was " << medianPrice << std::endl;
     std::cout << "======================================================================" << std::endl;
@@ -578,11 +754,16 @@ double UserCommands::Command10_MEDIAN(std::string SDBEtype, std::string product,
 /** Compute the median price of a range of prices from one or more time steps
  *
  *  @param priceRecords Price records for one or more time steps
- *  @return             Median of a set of price records 
+ *  @return             Median of a set of price records, or 0 if there are none
  *
  */
 double UserCommands::computeMedian(std::vector<double>& priceRecords)
 {
+    if (priceRecords.empty())
+    {
+        return 0;
+    }
+
     // Sort the price records in ascending order
     std::sort(priceRecords.begin(), priceRecords.end());
 
@@ -601,112 +782,1254 @@ double UserCommands::computeMedian(std::vector<double>& priceRecords)
     return (priceRecords[length / 2] + priceRecords[length / 2 - 1]) / 2.0;
 }
 
-/** Determine a time step's validity based on conversion success
+/** Compute the median price of a range of prices held as ticks, exactly until the conversion of the result
+ *
+ *  @param priceTickRecords Price records for one or more time steps, as counts of the product's tick size
+ *  @param decimals         Number of decimals of the tick size
+ *  @return                 Median of a set of price records, or 0 if there are none
  *
- *  @param timeStep User-entered time step
- *  @return         true if the number of time steps is valid, false otherwise
  */
-bool UserCommands::validateTimeStep(std::string timeStep)
+double UserCommands::computeMedian(std::vector<std::int64_t>& priceTickRecords, std::uint8_t decimals)
 {
-    try
+    if (priceTickRecords.empty())
     {
-        // Attempt to convert token into integer 
-        int intTimeStep = std::stoi(timeStep);
-        return true;
+        return 0;
     }
-    catch (const std::exception& e)
+
+    // Sort the price records in ascending order
+    std::sort(priceTickRecords.begin(), priceTickRecords.end());
+    std::size_t length = priceTickRecords.size();
+
+    // Odd number of records: the middle one
+    if (length % 2 != 0)
     {
-        // Unsuccessful conversion from string time step to integer 
-        std::cout << "Unsuccessful conversion from string time step to integer" << std::endl;
-        return false;
+        return FixedPoint::toDouble(priceTickRecords[length / 2], decimals);
     }
+    // Even number of records: the two middle ones are added as ticks, which cannot overflow, then halved
+    return FixedPoint::toDouble(priceTickRecords[length / 2] + priceTickRecords[length / 2 - 1], decimals, 2);
 }
 
-/** Determine a product's validity by checking for its existence in the dataset
- *
- *  @param product User-entered product
- *  @return        true if the product exists in the dataset, false otherwise
- */
-bool UserCommands::validateProduct(std::string product, AdvisorBot *advisorBot)
+/** Command 11: REPORT - print the report generated while loading the dataset */
+void UserCommands::Command11_REPORT(AdvisorBot *advisorBot)
 {
-    try
-    {
-        // Query list of known products from dataset
-        std::vector<std::string> uniqueProducts = advisorBot->stocksDataBook.getUniqueProducts();
-
-        // Input product assumed to be not present
-        bool isValid = false;
+    advisorBot->book().getLoadReport().print(std::cout);
+}
 
-        // Consider each unique product in the dataset
-        for (auto& uniqueProduct : uniqueProducts)
-        {
-            // Normalize the user input and known product name by conversion to lowercase
-            convertStringToLowercase(uniqueProduct);
-            convertStringToLowercase(product);
+/** Command 11: REPORT JSON - write the report generated while loading the dataset as JSON */
+void UserCommands::Command11_REPORT_json(AdvisorBot *advisorBot)
+{
+    // Name of the file to which the report is written
+    const std::string jsonFilename = "loadreport.json";
 
-            // Determine success of match between user input and known product
-            if (uniqueProduct == product)
-            {
-                isValid = true;
-                break;
-            }
-        }
-        return isValid;
-    }
-    catch (const std::exception& e)
+    if (!advisorBot->book().getLoadReport().writeJSON(jsonFilename))
     {
-        // Error in validating product against dataset products
-        std::cout << "Error processing product" << std::endl;
+        std::cout << "Two token user command failed. Unable to write " << jsonFilename << "." << std::endl;
+        throw std::exception{};
     }
+
+    std::cout << "=================================================================" << std::endl;
+    std::cout << "The load report has been written to " << jsonFilename << std::endl;
+    std::cout << "=================================================================" << std::endl;
 }
 
-/** Determine the SDBE type's validity by affirming its type is not unknown
+/** Command 12: DEPTH - list the aggregated bid and ask price levels of a product in the current time step
  *
- *  @param SDBEtype User-entered SDBE type - ask/bid/unknown
- *  @return         true if the string is represented by an ask or bid enumerator, false otherwise
+ *  @param product     Product name
+ *  @param numLevels   Number of price levels to list on each side
+ *  @param currentTime Current timestamp of simulation
+ *  @return            Cumulative amount across the listed levels of both sides
  *
  */
-bool UserCommands::validateSDBEtype(std::string SDBEtype)
+double UserCommands::Command12_DEPTH(const std::string& product, const std::string& numLevels, const std::string& currentTime, AdvisorBot *advisorBot)
 {
-    // Convert input string to lowercase
-    convertStringToLowercase(SDBEtype);
+    // Validate product
+    if (!validateProduct(product, advisorBot))
+    {
+        std::cout << "Three token user command failed. Product not recognized." << std::endl;
+        throw std::exception{};
+    }
 
-    // Affirm that the user-entered SDBE type is not an unknown enumeration after conversion
-    enum StocksDataBookType stocksDataBookType = StocksDataBookEntry::stringToStocksDataBookType(SDBEtype);
-    return stocksDataBookType != StocksDataBookType::unknown;
+    // Validate number of levels
+    if (!validateTimeStep(numLevels) || std::stoi(numLevels) <= 0)
+    {
+        std::cout << "Three token user command failed. Number of levels not recognized." << std::endl;
+        throw std::exception{};
+    }
+
+    // Retrieve the cached ladders of the current time step, building them on first use
+    const DepthLadders& ladders = advisorBot->engines().depthEngine.getLadders(product, currentTime);
+
+    // Number of rows of the table
+    std::size_t levels = static_cast<std::size_t>(std::stoi(numLevels));
+    std::size_t rows = std::min(levels, std::max(ladders.bids.size(), ladders.asks.size()));
+
+    std::cout << "==========================================================================================" << std::endl;
+    std::cout << "Depth of " << product << " at " << currentTime << std::endl;
+    std::cout << std::setw(5) << "Level"
+              << std::setw(15) << "Bid price" << std::setw(15) << "Bid amount" << std::setw(15) << "Cum. bid"
+              << std::setw(15) << "Ask price" << std::setw(15) << "Ask amount" << std::setw(15) << "Cum. ask" << std::endl;
+
+    // Display the best levels of both sides alongside each other
+    for (std::size_t i = 0; i < rows; ++i)
+    {
+        std::cout << std::setw(5) << i + 1;
+        if (i < ladders.bids.size())
+        {
+            std::cout << std::setw(15) << ladders.bids[i].price << std::setw(15) << ladders.bids[i].amount << std::setw(15) << ladders.bids[i].cumulativeAmount;
+        }
+        else
+        {
+            std::cout << std::setw(45) << "";
+        }
+        if (i < ladders.asks.size())
+        {
+            std::cout << std::setw(15) << ladders.asks[i].price << std::setw(15) << ladders.asks[i].amount << std::setw(15) << ladders.asks[i].cumulativeAmount;
+        }
+        std::cout << std::endl;
+    }
+    std::cout << "==========================================================================================" << std::endl;
+
+    // Cumulative amount across the listed levels of both sides
+    double bidDepth = ladders.bids.empty() ? 0 : ladders.bids[std::min(levels, ladders.bids.size()) - 1].cumulativeAmount;
+    double askDepth = ladders.asks.empty() ? 0 : ladders.asks[std::min(levels, ladders.asks.size()) - 1].cumulativeAmount;
+    return bidDepth + askDepth;
 }
 
-/** Determine max/min validity based on its enumeration constant representation 
+/** Command 13: IMPACT - compute the price impact of filling an amount against the asks or bids of a product in the current time step
  *
- *  @param maxOrMin String to be validated
- *  @return         true if the string is represented by a max or min enumerator, false otherwise
+ *  @param SDBEtype    Side of the book consumed by the fill - ask (buying) or bid (selling)
+ *  @param product     Product name
+ *  @param currentTime Current timestamp of simulation
+ *  @param amount      Amount to be filled
+ *  @return            Volume-weighted average fill price
  *
  */
-bool UserCommands::validateMaxMin(std::string maxOrMin)
+double UserCommands::Command13_IMPACT(const std::string& SDBEtype, const std::string& product, const std::string& currentTime, const std::string& amount, AdvisorBot *advisorBot)
 {
-    enum MaxMinType maxMinType = stringToMaxMinType(maxOrMin);
-    
-    // Match to valid enumeration constants
-    if (maxMinType == MaxMinType::min || maxMinType == MaxMinType::max)
+    // Validate SDBE type
+    if (!validateSDBEtype(SDBEtype))
     {
-        return true;
-    }
-    
-    // Unknown enumeration constant
-    return false;
+        std::cout << "Four token user command failed. StocksDataBookEntry type not recognized." << std::endl;
+        throw std::exception{};
+    }
+
+    // Validate product
+    if (!validateProduct(product, advisorBot))
+    {
+        std::cout << "Four token user command failed. Product not recognized." << std::endl;
+        throw std::exception{};
+    }
+
+    // Validate amount
+    if (!validateAmount(amount))
+    {
+        std::cout << "Four token user command failed. Amount not recognized." << std::endl;
+        throw std::exception{};
+    }
+
+    // Walk the cached ladder of the requested side
+    PriceImpact priceImpact = advisorBot->engines().depthEngine.computePriceImpact(product, currentTime,
+        StocksDataBookEntry::stringToStocksDataBookType(SDBEtype), std::stod(amount));
+
+    std::cout << "======================================================================" << std::endl;
+    std::cout << "Filling " << amount << " " << product << " against the " << SDBEtype << "s:" << std::endl;
+    std::cout << "Filled amount: " << priceImpact.filledAmount << " across " << priceImpact.levelsTouched << " level(s)" << std::endl;
+    std::cout << "Best price: " << priceImpact.bestPrice << ", average price: " << priceImpact.averagePrice
+              << ", worst price: " << priceImpact.worstPrice << std::endl;
+    std::cout << "Price impact: " << priceImpact.impactBasisPoints << " basis points" << std::endl;
+    if (priceImpact.filledAmount < priceImpact.requestedAmount)
+    {
+        std::cout << "The " << SDBEtype << " side is too shallow to fill the full amount" << std::endl;
+    }
+    std::cout << "======================================================================" << std::endl;
+    return priceImpact.averagePrice;
+}
+
+/** Command 14: VWAP - compute the volume-weighted average ask or bid price for a product over the sent number of time steps
+ *
+ *  @param SDBEtype     SDBE type - ask/bid/unknown
+ *  @param product      Product name
+ *  @param currentTime  Current timestamp of simulation
+ *  @param numTimesteps Number of time steps to factor into the average
+ *  @return             Volume-weighted average price over the time frame, or 0 if no amount was offered
+ *
+ */
+double UserCommands::Command14_VWAP(const std::string& SDBEtype, const std::string& product, const std::string& currentTime, const std::string& numTimesteps, AdvisorBot *advisorBot)
+{
+    validateWindowedCommand(SDBEtype, product, numTimesteps, advisorBot);
+
+    // Per time step sums of price * amount and amount, computed together in one pass over the SDBEs
+    const std::vector<TimeStepAggregate>& aggregates = advisorBot->book().getTimeStepAggregates(product,
+        StocksDataBookEntry::stringToStocksDataBookType(SDBEtype));
+
+    // Combine the sums of every time step in the window
+    double sumPriceAmount = 0;
+    double sumAmount = 0;
+    for (std::size_t timeStepIndex : getTimeStepWindow(currentTime, numTimesteps, advisorBot))
+    {
+        sumPriceAmount += aggregates[timeStepIndex].sumPriceAmount;
+        sumAmount += aggregates[timeStepIndex].sumAmount;
+    }
+
+    // Avoid divide by zero if no amount was offered within the window
+    double vwap = sumAmount != 0 ? sumPriceAmount / sumAmount : 0;
+
+    std::cout << "======================================================================" << std::endl;
+    std::cout << "The volume-weighted average " << product << " " << SDBEtype << " price over " << describeTimeStepWindow(numTimesteps) << " was " << vwap << std::endl;
+    std::cout << "======================================================================" << std::endl;
+    return vwap;
+}
+
+/** Command 15: VWMEDIAN - compute the volume-weighted median ask or bid price for a product over the sent number of time steps
+ *
+ *  @param SDBEtype     SDBE type - ask/bid/unknown
+ *  @param product      Product name
+ *  @param currentTime  Current timestamp of simulation
+ *  @param numTimesteps Number of time steps to consider
+ *  @return             Volume-weighted median price over the time frame
+ *
+ */
+double UserCommands::Command15_VWMEDIAN(const std::string& SDBEtype, const std::string& product, const std::string& currentTime, const std::string& numTimesteps, AdvisorBot *advisorBot)
+{
+    validateWindowedCommand(SDBEtype, product, numTimesteps, advisorBot);
+
+    StocksDataBookType type = StocksDataBookEntry::stringToStocksDataBookType(SDBEtype);
+    const std::vector<TimeStepAggregate>& aggregates = advisorBot->book().getTimeStepAggregates(product, type);
+
+    // Store the price and amount of every relevant SDBE, visiting only the product's rows at the time steps in the window
+    std::vector<std::pair<double, double>> priceAmountRecords;
+    for (std::size_t timeStepIndex : getTimeStepWindow(currentTime, numTimesteps, advisorBot))
+    {
+        // Skip time steps in which the product has no SDBEs of this type
+        if (aggregates[timeStepIndex].entries == 0)
+        {
+            continue;
+        }
+        const ProductShard& shard = *advisorBot->book().findShard(product);
+        ShardTimeStep rows = shard.findTimeStep(timeStepIndex);
+        for (std::size_t row = rows.begin; row < rows.end; ++row)
+        {
+            if (shard.getTypes()[row] == type)
+            {
+                priceAmountRecords.emplace_back(shard.getPrices()[row], shard.getAmounts()[row]);
+            }
+        }
+    }
+
+    double medianPrice = computeVolumeWeightedMedian(priceAmountRecords);
+    std::cout << "======================================================================" << std::endl;
+    std::cout << "The volume-weighted median " << product << " " << SDBEtype << " price over " << describeTimeStepWindow(numTimesteps) << " was " << medianPrice << std::endl;
+    std::cout << "======================================================================" << std::endl;
+    return medianPrice;
+}
+
+/** Command 16: VOLUME - compute the total ask or bid amount for a product over the sent number of time steps
+ *
+ *  @param SDBEtype     SDBE type - ask/bid/unknown
+ *  @param product      Product name
+ *  @param currentTime  Current timestamp of simulation
+ *  @param numTimesteps Number of time steps to consider
+ *  @return             Total amount offered over the time frame
+ *
+ */
+double UserCommands::Command16_VOLUME(const std::string& SDBEtype, const std::string& product, const std::string& currentTime, const std::string& numTimesteps, AdvisorBot *advisorBot)
+{
+    validateWindowedCommand(SDBEtype, product, numTimesteps, advisorBot);
+
+    const std::vector<TimeStepAggregate>& aggregates = advisorBot->book().getTimeStepAggregates(product,
+        StocksDataBookEntry::stringToStocksDataBookType(SDBEtype));
+
+    // Sum the amounts of every time step in the window
+    double totalVolume = 0;
+    for (std::size_t timeStepIndex : getTimeStepWindow(currentTime, numTimesteps, advisorBot))
+    {
+        totalVolume += aggregates[timeStepIndex].sumAmount;
+    }
+
+    std::cout << "======================================================================" << std::endl;
+    std::cout << "The total " << product << " " << SDBEtype << " amount over " << describeTimeStepWindow(numTimesteps) << " was " << totalVolume << std::endl;
+    std::cout << "======================================================================" << std::endl;
+    return totalVolume;
+}
+
+/** Command 17: SPREAD - list the best bid, best ask, spread and mid price of a product over the sent number of time steps
+ *
+ *  @param product      Product name
+ *  @param numTimesteps Number of time steps to list
+ *  @param currentTime  Current timestamp of simulation
+ *  @return             Spread in the current time step
+ *
+ */
+double UserCommands::Command17_SPREAD(const std::string& product, const std::string& numTimesteps, const std::string& currentTime, AdvisorBot *advisorBot)
+{
+    // Validate product
+    if (!validateProduct(product, advisorBot))
+    {
+        std::cout << "Three token user command failed. Product not recognized." << std::endl;
+        throw std::exception{};
+    }
+
+    // Validate time step
+    if (!validateTimeStepWindow(numTimesteps))
+    {
+        std::cout << "Three token user command failed. Time step not recognized." << std::endl;
+        throw std::exception{};
+    }
+
+    std::vector<std::size_t> timeStepWindow = getTimeStepWindow(currentTime, numTimesteps, advisorBot);
+    SpreadSeries spreadSeries = computeSpreadSeries(product, timeStepWindow, advisorBot);
+    const std::vector<TimeStepRange>& timeSteps = advisorBot->book().getTimeSteps();
+
+    std::cout << "==========================================================================================================" << std::endl;
+    std::cout << "Spread of " << product << " over " << describeTimeStepWindow(numTimesteps) << std::endl;
+    std::cout << std::setw(28) << std::left << "Time" << std::right
+              << std::setw(15) << "Best bid" << std::setw(15) << "Best ask" << std::setw(15) << "Spread"
+              << std::setw(15) << "Mid price" << std::setw(15) << "Spread (bps)" << std::endl;
+
+    // List the oldest time step first
+    for (std::size_t i = timeStepWindow.size(); i-- > 0;)
+    {
+        std::cout << std::setw(28) << std::left << timeSteps[timeStepWindow[i]].timestamp << std::right
+                  << std::setw(15) << spreadSeries.bestBid[i] << std::setw(15) << spreadSeries.bestAsk[i]
+                  << std::setw(15) << spreadSeries.spread[i] << std::setw(15) << spreadSeries.midPrice[i]
+                  << std::setw(15) << spreadSeries.relativeSpread[i] * 10000.0 << std::endl;
+    }
+    std::cout << "==========================================================================================================" << std::endl;
+    return spreadSeries.spread.empty() ? 0 : spreadSeries.spread.front();
+}
+
+/** Command 18: CANDLES - list the OHLC/volume candles of a product and side at a resolution up to the current time step
+ *
+ *  @param product     Product name
+ *  @param SDBEtype    SDBE type - ask/bid/unknown
+ *  @param resolution  Candle resolution, e.g. 1t, 5t, 1m or 1h
+ *  @param numCandles  Number of candles to list
+ *  @param currentTime Current timestamp of simulation
+ *  @return            Close of the latest candle
+ *
+ */
+double UserCommands::Command18_CANDLES(const std::string& product, const std::string& SDBEtype, const std::string& resolution, const std::string& numCandles, const std::string& currentTime, AdvisorBot *advisorBot)
+{
+    // Validate number of candles
+    if (!validateTimeStep(numCandles) || std::stoi(numCandles) <= 0)
+    {
+        std::cout << "Five token user command failed. Number of candles not recognized." << std::endl;
+        throw std::exception{};
+    }
+
+    std::vector<Candle> candles = getCandlesUpToTime(product, SDBEtype, resolution, std::stoul(numCandles), currentTime, advisorBot);
+
+    std::cout << "==========================================================================================================" << std::endl;
+    std::cout << resolution << " " << SDBEtype << " candles of " << product << std::endl;
+    std::cout << std::setw(28) << std::left << "Start" << std::right
+              << std::setw(15) << "Open" << std::setw(15) << "High" << std::setw(15) << "Low"
+              << std::setw(15) << "Close" << std::setw(15) << "Volume" << std::endl;
+    for (const Candle& candle : candles)
+    {
+        std::cout << std::setw(28) << std::left << TimeStamp::format(candle.bucketStart) << std::right
+                  << std::setw(15) << candle.open << std::setw(15) << candle.high << std::setw(15) << candle.low
+                  << std::setw(15) << candle.close << std::setw(15) << candle.volume << std::endl;
+    }
+    std::cout << "==========================================================================================================" << std::endl;
+    return candles.empty() ? 0 : candles.back().close;
+}
+
+/** Return the candles of a product and side at a resolution that start at or before the current time step
+ *
+ *  @param product     Product name
+ *  @param SDBEtype    SDBE type - ask/bid/unknown
+ *  @param resolution  Candle resolution, e.g. 1t, 5t, 1m or 1h
+ *  @param numCandles  Maximum number of candles to return
+ *  @param currentTime Current timestamp of simulation
+ *  @return            up to numCandles candles in time order, the last one closing at or before the current time step
+ *
+ */
+std::vector<Candle> UserCommands::getCandlesUpToTime(const std::string& product, const std::string& SDBEtype, const std::string& resolution, std::size_t numCandles, const std::string& currentTime, AdvisorBot *advisorBot)
+{
+    // Validate product
+    if (!validateProduct(product, advisorBot))
+    {
+        std::cout << "Five token user command failed. Product not recognized." << std::endl;
+        throw std::exception{};
+    }
+
+    // Validate SDBE type
+    if (!validateSDBEtype(SDBEtype))
+    {
+        std::cout << "Five token user command failed. StocksDataBookEntry type not recognized." << std::endl;
+        throw std::exception{};
+    }
+
+    // Validate resolution
+    CandleResolution candleResolution;
+    if (!CandleEngine::parseResolution(resolution, candleResolution))
+    {
+        std::cout << "Five token user command failed. Resolution not recognized." << std::endl;
+        throw std::exception{};
+    }
+
+    const std::vector<Candle>& candles = advisorBot->engines().candleEngine.getCandles(product,
+        StocksDataBookEntry::stringToStocksDataBookType(SDBEtype), candleResolution);
+
+    // Locate the first candle starting after the current time step
+    std::size_t currentTimeStep = static_cast<std::size_t>(std::max(0L, advisorBot->book().findTimeStep(currentTime)));
+    auto end = std::upper_bound(candles.begin(), candles.end(), currentTimeStep,
+        [](std::size_t timeStep, const Candle& candle) { return timeStep < candle.firstTimeStep; });
+
+    auto begin = end - std::min<std::ptrdiff_t>(static_cast<std::ptrdiff_t>(numCandles), end - candles.begin());
+    std::vector<Candle> candlesUpToTime(begin, end);
+
+    // Close the candle of the current time step at the current time step, so that no later SDBEs leak into it
+    if (!candlesUpToTime.empty())
+    {
+        candlesUpToTime.back() = advisorBot->engines().candleEngine.closeCandleAt(product,
+            StocksDataBookEntry::stringToStocksDataBookType(SDBEtype), candlesUpToTime.back(), currentTimeStep);
+    }
+    return candlesUpToTime;
+}
+
+/** Command 19: VOL - compute the rolling volatility of the ask or bid price of a product over the sent number of time steps
+ *
+ *  @param SDBEtype     SDBE type - ask/bid/unknown
+ *  @param product      Product name
+ *  @param currentTime  Current timestamp of simulation
+ *  @param numTimesteps Number of time steps in the window
+ *  @return             Standard deviation of the log returns within the window
+ *
+ */
+double UserCommands::Command19_VOL(const std::string& SDBEtype, const std::string& product, const std::string& currentTime, const std::string& numTimesteps, AdvisorBot *advisorBot)
+{
+    validateWindowedCommand(SDBEtype, product, numTimesteps, advisorBot);
+
+    // The rolling windows are kept per number of time steps, so time ranges and durations are not served
+    if (isTimeWindow(numTimesteps))
+    {
+        std::cout << "Four token user command failed. Time step not recognized." << std::endl;
+        throw std::exception{};
+    }
+
+    VolatilitySnapshot snapshot = advisorBot->engines().volatilityEngine.getSnapshot(product,
+        StocksDataBookEntry::stringToStocksDataBookType(SDBEtype), std::stoul(numTimesteps), currentTime);
+
+    std::cout << "======================================================================" << std::endl;
+    std::cout << "Rolling " << product << " " << SDBEtype << " statistics over the last " << snapshot.prices << " time step(s):" << std::endl;
+    std::cout << "Mean price: " << snapshot.meanPrice << ", price standard deviation: " << snapshot.priceStandardDeviation << std::endl;
+    std::cout << "Volatility (standard deviation of log returns per time step): " << snapshot.returnStandardDeviation << std::endl;
+    std::cout << "======================================================================" << std::endl;
+    return snapshot.returnStandardDeviation;
+}
+
+/** Command 20: ZSCORE - compute the distance of the current ask or bid price of a product from its rolling mean, in standard deviations
+ *
+ *  @param SDBEtype     SDBE type - ask/bid/unknown
+ *  @param product      Product name
+ *  @param currentTime  Current timestamp of simulation
+ *  @param numTimesteps Number of time steps in the window
+ *  @return             Z-score of the current price
+ *
+ */
+double UserCommands::Command20_ZSCORE(const std::string& SDBEtype, const std::string& product, const std::string& currentTime, const std::string& numTimesteps, AdvisorBot *advisorBot)
+{
+    validateWindowedCommand(SDBEtype, product, numTimesteps, advisorBot);
+
+    // The rolling windows are kept per number of time steps, so time ranges and durations are not served
+    if (isTimeWindow(numTimesteps))
+    {
+        std::cout << "Four token user command failed. Time step not recognized." << std::endl;
+        throw std::exception{};
+    }
+
+    VolatilitySnapshot snapshot = advisorBot->engines().volatilityEngine.getSnapshot(product,
+        StocksDataBookEntry::stringToStocksDataBookType(SDBEtype), std::stoul(numTimesteps), currentTime);
+
+    std::cout << "======================================================================" << std::endl;
+    std::cout << "The current " << product << " " << SDBEtype << " price " << snapshot.price << " lies " << snapshot.zScore
+              << " standard deviation(s) from its mean of " << snapshot.meanPrice << " over the last " << snapshot.prices << " time step(s)" << std::endl;
+    std::cout << "======================================================================" << std::endl;
+    return snapshot.zScore;
+}
+
+/** Command 21: CORR - compute the correlation matrix of the mid prices of every product over the sent number of time steps
+ *
+ *  @param numTimesteps Number of time steps in the window
+ *  @param currentTime  Current timestamp of simulation
+ *  @return             Average correlation over all pairs of distinct products, NaN if no pair has one
+ *
+ */
+double UserCommands::Command21_CORR(const std::string& numTimesteps, const std::string& currentTime, AdvisorBot *advisorBot)
+{
+    // Validate time step
+    if (!validateTimeStepWindow(numTimesteps) || (!isTimeWindow(numTimesteps) && std::stoi(numTimesteps) <= 1))
+    {
+        std::cout << "Two token user command failed. Time step not recognized, at least two time steps are required." << std::endl;
+        throw std::exception{};
+    }
+
+    // Extract every product's series once, then correlate all pairs at once
+    const std::vector<std::string>& products = advisorBot->book().getUniqueProducts();
+    std::vector<std::size_t> timeStepWindow = getTimeStepWindow(currentTime, numTimesteps, advisorBot);
+    std::vector<double> matrix = CorrelationMatrix::compute(getAlignedMidPriceSeries(products, timeStepWindow, advisorBot));
+
+    std::cout << "======================================================================" << std::endl;
+    std::cout << "Correlation of mid prices over " << describeTimeStepWindow(numTimesteps) << std::endl;
+    std::cout << std::setw(12) << "";
+    for (const std::string& product : products)
+    {
+        std::cout << std::setw(11) << product;
+    }
+    std::cout << std::endl;
+
+    double sumCorrelations = 0;
+    std::size_t numCorrelations = 0;
+    std::ios_base::fmtflags previousFlags = std::cout.flags();
+    std::streamsize previousPrecision = std::cout.precision(3);
+    std::cout << std::fixed;
+    for (std::size_t row = 0; row < products.size(); ++row)
+    {
+        std::cout << std::setw(12) << std::left << products[row] << std::right;
+        for (std::size_t column = 0; column < products.size(); ++column)
+        {
+            double correlation = matrix[row * products.size() + column];
+            if (std::isnan(correlation))
+            {
+                std::cout << std::setw(11) << "n/a";
+                continue;
+            }
+            std::cout << std::setw(11) << correlation;
+
+            // Average the upper triangle only
+            if (column > row)
+            {
+                sumCorrelations += correlation;
+                ++numCorrelations;
+            }
+        }
+        std::cout << std::endl;
+    }
+    std::cout.flags(previousFlags);
+    std::cout.precision(previousPrecision);
+    std::cout << "======================================================================" << std::endl;
+    return numCorrelations != 0 ? sumCorrelations / numCorrelations : std::numeric_limits<double>::quiet_NaN();
+}
+
+/** Command 22: BACKTEST - replay every time step of a product through the EWMA strategy and report its profit and loss
+ *
+ *  @param product   Product name
+ *  @param span      Number of time steps of the EWMA
+ *  @param threshold Fraction by which the prediction must clear the best price before trading
+ *  @return          Final mark-to-market profit and loss in the quote currency
+ *
+ */
+double UserCommands::Command22_BACKTEST(const std::string& product, const std::string& span, const std::string& threshold, AdvisorBot *advisorBot)
+{
+    // Validate product
+    if (!validateProduct(product, advisorBot))
+    {
+        std::cout << "Four token user command failed. Product not recognized." << std::endl;
+        throw std::exception{};
+    }
+
+    // Validate span
+    if (!validateTimeStep(span) || std::stoi(span) <= 0)
+    {
+        std::cout << "Four token user command failed. Span not recognized." << std::endl;
+        throw std::exception{};
+    }
+
+    // Validate threshold, which may be zero
+    double thresholdValue;
+    try
+    {
+        thresholdValue = std::stod(threshold);
+    }
+    catch (const std::exception& e)
+    {
+        thresholdValue = -1;
+    }
+    if (thresholdValue < 0)
+    {
+        std::cout << "Four token user command failed. Threshold not recognized." << std::endl;
+        throw std::exception{};
+    }
+
+    EWMAStrategy strategy{ static_cast<std::size_t>(std::stoi(span)), thresholdValue };
+    BacktestResult result = Backtester::replay(advisorBot->engines().backtester.getMarketTicks(product), strategy, 1.0);
+    const std::vector<TimeStepRange>& timeSteps = advisorBot->book().getTimeSteps();
+
+    std::cout << "======================================================================" << std::endl;
+    std::cout << "Backtest of a " << span << " time step EWMA strategy on " << product << " with a threshold of " << thresholdValue << std::endl;
+    std::cout << "Time steps replayed: " << result.ticks << ", trades: " << result.trades.size() << std::endl;
+
+    // List the first trades
+    const std::size_t tradesListed = 10;
+    for (std::size_t i = 0; i < result.trades.size() && i < tradesListed; ++i)
+    {
+        const BacktestTrade& trade = result.trades[i];
+        std::cout << timeSteps[trade.timeStep].timestamp << (trade.side == TradeSignal::buy ? " buy " : " sell ")
+                  << trade.amount << " at " << trade.price << std::endl;
+    }
+    if (result.trades.size() > tradesListed)
+    {
+        std::cout << "... " << result.trades.size() - tradesListed << " more trade(s)" << std::endl;
+    }
+
+    std::cout << "Final position: " << result.position << ", cash: " << result.cash << std::endl;
+    std::cout << "Profit and loss: " << result.profitAndLoss << ", maximum drawdown: " << result.maxDrawdown << std::endl;
+    std::cout << "======================================================================" << std::endl;
+    return result.profitAndLoss;
+}
+
+/** Command 23: SWEEP - find the EWMA spans and strategy thresholds that performed best on every product
+ *
+ *  @param SDBEtype SDBE type - ask/bid/unknown
+ *  @return         Number of parameter combinations evaluated
+ *
+ */
+double UserCommands::Command23_SWEEP(const std::string& SDBEtype, AdvisorBot *advisorBot)
+{
+    // Validate SDBE type
+    if (!validateSDBEtype(SDBEtype))
+    {
+        std::cout << "Two token user command failed. StocksDataBookEntry type not recognized." << std::endl;
+        throw std::exception{};
+    }
+    StocksDataBookType side = StocksDataBookEntry::stringToStocksDataBookType(SDBEtype);
+
+    const std::vector<std::string>& products = advisorBot->book().getUniqueProducts();
+    std::vector<std::size_t> spans = ParameterSweep::getDefaultSpans();
+    std::vector<double> thresholds = ParameterSweep::getDefaultThresholds();
+
+    // Evaluate the whole grid, each sweep spreading its combinations over all threads
+    std::vector<SpanError> maxErrors = ParameterSweep::sweepPredictionSpans(advisorBot->book(), products, side, true, spans);
+    std::vector<SpanError> minErrors = ParameterSweep::sweepPredictionSpans(advisorBot->book(), products, side, false, spans);
+    std::vector<StrategyScore> scores = ParameterSweep::sweepStrategies(advisorBot->engines().backtester, products, spans, thresholds);
+
+    // Results are ordered by product, so each product owns a contiguous run of every result vector
+    auto lowestError = [&spans](const std::vector<SpanError>& spanErrors, std::size_t p)
+    {
+        auto first = spanErrors.begin() + p * spans.size();
+        return *std::min_element(first, first + spans.size(),
+            [](const SpanError& a, const SpanError& b) { return a.meanAbsoluteError < b.meanAbsoluteError; });
+    };
+    const std::size_t scoresPerProduct = spans.size() * thresholds.size();
+
+    std::cout << "======================================================================" << std::endl;
+    std::cout << "Sweep of " << spans.size() << " EWMA spans and " << thresholds.size() << " thresholds over the " << SDBEtype << " side of every product" << std::endl;
+    for (std::size_t p = 0; p < products.size(); ++p)
+    {
+        SpanError bestMax = lowestError(maxErrors, p);
+        SpanError bestMin = lowestError(minErrors, p);
+        auto first = scores.begin() + p * scoresPerProduct;
+        const StrategyScore& bestScore = *std::max_element(first, first + scoresPerProduct,
+            [](const StrategyScore& a, const StrategyScore& b) { return a.profitAndLoss < b.profitAndLoss; });
+
+        std::cout << products[p] << ":" << std::endl;
+        std::cout << "  Predict max: span " << bestMax.span << " (MAE " << bestMax.meanAbsoluteError << ", RMSE " << bestMax.rootMeanSquaredError
+                  << " over " << bestMax.predictions << " predictions)" << std::endl;
+        std::cout << "  Predict min: span " << bestMin.span << " (MAE " << bestMin.meanAbsoluteError << ", RMSE " << bestMin.rootMeanSquaredError
+                  << " over " << bestMin.predictions << " predictions)" << std::endl;
+        std::cout << "  Strategy:    span " << bestScore.span << ", threshold " << bestScore.threshold << " (P&L " << bestScore.profitAndLoss
+                  << ", maximum drawdown " << bestScore.maxDrawdown << ", " << bestScore.trades << " trades)" << std::endl;
+    }
+    std::cout << "======================================================================" << std::endl;
+    return static_cast<double>(maxErrors.size() + minErrors.size() + scores.size());
+}
+
+/** Command 24: WALLET - list the balance of every currency in the wallet */
+void UserCommands::Command24_WALLET(AdvisorBot *advisorBot)
+{
+    std::cout << "======================================================================" << std::endl;
+    std::cout << "Wallet contents:" << std::endl;
+    for (const std::pair<const std::string, double>& balance : advisorBot->wallet.getBalances())
+    {
+        std::cout << balance.first << ": " << balance.second << std::endl;
+    }
+    std::cout << "======================================================================" << std::endl;
+}
+
+/** Command 25: BUY - buy an amount of a product's base currency at or below a limit price from the current asks
+ *
+ *  @param product     Product name
+ *  @param amount      Base currency amount to be bought
+ *  @param price       Highest price to be paid
+ *  @param currentTime Current timestamp of simulation
+ *  @return            Amount bought
+ *
+ */
+double UserCommands::Command25_BUY(const std::string& product, const std::string& amount, const std::string& price, const std::string& currentTime, AdvisorBot *advisorBot)
+{
+    return placeOrder(StocksDataBookType::bid, product, amount, price, currentTime, advisorBot);
+}
+
+/** Command 26: SELL - sell an amount of a product's base currency at or above a limit price to the current bids
+ *
+ *  @param product     Product name
+ *  @param amount      Base currency amount to be sold
+ *  @param price       Lowest price to be accepted
+ *  @param currentTime Current timestamp of simulation
+ *  @return            Amount sold
+ *
+ */
+double UserCommands::Command26_SELL(const std::string& product, const std::string& amount, const std::string& price, const std::string& currentTime, AdvisorBot *advisorBot)
+{
+    return placeOrder(StocksDataBookType::ask, product, amount, price, currentTime, advisorBot);
+}
+
+/** Command 27: GOTO - move the simulation to the time step in effect at a timestamp or time of day
+ *
+ *  @param timestamp   Full timestamp, or a time of day on the current date
+ *  @param currentTime Current timestamp of simulation
+ *  @return            Position of the new time step among the distinct timestamps
+ *
+ */
+double UserCommands::Command27_GOTO(const std::string& timestamp, const std::string& currentTime, AdvisorBot *advisorBot)
+{
+    const TimeStampIndex& timeStampIndex = advisorBot->book().getTimeStampIndex();
+
+    // Validate timestamp
+    std::int64_t time = TimeStampIndex::resolve(timestamp, TimeStamp::parse(currentTime));
+    if (time < 0 || timeStampIndex.size() == 0)
+    {
+        std::cout << "Goto command failed. Timestamp not recognized." << std::endl;
+        throw std::exception{};
+    }
+
+    // Times before the first timestamp land on the first time step
+    if (time < timeStampIndex.getTimes().front())
+    {
+        std::cout << "The requested time precedes the dataset, moving to its earliest time step" << std::endl;
+    }
+    return gotoTimeStep(timeStampIndex.seek(time), advisorBot);
+}
+
+/** Command 28: BACK - move the simulation the sent number of time steps into the past
+ *
+ *  @param numTimesteps Number of time steps to move
+ *  @param currentTime  Current timestamp of simulation
+ *  @return             Position of the new time step among the distinct timestamps
+ *
+ */
+double UserCommands::Command28_BACK(const std::string& numTimesteps, const std::string& currentTime, AdvisorBot *advisorBot)
+{
+    // Validate time step
+    if (!validateTimeStep(numTimesteps) || std::stoi(numTimesteps) < 0)
+    {
+        std::cout << "Two token user command failed. Time step not recognized." << std::endl;
+        throw std::exception{};
+    }
+
+    long currentIndex = advisorBot->book().findTimeStep(currentTime);
+    return gotoTimeStep(std::max(0L, currentIndex - std::stol(numTimesteps)), advisorBot);
+}
+
+/** Command 29: FORWARD - move the simulation the sent number of time steps into the future
+ *
+ *  @param numTimesteps Number of time steps to move
+ *  @param currentTime  Current timestamp of simulation
+ *  @return             Position of the new time step among the distinct timestamps
+ *
+ */
+double UserCommands::Command29_FORWARD(const std::string& numTimesteps, const std::string& currentTime, AdvisorBot *advisorBot)
+{
+    // Validate time step
+    if (!validateTimeStep(numTimesteps) || std::stoi(numTimesteps) < 0)
+    {
+        std::cout << "Two token user command failed. Time step not recognized." << std::endl;
+        throw std::exception{};
+    }
+
+    long currentIndex = advisorBot->book().findTimeStep(currentTime);
+    long lastIndex = static_cast<long>(advisorBot->book().getTimeSteps().size()) - 1;
+    return gotoTimeStep(std::min(lastIndex, currentIndex + std::stol(numTimesteps)), advisorBot);
+}
+
+/** Command 30: STATUS - report the progress of loading the dataset */
+void UserCommands::Command30_STATUS(AdvisorBot *advisorBot)
+{
+    BookLoadProgress progress = advisorBot->getLoadProgress();
+
+    // Describe the stage of the load
+    std::string state = progress.state == BookLoadState::loading ? "in progress" : progress.state == BookLoadState::complete ? "complete" : "failed";
+
+    std::cout << "=================================================================" << std::endl;
+    std::cout << "Dataset load " << state;
+    if (progress.totalBytes > 0)
+    {
+        std::cout << " (" << std::fixed << std::setprecision(1) << 100.0 * progress.bytesParsed / progress.totalBytes << "% of "
+                  << progress.totalBytes << " bytes)" << std::defaultfloat;
+    }
+    std::cout << " after " << std::setprecision(3) << progress.elapsedSeconds << std::setprecision(6) << " seconds" << std::endl;
+    std::cout << progress.rowsParsed << " entries parsed, " << progress.rowsPublished << " available to commands" << std::endl;
+    if (progress.latestTime >= 0)
+    {
+        std::cout << "Loaded up to " << TimeStamp::format(progress.latestTime) << std::endl;
+    }
+    std::cout << "=================================================================" << std::endl;
 }
 
-/* Convert an input string to lowercase 
+/** Move the simulation to a position among the distinct timestamps and report the new time
  *
- * @param inputString The string to be converted
- * 
+ *  @param timeStepIndex Position within getTimeSteps()
+ *  @return              Position of the new time step
+ *
+ */
+double UserCommands::gotoTimeStep(long timeStepIndex, AdvisorBot *advisorBot)
+{
+    const std::vector<TimeStepRange>& timeSteps = advisorBot->book().getTimeSteps();
+    if (timeStepIndex < 0 || static_cast<std::size_t>(timeStepIndex) >= timeSteps.size())
+    {
+        std::cout << "The simulation time could not be changed" << std::endl;
+        throw std::exception{};
+    }
+
+    advisorBot->currentTime = timeSteps[timeStepIndex].timestamp;
+    std::cout << "===============================================" << std::endl;
+    std::cout << "Simulation is now at " << advisorBot->currentTime << " (time step " << timeStepIndex + 1 << " of " << timeSteps.size() << ")" << std::endl;
+    std::cout << "===============================================" << std::endl;
+    return static_cast<double>(timeStepIndex);
+}
+
+/** Validate, match and settle a simulated order against the current time step
+ *
+ *  The wallet must cover the whole order at its limit price before matching. Filled amounts are settled
+ *  level by level at the book's prices and any unfilled remainder is cancelled
+ *
+ *  @param orderType   bid to buy the base currency, ask to sell it
+ *  @param product     Product name
+ *  @param amount      Base currency amount of the order
+ *  @param price       Limit price of the order
+ *  @param currentTime Current timestamp of simulation
+ *  @return            Amount filled
+ *
+ */
+double UserCommands::placeOrder(StocksDataBookType orderType, const std::string& product, const std::string& amount, const std::string& price, const std::string& currentTime, AdvisorBot *advisorBot)
+{
+    // Validate product
+    std::string baseCurrency, quoteCurrency;
+    if (!validateProduct(product, advisorBot) || !Wallet::splitProduct(product, baseCurrency, quoteCurrency))
+    {
+        std::cout << "Four token user command failed. Product not recognized." << std::endl;
+        throw std::exception{};
+    }
+
+    // Validate amount and limit price
+    if (!validateAmount(amount) || !validateAmount(price))
+    {
+        std::cout << "Four token user command failed. Amount and price must be positive numbers." << std::endl;
+        throw std::exception{};
+    }
+    double orderAmount = std::stod(amount);
+    double limitPrice = std::stod(price);
+
+    // Ensure the wallet can settle the whole order
+    bool isBuy = orderType == StocksDataBookType::bid;
+    if (isBuy ? !advisorBot->wallet.containsCurrency(quoteCurrency, orderAmount * limitPrice) : !advisorBot->wallet.containsCurrency(baseCurrency, orderAmount))
+    {
+        std::cout << "Four token user command failed. Insufficient " << (isBuy ? quoteCurrency : baseCurrency) << " in the wallet." << std::endl;
+        throw std::exception{};
+    }
+
+    OrderFill orderFill = advisorBot->orderMatcher.matchOrder(product, currentTime, orderType, orderAmount, limitPrice);
+
+    // Settle the fill
+    if (isBuy)
+    {
+        advisorBot->wallet.removeCurrency(quoteCurrency, orderFill.quoteAmount);
+        advisorBot->wallet.insertCurrency(baseCurrency, orderFill.filledAmount);
+    }
+    else
+    {
+        advisorBot->wallet.removeCurrency(baseCurrency, orderFill.filledAmount);
+        advisorBot->wallet.insertCurrency(quoteCurrency, orderFill.quoteAmount);
+    }
+
+    std::cout << "======================================================================" << std::endl;
+    for (const LevelFill& levelFill : orderFill.levelFills)
+    {
+        std::cout << (isBuy ? "Bought " : "Sold ") << levelFill.amount << " " << baseCurrency << " at " << levelFill.price << " " << quoteCurrency << std::endl;
+    }
+    std::cout << "Filled " << orderFill.filledAmount << " of " << orderAmount << " " << baseCurrency;
+    if (orderFill.filledAmount > 0)
+    {
+        std::cout << " at an average price of " << orderFill.averagePrice << " " << quoteCurrency << ", " << (isBuy ? "paying " : "receiving ")
+                  << orderFill.quoteAmount << " " << quoteCurrency;
+    }
+    std::cout << std::endl;
+    if (orderFill.filledAmount < orderAmount)
+    {
+        std::cout << "The remaining " << orderAmount - orderFill.filledAmount << " " << baseCurrency << " could not be matched at " << limitPrice << " and was cancelled" << std::endl;
+    }
+    std::cout << "======================================================================" << std::endl;
+    return orderFill.filledAmount;
+}
+
+/** Extract the mid price series of every product over a window, aligned by time step and oldest first
+ *
+ *  A time step without a bid or an ask carries the previous mid price forward, and leading gaps take the
+ *  first mid price of the window, so that every series has one value per time step
+ *
+ *  @param products       Product names
+ *  @param timeStepWindow Positions within getTimeSteps(), newest first as returned by getTimeStepWindow()
+ *  @return               one series per product, each of timeStepWindow.size() values, all NaN if the product has no mid price
+ *
+ */
+std::vector<std::vector<double>> UserCommands::getAlignedMidPriceSeries(const std::vector<std::string>& products, const std::vector<std::size_t>& timeStepWindow, AdvisorBot *advisorBot)
+{
+    std::vector<std::vector<double>> series;
+    series.reserve(products.size());
+
+    for (const std::string& product : products)
+    {
+        SpreadSeries spreadSeries = computeSpreadSeries(product, timeStepWindow, advisorBot);
+        const std::vector<double>& midPrice = spreadSeries.midPrice;
+
+        // Reverse into chronological order, carrying the last known mid price over gaps
+        std::vector<double> values(midPrice.size(), std::numeric_limits<double>::quiet_NaN());
+        double lastMidPrice = std::numeric_limits<double>::quiet_NaN();
+        std::size_t firstKnown = values.size();
+        for (std::size_t i = 0; i < values.size(); ++i)
+        {
+            double value = midPrice[midPrice.size() - 1 - i];
+            if (!std::isnan(value))
+            {
+                lastMidPrice = value;
+                firstKnown = std::min(firstKnown, i);
+            }
+            values[i] = lastMidPrice;
+        }
+
+        // Fill the leading gap with the first known mid price
+        for (std::size_t i = 0; i < firstKnown && firstKnown < values.size(); ++i)
+        {
+            values[i] = values[firstKnown];
+        }
+        series.push_back(std::move(values));
+    }
+    return series;
+}
+
+/** Compute the best prices, spread, mid price and relative spread of a product for each time step provided
+ *
+ *  Best prices come from the per time step aggregates, which summarize both sides in a single pass over the
+ *  SDBEs, and the derived measures are computed over contiguous arrays so that the loop vectorizes
+ *
+ *  @param product        Product name
+ *  @param timeStepWindow Positions of the time steps within getTimeSteps()
+ *  @return               series with one element per time step in the window
+ *
+ */
+SpreadSeries UserCommands::computeSpreadSeries(const std::string& product, const std::vector<std::size_t>& timeStepWindow, AdvisorBot *advisorBot)
+{
+    const std::vector<TimeStepAggregate>& bidAggregates = advisorBot->book().getTimeStepAggregates(product, StocksDataBookType::bid);
+    const std::vector<TimeStepAggregate>& askAggregates = advisorBot->book().getTimeStepAggregates(product, StocksDataBookType::ask);
+
+    std::size_t length = timeStepWindow.size();
+    SpreadSeries spreadSeries;
+    spreadSeries.bestBid.resize(length);
+    spreadSeries.bestAsk.resize(length);
+    spreadSeries.spread.resize(length);
+    spreadSeries.midPrice.resize(length);
+    spreadSeries.relativeSpread.resize(length);
+
+    // Gather the best bid (max bid) and best ask (min ask) of each time step
+    const double missing = std::numeric_limits<double>::quiet_NaN();
+    for (std::size_t i = 0; i < length && !bidAggregates.empty(); ++i)
+    {
+        const TimeStepAggregate& bids = bidAggregates[timeStepWindow[i]];
+        const TimeStepAggregate& asks = askAggregates[timeStepWindow[i]];
+        spreadSeries.bestBid[i] = bids.entries != 0 ? bids.maxPrice : missing;
+        spreadSeries.bestAsk[i] = asks.entries != 0 ? asks.minPrice : missing;
+    }
+
+    // Derive the spread measures element-wise, missing sides propagate as NaN
+    const double* bestBid = spreadSeries.bestBid.data();
+    const double* bestAsk = spreadSeries.bestAsk.data();
+    double* spread = spreadSeries.spread.data();
+    double* midPrice = spreadSeries.midPrice.data();
+    double* relativeSpread = spreadSeries.relativeSpread.data();
+    for (std::size_t i = 0; i < length; ++i)
+    {
+        spread[i] = bestAsk[i] - bestBid[i];
+        midPrice[i] = (bestAsk[i] + bestBid[i]) * 0.5;
+        relativeSpread[i] = spread[i] / midPrice[i];
+    }
+    return spreadSeries;
+}
+
+/** Compute the volume-weighted median of a set of price and amount records
+ *
+ *  @param priceAmountRecords Price and amount of each record
+ *  @return                   Lowest price at or below which at least half of the total amount lies, or 0 without records
+ *
+ */
+double UserCommands::computeVolumeWeightedMedian(std::vector<std::pair<double, double>>& priceAmountRecords)
+{
+    if (priceAmountRecords.empty())
+    {
+        return 0;
+    }
+
+    // Sort the records by ascending price
+    std::sort(priceAmountRecords.begin(), priceAmountRecords.end());
+
+    double totalAmount = 0;
+    for (const std::pair<double, double>& record : priceAmountRecords)
+    {
+        totalAmount += record.second;
+    }
+
+    // Accumulate amounts from the lowest price until half of the total is reached
+    double cumulativeAmount = 0;
+    for (const std::pair<double, double>& record : priceAmountRecords)
+    {
+        cumulativeAmount += record.second;
+        if (cumulativeAmount >= totalAmount / 2.0)
+        {
+            return record.first;
+        }
+    }
+    return priceAmountRecords.back().first;
+}
+
+/** Return the positions of the current and preceding time steps, moving into the past in a circular manner
+ *
+ *  A time range such as "11:57-12:03", or a duration such as "60s" ending at the current time, selects the
+ *  time steps within it instead, found by binary search over the timestamp index
+ *
+ *  @param currentTime  Current timestamp of simulation
+ *  @param numTimesteps Number of time steps in the window, a time range on the current date, or a duration
+ *  @return             positions within getTimeSteps(), starting at the current (or latest) time step
+ *
+ */
+std::vector<std::size_t> UserCommands::getTimeStepWindow(const std::string& currentTime, const std::string& numTimesteps, AdvisorBot *advisorBot)
+{
+    std::vector<std::size_t> window;
+
+    // A duration such as "60s" selects the time steps within that much time up to the current time step
+    std::int64_t duration = parseDurationWindow(numTimesteps);
+    if (duration > 0)
+    {
+        std::size_t begin, end;
+        std::int64_t now = TimeStamp::parse(currentTime);
+        advisorBot->book().getTimeStampIndex().findRange(now - duration + 1, now, begin, end);
+        for (std::size_t i = end; i-- > begin;)
+        {
+            window.push_back(i);
+        }
+        return window;
+    }
+
+    std::int64_t from, to;
+    if (TimeStampIndex::isRange(numTimesteps))
+    {
+        if (TimeStampIndex::parseRange(numTimesteps, TimeStamp::parse(currentTime), from, to))
+        {
+            std::size_t begin, end;
+            advisorBot->book().getTimeStampIndex().findRange(from, to, begin, end);
+            for (std::size_t i = end; i-- > begin;)
+            {
+                window.push_back(i);
+            }
+        }
+        return window;
+    }
+
+    long currentIndex = advisorBot->book().findTimeStep(currentTime);
+    std::size_t totalTimeSteps = advisorBot->book().getTimeSteps().size();
+    if (currentIndex < 0 || totalTimeSteps == 0)
+    {
+        return window;
+    }
+
+    // Wrap around to the latest time step after the earliest one, as getPreviousTimeStamp() does
+    long windowSize = std::stol(numTimesteps);
+    for (long i = 0; i < windowSize; ++i)
+    {
+        window.push_back(static_cast<std::size_t>(((currentIndex - i) % static_cast<long>(totalTimeSteps) + totalTimeSteps) % totalTimeSteps));
+    }
+    return window;
+}
+
+/** Validate the type, product and time step count shared by the four token windowed commands
+ *
+ *  @param SDBEtype     User-entered SDBE type
+ *  @param product      User-entered product
+ *  @param numTimesteps User-entered number of time steps
+ *
+ */
+void UserCommands::validateWindowedCommand(const std::string& SDBEtype, const std::string& product, const std::string& numTimesteps, AdvisorBot *advisorBot)
+{
+    // Validate SDBE type
+    if (!validateSDBEtype(SDBEtype))
+    {
+        std::cout << "Four token user command failed. StocksDataBookEntry type not recognized." << std::endl;
+        throw std::exception{};
+    }
+
+    // Validate product
+    if (!validateProduct(product, advisorBot))
+    {
+        std::cout << "Four token user command failed. Product not recognized." << std::endl;
+        throw std::exception{};
+    }
+
+    // Validate time step
+    if (!validateTimeStepWindow(numTimesteps))
+    {
+        std::cout << "Four token user command failed. Time step not recognized." << std::endl;
+        throw std::exception{};
+    }
+}
+
+/** Describe a window given as a number of time steps or as a time range, for command output
+ *
+ *  @param numTimesteps Number of time steps in the window, or a time range
+ *  @return             description such as "the last 10 time step(s)"
+ *
+ */
+std::string UserCommands::describeTimeStepWindow(const std::string& numTimesteps)
+{
+    if (parseDurationWindow(numTimesteps) > 0)
+    {
+        return "the last " + numTimesteps;
+    }
+    if (TimeStampIndex::isRange(numTimesteps))
+    {
+        return "the time steps from " + numTimesteps.substr(0, numTimesteps.find('-')) + " to " + numTimesteps.substr(numTimesteps.find('-') + 1);
+    }
+    return "the last " + numTimesteps + " time step(s)";
+}
+
+/** Convert a window given as a duration such as "60s", "5m" or "1h" into microseconds
+ *
+ *  @param numTimesteps User-entered window
+ *  @return             duration in microseconds, or 0 if the window is not a duration
+ *
+ */
+std::int64_t UserCommands::parseDurationWindow(const std::string& numTimesteps)
+{
+    CandleResolution duration;
+    return CandleEngine::parseResolution(numTimesteps, duration) ? duration.microseconds : 0;
+}
+
+/** Determine whether a window is given in time, as a range or a duration, rather than as a number of time steps
+ *
+ *  @param numTimesteps User-entered window
+ *  @return             true if the window is a time range or a duration, false otherwise
+ *
+ */
+bool UserCommands::isTimeWindow(const std::string& numTimesteps)
+{
+    return TimeStampIndex::isRange(numTimesteps) || parseDurationWindow(numTimesteps) > 0;
+}
+
+/** Determine a window's validity, given either as a positive number of time steps or as a time range
+ *
+ *  @param numTimesteps User-entered number of time steps or time range
+ *  @return             true if the window is valid, false otherwise
+ */
+bool UserCommands::validateTimeStepWindow(const std::string& numTimesteps)
+{
+    if (parseDurationWindow(numTimesteps) > 0)
+    {
+        return true;
+    }
+    if (TimeStampIndex::isRange(numTimesteps))
+    {
+        // Ranges are resolved against a fixed date, as only their syntax is checked here
+        std::int64_t from, to;
+        return TimeStampIndex::parseRange(numTimesteps, 0, from, to);
+    }
+    return validateTimeStep(numTimesteps) && std::stoi(numTimesteps) > 0;
+}
+
+/** Determine a time step's validity based on conversion success
+ *
+ *  @param timeStep User-entered time step
+ *  @return         true if the number of time steps is valid, false otherwise
  */
-void UserCommands::convertStringToLowercase(std::string& inputString)
+bool UserCommands::validateTimeStep(const std::string& timeStep)
 {
-    // Convert each character in the input string to lowercase
-    std::for_each(inputString.begin(), inputString.end(), [](unsigned char inputCharacter) {
-    inputCharacter = ::tolower(inputCharacter);
-    });
+    try
+    {
+        // Attempt to convert token into integer 
+        int intTimeStep = std::stoi(timeStep);
+        return true;
+    }
+    catch (const std::exception& e)
+    {
+        // Unsuccessful conversion from string time step to integer 
+        std::cout << "Unsuccessful conversion from string time step to integer" << std::endl;
+        return false;
+    }
+}
+
+/** Determine an amount's validity based on conversion success and sign
+ *
+ *  @param amount User-entered amount
+ *  @return       true if the amount is a positive number, false otherwise
+ */
+bool UserCommands::validateAmount(const std::string& amount)
+{
+    try
+    {
+        // Attempt to convert token into a positive double
+        return std::stod(amount) > 0;
+    }
+    catch (const std::exception& e)
+    {
+        // Unsuccessful conversion from string amount to double
+        std::cout << "Unsuccessful conversion from string amount to double" << std::endl;
+        return false;
+    }
+}
+
+/** Determine a product's validity by checking for its existence in the dataset
+ *
+ *  Products are matched exactly, as the shards and aggregates are keyed by the dataset's names. User input is
+ *  rewritten to those names before a command runs
+ *
+ *  @param product Product name as held in the dataset
+ *  @return        true if the product exists in the dataset, false otherwise
+ */
+bool UserCommands::validateProduct(std::string_view product, AdvisorBot *advisorBot)
+{
+    // Look the product up in the case-insensitive index, then reject names that only match regardless of case
+    const std::string* datasetProduct = advisorBot->book().findProduct(product);
+    return datasetProduct != nullptr && *datasetProduct == product;
+}
+
+/** Determine the SDBE type's validity by affirming its type is not unknown
+ *
+ *  @param SDBEtype User-entered SDBE type - ask/bid/unknown
+ *  @return         true if the string is represented by an ask or bid enumerator, false otherwise
+ *
+ */
+bool UserCommands::validateSDBEtype(std::string_view SDBEtype)
+{
+    // Affirm that the user-entered SDBE type is not an unknown enumeration after conversion
+    enum StocksDataBookType stocksDataBookType = StocksDataBookEntry::stringToStocksDataBookType(SDBEtype);
+    return stocksDataBookType != StocksDataBookType::unknown;
+}
+
+/** Determine max/min validity based on its enumeration constant representation 
+ *
+ *  @param maxOrMin String to be validated
+ *  @return         true if the string is represented by a max or min enumerator, false otherwise
+ *
+ */
+bool UserCommands::validateMaxMin(std::string_view maxOrMin)
+{
+    enum MaxMinType maxMinType = stringToMaxMinType(maxOrMin);
+    
+    // Match to valid enumeration constants
+    if (maxMinType == MaxMinType::min || maxMinType == MaxMinType::max)
+    {
+        return true;
+    }
+    
+    // Unknown enumeration constant
+    return false;
 }
 
 /** Convert a string to an max/min type 
@@ -715,11 +2038,8 @@ void UserCommands::convertStringToLowercase(std::string& inputString)
  *  @return            max/min enumerator representing the input string
  * 
  */
-MaxMinType UserCommands::stringToMaxMinType(std::string inputString)
+MaxMinType UserCommands::stringToMaxMinType(std::string_view inputString)
 {
-    // Convert input string to lowercase 
-    convertStringToLowercase(inputString);
-
     // Match input string to max
     if (inputString == "max")
     {
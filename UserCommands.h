@@ -3,14 +3,22 @@
 #include "StocksDataBookEntry.h"
 #include "StocksDataBook.h"
 #include "CSVFileReader.h"
+#include "FixedPoint.h"
 #include "AdvisorBot.h"
+#include "TimeStamp.h"
+#include "CorrelationMatrix.h"
+#include "ParameterSweep.h"
 #include <string>
+#include <string_view>
 #include <vector>
 #include <stack>
 #include <map>
 #include <functional>
 #include <iostream>
 #include <algorithm>
+#include <iomanip>
+#include <limits>
+#include <cmath>
 
 /** Establish max or min types */
 enum class MaxMinType
@@ -20,6 +28,16 @@ enum class MaxMinType
     unknown
 };
 
+/** Structure is used to hold the best prices and derived spread measures of a product over a series of time steps */
+struct SpreadSeries
+{
+    // One element per time step, NaN where a side has no SDBEs
+    std::vector<double> bestBid;
+    std::vector<double> bestAsk;
+    std::vector<double> spread;
+    std::vector<double> midPrice;
+    std::vector<double> relativeSpread;
+};
 
 class UserCommands
 {
@@ -54,29 +72,95 @@ public:
     /** Command 2: HELP MEDIAN - output help for the median command */
     static void Command2_HELP_median();
 
+    /** Command 2: HELP REPORT - output help for the report command */
+    static void Command2_HELP_report();
+
+    /** Command 2: HELP DEPTH - output help for the depth command */
+    static void Command2_HELP_depth();
+
+    /** Command 2: HELP IMPACT - output help for the impact command */
+    static void Command2_HELP_impact();
+
+    /** Command 2: HELP VWAP - output help for the vwap command */
+    static void Command2_HELP_vwap();
+
+    /** Command 2: HELP VWMEDIAN - output help for the vwmedian command */
+    static void Command2_HELP_vwmedian();
+
+    /** Command 2: HELP VOLUME - output help for the volume command */
+    static void Command2_HELP_volume();
+
+    /** Command 2: HELP SPREAD - output help for the spread command */
+    static void Command2_HELP_spread();
+
+    /** Command 2: HELP CANDLES - output help for the candles command */
+    static void Command2_HELP_candles();
+
+    /** Command 2: HELP VOL - output help for the vol command */
+    static void Command2_HELP_vol();
+
+    /** Command 2: HELP ZSCORE - output help for the zscore command */
+    static void Command2_HELP_zscore();
+
+    /** Command 2: HELP CORR - output help for the corr command */
+    static void Command2_HELP_corr();
+
+    /** Command 2: HELP BACKTEST - output help for the backtest command */
+    static void Command2_HELP_backtest();
+
+    /** Command 2: HELP SWEEP - output help for the sweep command */
+    static void Command2_HELP_sweep();
+
+    /** Command 2: HELP WALLET - output help for the wallet command */
+    static void Command2_HELP_wallet();
+
+    /** Command 2: HELP BUY - output help for the buy command */
+    static void Command2_HELP_buy();
+
+    /** Command 2: HELP SELL - output help for the sell command */
+    static void Command2_HELP_sell();
+
+    /** Command 2: HELP GOTO - output help for the goto command */
+    static void Command2_HELP_goto();
+
+    /** Command 2: HELP BACK - output help for the back command */
+    static void Command2_HELP_back();
+
+    /** Command 2: HELP FORWARD - output help for the forward command */
+    static void Command2_HELP_forward();
+
+    /** Command 2: HELP STATUS - output help for the status command */
+    static void Command2_HELP_status();
+
     /** Command 3: PROD - list available products in the dataset */
     static void Command3_PROD(AdvisorBot *advisorBot);
 
     /** Command 4: MIN - find minimum bid or ask for product in current time step */
-    static double Command4_MIN(std::string SDBEtype, std::string product, std::string currentTime, AdvisorBot *advisorBot);
+    static double Command4_MIN(const std::string& SDBEtype, const std::string& product, const std::string& currentTime, AdvisorBot *advisorBot);
 
     /** Auxiliary function to compute minimum bid or ask for product in current time step without providing user feedback */
-    static double computeMin(std::string SDBEtype, std::string product, std::string currentTime, AdvisorBot* advisorBot);
+    static double computeMin(const std::string& SDBEtype, const std::string& product, const std::string& currentTime, AdvisorBot* advisorBot);
 
     /** Command 5: MAX - find maximum bid or ask for product in current time step */
-    static double Command5_MAX(std::string SDBEtype, std::string product, std::string currentTime, AdvisorBot *advisorBot);
+    static double Command5_MAX(const std::string& SDBEtype, const std::string& product, const std::string& currentTime, AdvisorBot *advisorBot);
 
     /** Auxiliary function to compute maximum bid or ask for product in current time step without providing user feedback */
-    static double computeMax(std::string SDBEtype, std::string product, std::string currentTime, AdvisorBot* advisorBot);
+    static double computeMax(const std::string& SDBEtype, const std::string& product, const std::string& currentTime, AdvisorBot* advisorBot);
+
+    /** Validate the arguments of the min and max commands and summarize the SDBEs they select */
+    static TimeStepAggregate aggregateCurrentTimeStep(const std::string& SDBEtype, const std::string& product, const std::string& currentTime, AdvisorBot* advisorBot);
 
     /** Command 6: AVG - compute average bid or ask for product over sent number of time steps */
-    static double Command6_AVG(std::string SDBEtype, std::string product, std::string currentTime, std::string numTimesteps, AdvisorBot *advisorBot);
+    static double Command6_AVG(const std::string& SDBEtype, const std::string& product, const std::string& currentTime, const std::string& numTimesteps, AdvisorBot *advisorBot);
 
     /** Advance the timestamp in a circular manner */
     static void gotoNextTimeframe(AdvisorBot *advisorBot);
 
     /** Command 7: PREDICT - predict max or min bid or ask for sent product for the next time based on an EWMA */
-    static double Command7_PREDICT(std::string product, std::string maxOrMin, std::string currentTime, std::string SDBEtype, AdvisorBot *advisorBot);
+    static double Command7_PREDICT(const std::string& product, const std::string& maxOrMin, const std::string& currentTime, const std::string& SDBEtype, AdvisorBot *advisorBot);
+
+    /** Command 7: PREDICT - predict max or min bid or ask for sent product for the next candle based on an EWMA of candle highs or lows */
+    static double Command7_PREDICT_candles(const std::string& maxOrMin, const std::string& product, const std::string& SDBEtype, const std::string& resolution, const std::string& currentTime, AdvisorBot *advisorBot);
 
     /** Compute the Exponential Weighted Moving Average (EWMA) by analyzing historical data in the past sent number of time steps */
     static double computeEWMA(std::stack<double>& priceRecords, int timeStepsRemaining, std::vector<double>& intermediateEWMAs);
@@ -88,32 +172,137 @@ public:
     static void Command9_STEP(AdvisorBot *advisorBot);
 
     /** Compute the maximum ask or bid of a product for a specified number of time steps */
-    static void computeMaxForPeriod(std::stack<double>& priceRecords, std::string SDBEtype, std::string product, std::string currentTime, std::string numTimesteps, AdvisorBot *advisorBot);
+    static void computeMaxForPeriod(std::stack<double>& priceRecords, const std::string& SDBEtype, const std::string& product, const std::string& currentTime, const std::string& numTimesteps, AdvisorBot *advisorBot);
 
     /** Compute the minimum ask or bid of a product for a specified number of time steps */
-    static void computeMinForPeriod(std::stack<double>& priceRecords, std::string SDBEtype, std::string product, std::string currentTime, std::string numTimesteps, AdvisorBot *advisorBot);
+    static void computeMinForPeriod(std::stack<double>& priceRecords, const std::string& SDBEtype, const std::string& product, const std::string& currentTime, const std::string& numTimesteps, AdvisorBot *advisorBot);
 
     /** Command 10: MEDIAN - find the median ask or bid for the sent product over the sent number of time steps */
-    static double Command10_MEDIAN(std::string SDBEtype, std::string product, std::string currentTime, std::string numTimesteps, AdvisorBot *advisorBot);
+    static double Command10_MEDIAN(const std::string& SDBEtype, const std::string& product, const std::string& currentTime, const std::string& numTimesteps, AdvisorBot *advisorBot);
 
     /** Compute the median price of a range of prices for one or more time steps */
     static double computeMedian(std::vector<double>& priceRecords);
 
+    /** @overload static double computeMedian(std::vector<std::int64_t>& priceTickRecords, std::uint8_t decimals)
+     *
+     *  Compute the median price of a range of prices held as ticks, exactly until the conversion of the result
+     */
+    static double computeMedian(std::vector<std::int64_t>& priceTickRecords, std::uint8_t decimals);
+
+    /** Command 11: REPORT - print the report generated while loading the dataset */
+    static void Command11_REPORT(AdvisorBot *advisorBot);
+
+    /** Command 11: REPORT JSON - write the report generated while loading the dataset as JSON */
+    static void Command11_REPORT_json(AdvisorBot *advisorBot);
+
+    /** Command 12: DEPTH - list the aggregated bid and ask price levels of a product in the current time step */
+    static double Command12_DEPTH(const std::string& product, const std::string& numLevels, const std::string& currentTime, AdvisorBot *advisorBot);
+
+    /** Command 13: IMPACT - compute the price impact of filling an amount against the asks or bids of a product in the current time step */
+    static double Command13_IMPACT(const std::string& SDBEtype, const std::string& product, const std::string& currentTime, const std::string& amount, AdvisorBot *advisorBot);
+
+    /** Command 14: VWAP - compute the volume-weighted average ask or bid price for a product over the sent number of time steps */
+    static double Command14_VWAP(const std::string& SDBEtype, const std::string& product, const std::string& currentTime, const std::string& numTimesteps, AdvisorBot *advisorBot);
+
+    /** Command 15: VWMEDIAN - compute the volume-weighted median ask or bid price for a product over the sent number of time steps */
+    static double Command15_VWMEDIAN(const std::string& SDBEtype, const std::string& product, const std::string& currentTime, const std::string& numTimesteps, AdvisorBot *advisorBot);
+
+    /** Command 16: VOLUME - compute the total ask or bid amount for a product over the sent number of time steps */
+    static double Command16_VOLUME(const std::string& SDBEtype, const std::string& product, const std::string& currentTime, const std::string& numTimesteps, AdvisorBot *advisorBot);
+
+    /** Command 17: SPREAD - list the best bid, best ask, spread and mid price of a product over the sent number of time steps */
+    static double Command17_SPREAD(const std::string& product, const std::string& numTimesteps, const std::string& currentTime, AdvisorBot *advisorBot);
+
+    /** Command 18: CANDLES - list the OHLC/volume candles of a product and side at a resolution up to the current time step */
+    static double Command18_CANDLES(const std::string& product, const std::string& SDBEtype, const std::string& resolution, const std::string& numCandles, const std::string& currentTime, AdvisorBot *advisorBot);
+
+    /** Return the candles of a product and side at a resolution that start at or before the current time step */
+    static std::vector<Candle> getCandlesUpToTime(const std::string& product, const std::string& SDBEtype, const std::string& resolution, std::size_t numCandles, const std::string& currentTime, AdvisorBot *advisorBot);
+
+    /** Command 19: VOL - compute the rolling volatility of the ask or bid price of a product over the sent number of time steps */
+    static double Command19_VOL(const std::string& SDBEtype, const std::string& product, const std::string& currentTime, const std::string& numTimesteps, AdvisorBot *advisorBot);
+
+    /** Command 20: ZSCORE - compute the distance of the current ask or bid price of a product from its rolling mean, in standard deviations */
+    static double Command20_ZSCORE(const std::string& SDBEtype, const std::string& product, const std::string& currentTime, const std::string& numTimesteps, AdvisorBot *advisorBot);
+
+    /** Command 21: CORR - compute the correlation matrix of the mid prices of every product over the sent number of time steps */
+    static double Command21_CORR(const std::string& numTimesteps, const std::string& currentTime, AdvisorBot *advisorBot);
+
+    /** Command 22: BACKTEST - replay every time step of a product through the EWMA strategy and report its profit and loss */
+    static double Command22_BACKTEST(const std::string& product, const std::string& span, const std::string& threshold, AdvisorBot *advisorBot);
+
+    /** Command 23: SWEEP - find the EWMA spans and strategy thresholds that performed best on every product */
+    static double Command23_SWEEP(const std::string& SDBEtype, AdvisorBot *advisorBot);
+
+    /** Command 24: WALLET - list the balance of every currency in the wallet */
+    static void Command24_WALLET(AdvisorBot *advisorBot);
+
+    /** Command 25: BUY - buy an amount of a product's base currency at or below a limit price from the current asks */
+    static double Command25_BUY(const std::string& product, const std::string& amount, const std::string& price, const std::string& currentTime, AdvisorBot *advisorBot);
+
+    /** Command 26: SELL - sell an amount of a product's base currency at or above a limit price to the current bids */
+    static double Command26_SELL(const std::string& product, const std::string& amount, const std::string& price, const std::string& currentTime, AdvisorBot *advisorBot);
+
+    /** Command 27: GOTO - move the simulation to the time step in effect at a timestamp or time of day */
+    static double Command27_GOTO(const std::string& timestamp, const std::string& currentTime, AdvisorBot *advisorBot);
+
+    /** Command 28: BACK - move the simulation the sent number of time steps into the past */
+    static double Command28_BACK(const std::string& numTimesteps, const std::string& currentTime, AdvisorBot *advisorBot);
+
+    /** Command 29: FORWARD - move the simulation the sent number of time steps into the future */
+    static double Command29_FORWARD(const std::string& numTimesteps, const std::string& currentTime, AdvisorBot *advisorBot);
+
+    /** Command 30: STATUS - report the progress of loading the dataset */
+    static void Command30_STATUS(AdvisorBot *advisorBot);
+
+    /** Move the simulation to a position among the distinct timestamps and report the new time */
+    static double gotoTimeStep(long timeStepIndex, AdvisorBot *advisorBot);
+
+    /** Validate, match and settle a simulated order against the current time step */
+    static double placeOrder(StocksDataBookType orderType, const std::string& product, const std::string& amount, const std::string& price, const std::string& currentTime, AdvisorBot *advisorBot);
+
+    /** Extract the mid price series of every product over a window, aligned by time step and oldest first */
+    static std::vector<std::vector<double>> getAlignedMidPriceSeries(const std::vector<std::string>& products, const std::vector<std::size_t>& timeStepWindow, AdvisorBot *advisorBot);
+
+    /** Compute the best prices, spread, mid price and relative spread of a product for each time step provided */
+    static SpreadSeries computeSpreadSeries(const std::string& product, const std::vector<std::size_t>& timeStepWindow, AdvisorBot *advisorBot);
+
+    /** Compute the volume-weighted median of a set of price and amount records */
+    static double computeVolumeWeightedMedian(std::vector<std::pair<double, double>>& priceAmountRecords);
+
+    /** Return the positions of the current and preceding time steps, moving into the past in a circular manner */
+    static std::vector<std::size_t> getTimeStepWindow(const std::string& currentTime, const std::string& numTimesteps, AdvisorBot *advisorBot);
+
+    /** Describe a window given as a number of time steps or as a time range, for command output */
+    static std::string describeTimeStepWindow(const std::string& numTimesteps);
+
+    /** Convert a window given as a duration such as "60s", "5m" or "1h" into microseconds */
+    static std::int64_t parseDurationWindow(const std::string& numTimesteps);
+
+    /** Determine whether a window is given in time, as a range or a duration, rather than as a number of time steps */
+    static bool isTimeWindow(const std::string& numTimesteps);
+
+    /** Determine a window's validity, given either as a positive number of time steps or as a time range */
+    static bool validateTimeStepWindow(const std::string& numTimesteps);
+
+    /** Validate the type, product and time step count shared by the four token windowed commands */
+    static void validateWindowedCommand(const std::string& SDBEtype, const std::string& product, const std::string& numTimesteps, AdvisorBot *advisorBot);
+
     /** Determine a time step's validity based on conversion success */
-    static bool validateTimeStep(std::string timeStep);
+    static bool validateTimeStep(const std::string& timeStep);
+
+    /** Determine an amount's validity based on conversion success and sign */
+    static bool validateAmount(const std::string& amount);
 
     /** Determine a product's validity by checking for its existence in the dataset */
-    static bool validateProduct(std::string product, AdvisorBot *advisorBot);
+    static bool validateProduct(std::string_view product, AdvisorBot *advisorBot);
 
     /** Determine the SDBE type's validity by affirming its type is not unknown */
-    static bool validateSDBEtype(std::string SDBEtype);
+    static bool validateSDBEtype(std::string_view SDBEtype);
 
     /** Determine max/min validity based on its enumeration constant representation  */
-    static bool validateMaxMin(std::string maxOrMin);
-
-    /** Convert input string to lowercase */
-    static void convertStringToLowercase(std::string& inputString);
+    static bool validateMaxMin(std::string_view maxOrMin);
 
     /** Convert a string to an max/min type */
-    static MaxMinType stringToMaxMinType(std::string inputString);
+    static MaxMinType stringToMaxMinType(std::string_view inputString);
 };
\ No newline at end of file
@@ -0,0 +1,97 @@
+#include "VersionedBook.h"
+
+/** Take ownership of a dataset whose shards are placed and whose derived indexes are built
+ *
+ *  @param _book Dataset of the version
+ *
+ */
+BookVersion::BookVersion(StocksDataBook _book)
+    : book(std::move(_book))
+{
+}
+
+/** Initialize engines with empty caches over a version, keeping the version alive for as long as they exist
+ *
+ *  The engines fill their caches as queries arrive, so each reader builds its own rather than sharing the version's
+ *
+ *  @param _version Version whose book the engines read
+ *
+ */
+VersionEngines::VersionEngines(std::shared_ptr<const BookVersion> _version)
+    : version(std::move(_version))
+{
+}
+
+/** Publish a dataset as the first version
+ *
+ *  @param book Dataset of the first version
+ *
+ */
+VersionedBook::VersionedBook(StocksDataBook book)
+{
+    publish(std::move(book));
+}
+
+/** Return the latest version, which stays alive for as long as the pointer returned is held
+ *
+ *  @return latest version
+ *
+ */
+std::shared_ptr<const BookVersion> VersionedBook::pin() const
+{
+    return std::atomic_load(&latestVersion);
+}
+
+/** Replace a reader's pinned version with the latest, returning true if it changed
+ *
+ *  While no version has been published since the last call, this costs a single atomic load of the version
+ *  number. The version previously pinned is released, and reclaimed once no other reader pins it
+ *
+ *  @param pinnedVersion Version held by the reader, or null
+ *  @return              true if a newer version was pinned
+ *
+ */
+bool VersionedBook::pin(std::shared_ptr<const BookVersion>& pinnedVersion) const
+{
+    if (pinnedVersion != nullptr && pinnedVersion->number == latestNumber.load(std::memory_order_acquire))
+    {
+        return false;
+    }
+    pinnedVersion = std::atomic_load(&latestVersion);
+    return true;
+}
+
+/** Publish a dataset as the latest version, returning its number
+ *
+ *  The version is complete, indexes included, before it becomes visible, and never changes afterwards. Readers
+ *  still holding an earlier version keep reading it undisturbed
+ *
+ *  @param book Dataset of the new version
+ *  @return     number of the version published
+ *
+ */
+std::uint64_t VersionedBook::publish(StocksDataBook book)
+{
+    // Shards are placed on their nodes before the aggregates are built from them there
+    book.placeShards();
+
+    // Readers never build indexes, so they never observe one half-built. This is done outside the lock, as it is the costly part
+    book.buildDerivedIndexes();
+    auto version = std::make_shared<BookVersion>(std::move(book));
+
+    std::lock_guard<std::mutex> lock{ publishMutex };
+    version->number = latestNumber.load(std::memory_order_relaxed) + 1;
+    std::atomic_store(&latestVersion, std::shared_ptr<const BookVersion>{ version });
+    latestNumber.store(version->number, std::memory_order_release);
+    return version->number;
+}
+
+/** Return the number of the latest version
+ *
+ *  @return number of the latest version
+ *
+ */
+std::uint64_t VersionedBook::getLatestNumber() const
+{
+    return latestNumber.load(std::memory_order_acquire);
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "StocksDataBook.h"
+#include "DepthEngine.h"
+#include "CandleEngine.h"
+#include "VolatilityEngine.h"
+#include "Backtester.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+/** Immutable version of the dataset, shared between the thread publishing it and every reader pinning it */
+class BookVersion
+{
+public:
+    /** Take ownership of a dataset whose shards are placed and whose derived indexes are built */
+    BookVersion(StocksDataBook _book);
+
+    BookVersion(const BookVersion&) = delete;
+    BookVersion& operator=(const BookVersion&) = delete;
+
+    /** Position of the version in publication order, starting at 1 */
+    std::uint64_t number = 0;
+
+    /** SDBEs and indexes of the version, never changed once published */
+    const StocksDataBook book;
+};
+
+/** Engines answering queries about one pinned version, owned by a single reader so that their caches are never shared */
+class VersionEngines
+{
+public:
+    /** Initialize engines with empty caches over a version, keeping the version alive for as long as they exist */
+    VersionEngines(std::shared_ptr<const BookVersion> _version);
+
+    VersionEngines(const VersionEngines&) = delete;
+    VersionEngines& operator=(const VersionEngines&) = delete;
+
+    /** Version whose book the engines read */
+    const std::shared_ptr<const BookVersion> version;
+
+    /** Depth engine serving cached bid and ask ladders built from the SDBEs */
+    DepthEngine depthEngine{ version->book };
+
+    /** Candle engine serving cached OHLC/volume candles at several resolutions */
+    CandleEngine candleEngine{ version->book };
+
+    /** Volatility engine keeping rolling price and return statistics between commands */
+    VolatilityEngine volatilityEngine{ version->book, candleEngine };
+
+    /** Backtester replaying the dataset through trading strategies */
+    Backtester backtester{ version->book };
+};
+
+class VersionedBook
+{
+public:
+    /** Publish a dataset as the first version */
+    VersionedBook(StocksDataBook book);
+
+    VersionedBook(const VersionedBook&) = delete;
+    VersionedBook& operator=(const VersionedBook&) = delete;
+
+    /** Return the latest version, which stays alive for as long as the pointer returned is held */
+    std::shared_ptr<const BookVersion> pin() const;
+
+    /** Replace a reader's pinned version with the latest, returning true if it changed */
+    bool pin(std::shared_ptr<const BookVersion>& pinnedVersion) const;
+
+    /** Publish a dataset as the latest version, returning its number */
+    std::uint64_t publish(StocksDataBook book);
+
+    /** Return the number of the latest version */
+    std::uint64_t getLatestNumber() const;
+
+private:
+    /** Latest version, only ever read and replaced through the atomic shared pointer functions */
+    std::shared_ptr<const BookVersion> latestVersion;
+
+    /** Number of the latest version, checked by readers before touching the shared pointer */
+    std::atomic<std::uint64_t> latestNumber{ 0 };
+
+    /** Serializes writers, so that versions are numbered in publication order */
+    std::mutex publishMutex;
+};
@@ -0,0 +1,205 @@
+#include "VolatilityEngine.h"
+#include <algorithm>
+#include <cmath>
+
+/** Initialize running statistics over a sliding window of the most recent values
+ *
+ *  @param _windowSize Maximum number of values in the window
+ *
+ */
+RollingStatistics::RollingStatistics(std::size_t _windowSize)
+    : windowSize(std::max<std::size_t>(1, _windowSize)),
+    oldest(0),
+    mean(0),
+    sumSquaredDeviations(0)
+{
+    values.reserve(windowSize);
+}
+
+/** Add a value, evicting the oldest value once the window is full
+ *
+ *  Both cases update the Welford mean and sum of squared deviations in constant time
+ *
+ *  @param value Value to be added
+ *
+ */
+void RollingStatistics::push(double value)
+{
+    // Window still filling: standard Welford insertion
+    if (values.size() < windowSize)
+    {
+        values.push_back(value);
+        double delta = value - mean;
+        mean += delta / values.size();
+        sumSquaredDeviations += delta * (value - mean);
+        return;
+    }
+
+    // Window full: replace the oldest value, keeping the count constant
+    double evicted = values[oldest];
+    values[oldest] = value;
+    oldest = (oldest + 1) % windowSize;
+
+    double previousMean = mean;
+    mean += (value - evicted) / windowSize;
+    sumSquaredDeviations += (value - evicted) * (value - mean + evicted - previousMean);
+
+    // Guard against cancellation driving the sum slightly negative
+    if (sumSquaredDeviations < 0)
+    {
+        sumSquaredDeviations = 0;
+    }
+}
+
+/** Discard all values */
+void RollingStatistics::clear()
+{
+    values.clear();
+    oldest = 0;
+    mean = 0;
+    sumSquaredDeviations = 0;
+}
+
+/** Return the number of values in the window
+ *
+ *  @return number of values, at most the window size
+ *
+ */
+std::size_t RollingStatistics::getCount() const
+{
+    return values.size();
+}
+
+/** Return the mean of the values in the window
+ *
+ *  @return mean, or 0 if the window is empty
+ *
+ */
+double RollingStatistics::getMean() const
+{
+    return mean;
+}
+
+/** Return the sample variance of the values in the window
+ *
+ *  @return sample variance, or 0 with fewer than two values
+ *
+ */
+double RollingStatistics::getVariance() const
+{
+    return values.size() > 1 ? sumSquaredDeviations / (values.size() - 1) : 0;
+}
+
+/** Return the sample standard deviation of the values in the window
+ *
+ *  @return sample standard deviation, or 0 with fewer than two values
+ *
+ */
+double RollingStatistics::getStandardDeviation() const
+{
+    return std::sqrt(getVariance());
+}
+
+/** Initialize a volatility engine drawing its prices from single time step candles
+ *
+ *  @param _stocksDataBook Dataset whose time steps are navigated
+ *  @param _candleEngine   Source of the per time step reference prices
+ *
+ */
+VolatilityEngine::VolatilityEngine(const StocksDataBook& _stocksDataBook, CandleEngine& _candleEngine)
+    : stocksDataBook(_stocksDataBook),
+    candleEngine(_candleEngine)
+{
+}
+
+/** Return the rolling statistics of a product and side over a window of time steps ending at a timestamp
+ *
+ *  The window is kept between queries, so moving one time step forward costs a single constant-time update
+ *
+ *  @param product    Product name
+ *  @param side       SDBE type - ask/bid
+ *  @param windowSize Number of time steps in the window
+ *  @param timestamp  Timestamp of the newest time step in the window
+ *  @return           statistics of the window, with zero counts if the side has no prices up to the timestamp
+ *
+ */
+VolatilitySnapshot VolatilityEngine::getSnapshot(const std::string& product, StocksDataBookType side, std::size_t windowSize, const std::string& timestamp)
+{
+    VolatilitySnapshot snapshot{ 0, 0, 0, 0, 0, 0 };
+
+    // Reference prices of the time steps in which the side has SDBEs
+    CandleResolution timeStepResolution;
+    timeStepResolution.timeSteps = 1;
+    const std::vector<Candle>& candles = candleEngine.getCandles(product, side, timeStepResolution);
+
+    // Position of the newest price at or before the timestamp
+    long timeStepIndex = stocksDataBook.findTimeStep(timestamp);
+    auto end = std::upper_bound(candles.begin(), candles.end(), static_cast<std::size_t>(std::max(0L, timeStepIndex)),
+        [](std::size_t timeStep, const Candle& candle) { return timeStep < candle.firstTimeStep; });
+    long position = static_cast<long>(end - candles.begin()) - 1;
+    if (timeStepIndex < 0 || position < 0)
+    {
+        return snapshot;
+    }
+
+    std::string windowKey = product + '|' + (side == StocksDataBookType::bid ? "bid" : "ask") + '|' + std::to_string(windowSize);
+    auto it = rollingWindows.find(windowKey);
+    if (it == rollingWindows.end())
+    {
+        // Returns need one more price than there are returns in the window
+        it = rollingWindows.emplace(windowKey, RollingWindow{ RollingStatistics{ windowSize }, RollingStatistics{ std::max<std::size_t>(1, windowSize - 1) }, -1 }).first;
+    }
+    advanceWindow(it->second, candles, position, windowSize);
+
+    const RollingWindow& rollingWindow = it->second;
+    snapshot.price = candles[position].close;
+    snapshot.prices = rollingWindow.priceStatistics.getCount();
+    snapshot.meanPrice = rollingWindow.priceStatistics.getMean();
+    snapshot.priceStandardDeviation = rollingWindow.priceStatistics.getStandardDeviation();
+    snapshot.returnStandardDeviation = rollingWindow.returnStatistics.getStandardDeviation();
+    snapshot.zScore = snapshot.priceStandardDeviation > 0 ? (snapshot.price - snapshot.meanPrice) / snapshot.priceStandardDeviation : 0;
+    return snapshot;
+}
+
+/** Discard all cached windows */
+void VolatilityEngine::clearCache()
+{
+    rollingWindows.clear();
+}
+
+/** Slide a window forward to end at a position of the candle series
+ *
+ *  @param rollingWindow Window to be moved
+ *  @param candles       Single time step candles of the product and side
+ *  @param position      Position of the newest price to be included
+ *  @param windowSize    Number of prices in the window
+ *
+ */
+void VolatilityEngine::advanceWindow(RollingWindow& rollingWindow, const std::vector<Candle>& candles, long position, std::size_t windowSize)
+{
+    if (rollingWindow.newestPosition == position)
+    {
+        return;
+    }
+
+    // Refill the window when moving backwards or jumping further than the window itself
+    long firstPosition = rollingWindow.newestPosition + 1;
+    if (rollingWindow.newestPosition < 0 || position < rollingWindow.newestPosition
+        || position - rollingWindow.newestPosition > static_cast<long>(windowSize))
+    {
+        rollingWindow.priceStatistics.clear();
+        rollingWindow.returnStatistics.clear();
+        firstPosition = std::max(0L, position - static_cast<long>(windowSize) + 1);
+    }
+
+    // Constant-time update per price entering the window, with a return whenever its predecessor is also in the window
+    for (long i = firstPosition; i <= position; ++i)
+    {
+        rollingWindow.priceStatistics.push(candles[i].close);
+        if (rollingWindow.priceStatistics.getCount() > 1 && candles[i - 1].close > 0 && candles[i].close > 0)
+        {
+            rollingWindow.returnStatistics.push(std::log(candles[i].close / candles[i - 1].close));
+        }
+    }
+    rollingWindow.newestPosition = position;
+}
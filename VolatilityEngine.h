@@ -0,0 +1,99 @@
+#pragma once
+
+#include "StocksDataBookEntry.h"
+#include "StocksDataBook.h"
+#include "CandleEngine.h"
+#include <string>
+#include <vector>
+#include <map>
+
+class RollingStatistics
+{
+public:
+    /** Initialize running statistics over a sliding window of the most recent values */
+    RollingStatistics(std::size_t _windowSize);
+
+    /** Add a value, evicting the oldest value once the window is full */
+    void push(double value);
+
+    /** Discard all values */
+    void clear();
+
+    /** Return the number of values in the window */
+    std::size_t getCount() const;
+
+    /** Return the mean of the values in the window */
+    double getMean() const;
+
+    /** Return the sample variance of the values in the window */
+    double getVariance() const;
+
+    /** Return the sample standard deviation of the values in the window */
+    double getStandardDeviation() const;
+
+private:
+    /** Maximum number of values in the window */
+    std::size_t windowSize;
+
+    /** Ring buffer of the values in the window, and the position of the oldest value */
+    std::vector<double> values;
+    std::size_t oldest;
+
+    /** Welford running mean and sum of squared deviations from the mean */
+    double mean;
+    double sumSquaredDeviations;
+};
+
+/** Structure is used to return the rolling statistics of a product and side at one time step */
+struct VolatilitySnapshot
+{
+    // Reference price of the time step and the number of prices in the window
+    double price;
+    std::size_t prices;
+
+    // Mean and standard deviation of the prices in the window
+    double meanPrice;
+    double priceStandardDeviation;
+
+    // Standard deviation of the log returns between consecutive prices in the window
+    double returnStandardDeviation;
+
+    // Distance of the price from the mean, in standard deviations
+    double zScore;
+};
+
+class VolatilityEngine
+{
+public:
+    /** Initialize a volatility engine drawing its prices from single time step candles */
+    VolatilityEngine(const StocksDataBook& _stocksDataBook, CandleEngine& _candleEngine);
+
+    /** Return the rolling statistics of a product and side over a window of time steps ending at a timestamp */
+    VolatilitySnapshot getSnapshot(const std::string& product, StocksDataBookType side, std::size_t windowSize, const std::string& timestamp);
+
+    /** Discard all cached windows */
+    void clearCache();
+
+private:
+    /** Structure is used to hold the sliding window of one product, side and window size */
+    struct RollingWindow
+    {
+        RollingStatistics priceStatistics;
+        RollingStatistics returnStatistics;
+
+        // Position of the newest price in the window within the candle series, or -1 if empty
+        long newestPosition;
+    };
+
+    /** Slide a window forward to end at a position of the candle series */
+    static void advanceWindow(RollingWindow& rollingWindow, const std::vector<Candle>& candles, long position, std::size_t windowSize);
+
+    /** Dataset whose time steps are navigated */
+    const StocksDataBook& stocksDataBook;
+
+    /** Source of the per time step reference prices */
+    CandleEngine& candleEngine;
+
+    /** Windows kept between queries, keyed by product, side and window size */
+    std::map<std::string, RollingWindow> rollingWindows;
+};
@@ -0,0 +1,92 @@
+#include "Wallet.h"
+
+/** Initialize an empty wallet */
+Wallet::Wallet()
+{
+}
+
+/** Add an amount of a currency
+ *
+ *  @param currency Currency name, e.g. BTC
+ *  @param amount   Non-negative amount to be added
+ *
+ */
+void Wallet::insertCurrency(const std::string& currency, double amount)
+{
+    if (amount < 0)
+    {
+        return;
+    }
+    balances[currency] += amount;
+}
+
+/** Remove an amount of a currency, returning false without changes if the balance is insufficient
+ *
+ *  @param currency Currency name, e.g. BTC
+ *  @param amount   Non-negative amount to be removed
+ *  @return         true if the amount was removed, false otherwise
+ *
+ */
+bool Wallet::removeCurrency(const std::string& currency, double amount)
+{
+    if (amount < 0 || !containsCurrency(currency, amount))
+    {
+        return false;
+    }
+    balances[currency] -= amount;
+    return true;
+}
+
+/** Determine whether the wallet holds at least an amount of a currency
+ *
+ *  @param currency Currency name, e.g. BTC
+ *  @param amount   Amount required
+ *  @return         true if the balance covers the amount, false otherwise
+ *
+ */
+bool Wallet::containsCurrency(const std::string& currency, double amount) const
+{
+    return getBalance(currency) >= amount;
+}
+
+/** Return the balance of a currency
+ *
+ *  @param currency Currency name, e.g. BTC
+ *  @return         balance, 0 for currencies never held
+ *
+ */
+double Wallet::getBalance(const std::string& currency) const
+{
+    auto it = balances.find(currency);
+    return it != balances.end() ? it->second : 0;
+}
+
+/** Return every currency with its balance
+ *
+ *  @return balances keyed by currency name
+ *
+ */
+const std::map<std::string, double>& Wallet::getBalances() const
+{
+    return balances;
+}
+
+/** Split a product such as "ETH/BTC" into its base and quote currencies
+ *
+ *  @param product       Product name
+ *  @param baseCurrency  Receives the currency being bought or sold, e.g. ETH
+ *  @param quoteCurrency Receives the currency in which prices are expressed, e.g. BTC
+ *  @return              true if the product has the form base/quote, false otherwise
+ *
+ */
+bool Wallet::splitProduct(const std::string& product, std::string& baseCurrency, std::string& quoteCurrency)
+{
+    std::size_t separator = product.find('/');
+    if (separator == std::string::npos || separator == 0 || separator + 1 == product.size())
+    {
+        return false;
+    }
+    baseCurrency = product.substr(0, separator);
+    quoteCurrency = product.substr(separator + 1);
+    return true;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <string>
+#include <map>
+
+class Wallet
+{
+public:
+    /** Initialize an empty wallet */
+    Wallet();
+
+    /** Add an amount of a currency */
+    void insertCurrency(const std::string& currency, double amount);
+
+    /** Remove an amount of a currency, returning false without changes if the balance is insufficient */
+    bool removeCurrency(const std::string& currency, double amount);
+
+    /** Determine whether the wallet holds at least an amount of a currency */
+    bool containsCurrency(const std::string& currency, double amount) const;
+
+    /** Return the balance of a currency */
+    double getBalance(const std::string& currency) const;
+
+    /** Return every currency with its balance */
+    const std::map<std::string, double>& getBalances() const;
+
+    /** Split a product such as "ETH/BTC" into its base and quote currencies */
+    static bool splitProduct(const std::string& product, std::string& baseCurrency, std::string& quoteCurrency);
+
+private:
+    /** Balance of each currency */
+    std::map<std::string, double> balances;
+};
@@ -0,0 +1,1452 @@
+#include "SyntheticOrderBookGenerator.h"
+#include "AdvisorBot.h"
+#include "AllocationCounter.h"
+#include "UserCommands.h"
+#include "CSVFileReader.h"
+#include "CSVScanner.h"
+#include "PipelinedFileReader.h"
+#include "CorrelationMatrix.h"
+#include "BookArchive.h"
+#include "BookSorter.h"
+#include "VersionedBook.h"
+#include "FixedPoint.h"
+#include <benchmark/benchmark.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <thread>
+
+namespace
+{
+    /** Structure is used to share one synthetic book between all benchmarks */
+    struct BenchmarkBook
+    {
+        std::string csvFilename;
+        std::unique_ptr<AdvisorBot> advisorBot;
+        std::string product;
+    };
+
+    /** Read a size from the environment, falling back to a default */
+    std::size_t environmentSize(const char* name, std::size_t defaultValue)
+    {
+        const char* value = std::getenv(name);
+        return value != nullptr ? std::strtoull(value, nullptr, 10) : defaultValue;
+    }
+
+    /** Stream buffer discarding whatever is written to it, reusing one fixed buffer so that writing never allocates */
+    class DiscardStreamBuffer : public std::streambuf
+    {
+    public:
+        DiscardStreamBuffer() { setp(buffer, buffer + sizeof(buffer)); }
+
+    protected:
+        int overflow(int character) override
+        {
+            setp(buffer, buffer + sizeof(buffer));
+            return traits_type::not_eof(character);
+        }
+
+    private:
+        char buffer[1024];
+    };
+
+    /** Discards everything written to std::cout while in scope, so that command output does not reach the reporter */
+    class SilenceStandardOutput
+    {
+    public:
+        SilenceStandardOutput() : previousBuffer(std::cout.rdbuf(&discardBuffer)) {}
+        ~SilenceStandardOutput() { std::cout.rdbuf(previousBuffer); }
+
+    private:
+        DiscardStreamBuffer discardBuffer;
+        std::streambuf* previousBuffer;
+    };
+
+    /** Generate the synthetic book on first use and load it into an Advisor Bot */
+    BenchmarkBook& getBenchmarkBook()
+    {
+        static BenchmarkBook benchmarkBook = []()
+        {
+            // Size of the book, overridable from the environment
+            SyntheticOrderBookConfig config;
+            config.rows = environmentSize("ADVISORBOT_BENCH_ROWS", 200000);
+            config.products = environmentSize("ADVISORBOT_BENCH_PRODUCTS", 4);
+            config.timesteps = environmentSize("ADVISORBOT_BENCH_TIMESTEPS", 500);
+
+            BenchmarkBook book;
+            book.csvFilename = (std::filesystem::temp_directory_path() / "advisorbot_bench.csv").string();
+            SyntheticOrderBookGenerator generator{ config };
+            generator.writeCSVfile(book.csvFilename);
+            book.product = generator.getProducts().front();
+
+            SilenceStandardOutput silence;
+            book.advisorBot = std::make_unique<AdvisorBot>(book.csvFilename);
+            book.advisorBot->currentTime = book.advisorBot->book().getEarliestTimeStamp();
+
+            // Place the simulation in the middle of the day so that historical commands have data behind them
+            for (std::size_t i = 0; i < config.timesteps / 2; ++i)
+            {
+                book.advisorBot->currentTime = book.advisorBot->book().getNextTimeStamp(book.advisorBot->currentTime);
+            }
+            return book;
+        }();
+        return benchmarkBook;
+    }
+
+    /** Load the synthetic book in fixed-point mode on first use, at the same simulation time as the shared book */
+    AdvisorBot& getFixedPointAdvisorBot()
+    {
+        static std::unique_ptr<AdvisorBot> advisorBot = []()
+        {
+            BenchmarkBook& book = getBenchmarkBook();
+            CSVReadOptions options;
+            options.fixedPoint = true;
+
+            SilenceStandardOutput silence;
+            auto fixedPointBot = std::make_unique<AdvisorBot>(std::vector<std::string>{ book.csvFilename }, options);
+            fixedPointBot->currentTime = book.advisorBot->currentTime;
+            return fixedPointBot;
+        }();
+        return *advisorBot;
+    }
+}
+
+// Ingest
+
+static void BM_Ingest_readCSVfile(benchmark::State& state)
+{
+    BenchmarkBook& book = getBenchmarkBook();
+    SilenceStandardOutput silence;
+    for (auto _ : state)
+    {
+        LoadReport loadReport;
+        benchmark::DoNotOptimize(CSVFileReader::readCSVfile(book.csvFilename, loadReport));
+        state.counters["bytes"] = static_cast<double>(loadReport.bytesRead);
+        state.counters["rows"] = static_cast<double>(loadReport.rowsParsed);
+    }
+}
+BENCHMARK(BM_Ingest_readCSVfile)->Unit(benchmark::kMillisecond);
+
+static void BM_Ingest_tokenize(benchmark::State& state)
+{
+    std::string csvLine = "2020/06/01 11:57:30.328127,ETH/BTC,bid,0.02187308,7.44564869";
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(CSVFileReader::tokenize(csvLine, ','));
+    }
+}
+BENCHMARK(BM_Ingest_tokenize);
+
+static void BM_Ingest_parseCSVline(benchmark::State& state)
+{
+    std::string csvLine = "2020/06/01 11:57:30.328127,ETH/BTC,bid,0.02187308,7.44564869";
+    CSVRow row;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(CSVFileReader::parseCSVline(csvLine, row));
+        benchmark::DoNotOptimize(row);
+    }
+}
+BENCHMARK(BM_Ingest_parseCSVline);
+
+static void BM_Ingest_readCSVfile_fixedPoint(benchmark::State& state)
+{
+    BenchmarkBook& book = getBenchmarkBook();
+    CSVReadOptions options;
+    options.fixedPoint = state.range(0) != 0;
+    state.SetLabel(options.fixedPoint ? "fixed point" : "floating point");
+
+    SilenceStandardOutput silence;
+    for (auto _ : state)
+    {
+        LoadReport loadReport;
+        benchmark::DoNotOptimize(CSVFileReader::readCSVfile(book.csvFilename, loadReport, options));
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * std::filesystem::file_size(book.csvFilename)));
+}
+BENCHMARK(BM_Ingest_readCSVfile_fixedPoint)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+static void BM_FixedPoint_equivalence(benchmark::State& state)
+{
+    std::mt19937_64 generator{ 20200601 };
+    std::size_t numbersChecked = 0;
+    for (auto _ : state)
+    {
+        // A plain decimal of up to maxUnits units, with up to maxDecimals digits after the point
+        int decimals = static_cast<int>(generator() % (FixedPoint::maxDecimals + 1));
+        std::int64_t expectedUnits = static_cast<std::int64_t>(generator() % (FixedPoint::maxUnits + 1));
+        std::string text = std::to_string(expectedUnits);
+        if (decimals > 0)
+        {
+            text.insert(0, static_cast<std::size_t>(std::max(0, decimals + 1 - static_cast<int>(text.size()))), '0');
+            text.insert(text.size() - static_cast<std::size_t>(decimals), ".");
+        }
+
+        double expected = 0;
+        std::from_chars(text.data(), text.data() + text.size(), expected);
+
+        std::int64_t units = 0;
+        std::uint8_t parsedDecimals = 0;
+        bool parsed = FixedPoint::parse(text, units, parsedDecimals);
+        if (!parsed || units != expectedUnits || parsedDecimals != decimals || FixedPoint::toDouble(units, parsedDecimals) != expected
+            || FixedPoint::fromDouble(expected, parsedDecimals) != expectedUnits)
+        {
+            state.SkipWithError(("Fixed-point parsing disagrees with std::from_chars for " + text).c_str());
+            break;
+        }
+        ++numbersChecked;
+    }
+    state.counters["numbers"] = static_cast<double>(numbersChecked);
+}
+BENCHMARK(BM_FixedPoint_equivalence)->Iterations(20000);
+
+static void BM_Ingest_readCSVfile_dirty(benchmark::State& state)
+{
+    BenchmarkBook& book = getBenchmarkBook();
+
+    // Corrupt one line in ten, cycling through the reject reasons
+    std::string dirtyFilename = (std::filesystem::temp_directory_path() / "advisorbot_bench_dirty.csv").string();
+    {
+        std::ifstream csvFile{ book.csvFilename };
+        std::ofstream dirtyFile{ dirtyFilename };
+        const char* corruptions[] = { ",abc,1", ",1", ",sell,1,1" };
+        std::string line;
+        for (std::size_t lineNumber = 0; std::getline(csvFile, line); ++lineNumber)
+        {
+            dirtyFile << (lineNumber % 10 == 0 ? line.substr(0, line.find(',', 27)) + corruptions[lineNumber / 10 % 3] : line) << '\n';
+        }
+    }
+
+    SilenceStandardOutput silence;
+    std::ostringstream quarantine;
+    CSVReadOptions options;
+    options.quarantineStream = state.range(0) != 0 ? &quarantine : nullptr;
+    for (auto _ : state)
+    {
+        LoadReport loadReport;
+        quarantine.str("");
+        benchmark::DoNotOptimize(CSVFileReader::readCSVfile(dirtyFilename, loadReport, options));
+        state.counters["rejected"] = static_cast<double>(loadReport.getRowsRejected());
+    }
+}
+BENCHMARK(BM_Ingest_readCSVfile_dirty)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+static void BM_Ingest_readCSVfile_readMethod(benchmark::State& state)
+{
+    BenchmarkBook& book = getBenchmarkBook();
+    CSVReadOptions options;
+    options.readMethod = state.range(0) != 0 ? CSVReadMethod::pipelined : CSVReadMethod::stream;
+    bool coldCache = state.range(1) != 0;
+    state.SetLabel(std::string{ state.range(0) != 0 ? "pipelined" : "stream" } + (coldCache ? ", cold cache" : ", warm cache"));
+
+    SilenceStandardOutput silence;
+    for (auto _ : state)
+    {
+        // Evict the file from the page cache so that every load waits on the disk
+        if (coldCache)
+        {
+            state.PauseTiming();
+            int fileDescriptor = open(book.csvFilename.c_str(), O_RDONLY);
+            if (fileDescriptor >= 0)
+            {
+                fdatasync(fileDescriptor);
+                posix_fadvise(fileDescriptor, 0, 0, POSIX_FADV_DONTNEED);
+                close(fileDescriptor);
+            }
+            state.ResumeTiming();
+        }
+
+        LoadReport loadReport;
+        benchmark::DoNotOptimize(CSVFileReader::readCSVfile(book.csvFilename, loadReport, options));
+        state.counters["readWait"] = loadReport.phaseTimes.readSeconds;
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * std::filesystem::file_size(book.csvFilename)));
+}
+BENCHMARK(BM_Ingest_readCSVfile_readMethod)->ArgsProduct({ { 0, 1 }, { 0, 1 } })->Unit(benchmark::kMillisecond);
+
+// Check rather than a measurement: reading through small buffers and carrying the unfinished line of each chunk over
+// must reassemble the file exactly, including a line longer than the room reserved for carried bytes
+static void BM_PipelinedFileReader_reassemble(benchmark::State& state)
+{
+    BenchmarkBook& book = getBenchmarkBook();
+    std::string reassembleFilename = (std::filesystem::temp_directory_path() / "advisorbot_bench_reassemble.csv").string();
+    std::string expected;
+    {
+        std::ifstream csvFile{ book.csvFilename, std::ios::binary };
+        expected.assign(std::istreambuf_iterator<char>{ csvFile }, std::istreambuf_iterator<char>{});
+        expected.resize(std::min<std::size_t>(expected.size(), 1 << 20));
+        expected += std::string(PipelinedFileReader::carryBytes * 2, 'x') + "\nlast line without terminator";
+        std::ofstream reassembleFile{ reassembleFilename, std::ios::binary };
+        reassembleFile << expected;
+    }
+
+    for (auto _ : state)
+    {
+        PipelinedFileReader fileReader{ reassembleFilename, static_cast<std::size_t>(state.range(0)) };
+        std::string reassembled;
+        std::size_t carriedBytes = 0;
+        FileChunk chunk;
+        do
+        {
+            chunk = fileReader.nextChunk(carriedBytes);
+            std::string_view lines{ chunk.data, chunk.bytes };
+            std::size_t lastNewline = lines.rfind('\n');
+            std::size_t completeBytes = chunk.last || lastNewline == std::string_view::npos ? (chunk.last ? chunk.bytes : 0) : lastNewline + 1;
+            reassembled.append(lines.substr(0, completeBytes));
+            carriedBytes = chunk.bytes - completeBytes;
+        } while (!chunk.last);
+
+        if (reassembled != expected)
+        {
+            state.SkipWithError("Pipelined reader did not reassemble the file");
+            break;
+        }
+    }
+}
+BENCHMARK(BM_PipelinedFileReader_reassemble)->Arg(4096)->Arg(65536)->Unit(benchmark::kMillisecond);
+
+static void BM_AdvisorBot_firstCommand(benchmark::State& state)
+{
+    BenchmarkBook& book = getBenchmarkBook();
+    BookLoadMode loadMode = state.range(0) != 0 ? BookLoadMode::background : BookLoadMode::foreground;
+    state.SetLabel(state.range(0) != 0 ? "background" : "foreground");
+
+    // Time from starting the Advisor Bot until a command about the first time step can run
+    SilenceStandardOutput silence;
+    for (auto _ : state)
+    {
+        AdvisorBot advisorBot{ std::vector<std::string>{ book.csvFilename }, CSVReadOptions{}, loadMode };
+        advisorBot.awaitDataset(false);
+        benchmark::DoNotOptimize(advisorBot.book().getEntries().size());
+
+        // Leave the rest of the load, and its cancellation, out of the measurement
+        state.PauseTiming();
+        advisorBot.awaitDataset(true);
+        state.ResumeTiming();
+    }
+}
+BENCHMARK(BM_AdvisorBot_firstCommand)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+static void BM_VersionedBook_pin(benchmark::State& state)
+{
+    // Refresh a pinned version as each command does, against taking a new reference to the latest version
+    BenchmarkBook& book = getBenchmarkBook();
+    VersionedBook& versionedBook = book.advisorBot->versionedBook;
+    bool refresh = state.range(0) == 0;
+    state.SetLabel(refresh ? "refresh" : "atomic_load");
+    std::shared_ptr<const BookVersion> pinnedVersion = versionedBook.pin();
+    for (auto _ : state)
+    {
+        if (refresh)
+        {
+            benchmark::DoNotOptimize(versionedBook.pin(pinnedVersion));
+        }
+        else
+        {
+            std::shared_ptr<const BookVersion> latestVersion = versionedBook.pin();
+            benchmark::DoNotOptimize(latestVersion.get());
+        }
+    }
+}
+BENCHMARK(BM_VersionedBook_pin)->Arg(0)->Arg(1);
+
+static void BM_VersionedBook_publishWhileReading(benchmark::State& state)
+{
+    // A writer publishes ever longer prefixes of the benchmark book while the reader pins and checks each version it sees
+    BenchmarkBook& book = getBenchmarkBook();
+    const std::vector<StocksDataBookEntry>& entries = book.advisorBot->book().getEntries();
+    std::size_t numVersions = static_cast<std::size_t>(state.range(0));
+    for (auto _ : state)
+    {
+        VersionedBook versionedBook{ StocksDataBook{} };
+        std::weak_ptr<const BookVersion> firstVersion = versionedBook.pin();
+        std::thread writer{ [&]()
+        {
+            for (std::size_t i = 1; i <= numVersions; ++i)
+            {
+                StocksDataBook prefix;
+                prefix.appendSDBEentries(std::vector<StocksDataBookEntry>(entries.begin(), entries.begin() + entries.size() * i / numVersions));
+                versionedBook.publish(std::move(prefix));
+            }
+        } };
+
+        std::shared_ptr<const BookVersion> pinnedVersion;
+        std::size_t versionsSeen = 0;
+        bool complete = true;
+        do
+        {
+            if (!versionedBook.pin(pinnedVersion))
+            {
+                std::this_thread::yield();
+                continue;
+            }
+            ++versionsSeen;
+
+            // Every index of a pinned version covers all of its SDBEs
+            const StocksDataBook& versionBook = pinnedVersion->book;
+            const std::vector<TimeStepRange>& timeSteps = versionBook.getTimeSteps();
+            const std::vector<TimeStepAggregate>& aggregates = versionBook.getTimeStepAggregates(book.product, StocksDataBookType::ask);
+            complete = complete
+                && (timeSteps.empty() ? versionBook.getEntries().empty() : timeSteps.back().end == versionBook.getEntries().size())
+                && versionBook.getTimeStampIndex().size() == timeSteps.size()
+                && (aggregates.empty() || aggregates.size() == timeSteps.size());
+        } while (pinnedVersion->number <= numVersions);
+        writer.join();
+
+        if (!complete)
+        {
+            state.SkipWithError("A pinned version held incomplete indexes");
+            break;
+        }
+        if (!firstVersion.expired())
+        {
+            state.SkipWithError("A superseded version was not reclaimed");
+            break;
+        }
+        state.counters["versionsSeen"] = static_cast<double>(versionsSeen);
+    }
+}
+BENCHMARK(BM_VersionedBook_publishWhileReading)->Arg(8)->Unit(benchmark::kMillisecond);
+
+static void BM_Ingest_multipleFiles(benchmark::State& state)
+{
+    BenchmarkBook& book = getBenchmarkBook();
+
+    // Deal the lines of the benchmark book round-robin into as many files as requested
+    std::size_t numFiles = static_cast<std::size_t>(state.range(0));
+    std::vector<std::string> filenames;
+    std::vector<std::ofstream> files;
+    for (std::size_t i = 0; i < numFiles; ++i)
+    {
+        filenames.push_back((std::filesystem::temp_directory_path() / ("advisorbot_bench_part" + std::to_string(i) + ".csv")).string());
+        files.emplace_back(filenames.back());
+    }
+    std::ifstream csvFile{ book.csvFilename };
+    std::string line;
+    for (std::size_t lineNumber = 0; std::getline(csvFile, line); ++lineNumber)
+    {
+        files[lineNumber % numFiles] << line << '\n';
+    }
+    files.clear();
+
+    SilenceStandardOutput silence;
+    for (auto _ : state)
+    {
+        StocksDataBook stocksDataBook{ filenames };
+        benchmark::DoNotOptimize(stocksDataBook.getEntries().data());
+        state.counters["rows"] = static_cast<double>(stocksDataBook.getEntries().size());
+    }
+}
+BENCHMARK(BM_Ingest_multipleFiles)->Arg(1)->Arg(4)->Unit(benchmark::kMillisecond);
+
+// CSV scanner
+
+namespace
+{
+    /** Split a line on a separator with repeated find_first_of calls, as the tokenizer did before the vectorized scanner */
+    std::vector<std::string> referenceTokenize(const std::string& csvLine, char separator)
+    {
+        std::vector<std::string> tokens;
+        std::size_t start = 0;
+        std::size_t end = csvLine.find_first_of(separator);
+        while (true)
+        {
+            tokens.emplace_back(csvLine.substr(start, end == std::string::npos ? std::string::npos : end - start));
+            if (end == std::string::npos)
+            {
+                break;
+            }
+            start = end + 1;
+            end = csvLine.find_first_of(separator, start);
+        }
+        return tokens;
+    }
+
+    /** Generate a random line dense in separators, including leading, trailing and consecutive ones, that spans several 64-byte blocks */
+    std::string randomCSVLine(std::mt19937& generator)
+    {
+        const char alphabet[] = { ',', ',', ',', 'a', 'Z', '0', '.', ' ', '\r', '\n', '\xff', '\x80' };
+        std::size_t length = std::uniform_int_distribution<std::size_t>{ 0, 200 }(generator);
+        std::uniform_int_distribution<std::size_t> pick{ 0, sizeof(alphabet) - 1 };
+
+        std::string csvLine;
+        for (std::size_t i = 0; i < length; ++i)
+        {
+            csvLine += alphabet[pick(generator)];
+        }
+        return csvLine;
+    }
+
+    /** Split a line with the scanner into the tokens between separators */
+    std::vector<std::string> scannerTokenize(const std::string& csvLine, char separator, CSVScannerImplementation implementation)
+    {
+        std::vector<std::uint32_t> delimiters;
+        CSVScanner::findDelimiters(csvLine.data(), csvLine.size(), separator, separator, delimiters, implementation);
+
+        std::vector<std::string> tokens;
+        std::size_t start = 0;
+        for (std::uint32_t end : delimiters)
+        {
+            tokens.emplace_back(csvLine, start, end - start);
+            start = end + 1;
+        }
+        tokens.emplace_back(csvLine, start);
+        return tokens;
+    }
+
+    /** Scanner implementations supported by the processor */
+    std::vector<CSVScannerImplementation> getSupportedImplementations()
+    {
+        std::vector<CSVScannerImplementation> implementations;
+        for (CSVScannerImplementation implementation : { CSVScannerImplementation::scalar, CSVScannerImplementation::sse2, CSVScannerImplementation::avx2 })
+        {
+            if (CSVScanner::isSupported(implementation))
+            {
+                implementations.push_back(implementation);
+            }
+        }
+        return implementations;
+    }
+}
+
+// Fuzz-style equivalence check rather than a measurement: every scanner implementation and the tokenizer must split
+// random lines exactly as the original find_first_of tokenizer does, and find the same commas and newlines
+static void BM_CSVScanner_equivalence(benchmark::State& state)
+{
+    std::mt19937 generator{ 20200601 };
+    std::vector<CSVScannerImplementation> implementations = getSupportedImplementations();
+    std::size_t linesChecked = 0;
+    for (auto _ : state)
+    {
+        std::string csvLine = randomCSVLine(generator);
+        std::vector<std::string> expected = referenceTokenize(csvLine, ',');
+
+        bool equivalent = CSVFileReader::tokenize(csvLine, ',') == expected;
+        std::vector<std::uint32_t> expectedDelimiters;
+        CSVScanner::findDelimiters(csvLine.data(), csvLine.size(), ',', '\n', expectedDelimiters, CSVScannerImplementation::scalar);
+        for (CSVScannerImplementation implementation : implementations)
+        {
+            std::vector<std::uint32_t> delimiters;
+            CSVScanner::findDelimiters(csvLine.data(), csvLine.size(), ',', '\n', delimiters, implementation);
+            equivalent = equivalent && scannerTokenize(csvLine, ',', implementation) == expected && delimiters == expectedDelimiters;
+        }
+        if (!equivalent)
+        {
+            state.SkipWithError("CSV scanner disagrees with the reference tokenizer");
+            break;
+        }
+        ++linesChecked;
+    }
+    state.counters["lines"] = static_cast<double>(linesChecked);
+    state.counters["implementations"] = static_cast<double>(implementations.size());
+}
+BENCHMARK(BM_CSVScanner_equivalence)->Iterations(20000);
+
+static void BM_CSVScanner_findDelimiters(benchmark::State& state)
+{
+    CSVScannerImplementation implementation = static_cast<CSVScannerImplementation>(state.range(0));
+    if (!CSVScanner::isSupported(implementation))
+    {
+        state.SkipWithError("Implementation not supported by this processor");
+        return;
+    }
+    state.SetLabel(CSVScanner::implementationToString(implementation));
+
+    // Scan the first chunk of the benchmark book, as the reader does
+    BenchmarkBook& book = getBenchmarkBook();
+    std::ifstream csvFile{ book.csvFilename, std::ios::binary };
+    std::string chunk(CSVFileReader::readChunkBytes, '\0');
+    csvFile.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+    chunk.resize(static_cast<std::size_t>(csvFile.gcount()));
+
+    std::vector<std::uint32_t> delimiters;
+    for (auto _ : state)
+    {
+        delimiters.clear();
+        CSVScanner::findDelimiters(chunk.data(), chunk.size(), ',', '\n', delimiters, implementation);
+        benchmark::DoNotOptimize(delimiters.data());
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * chunk.size()));
+}
+BENCHMARK(BM_CSVScanner_findDelimiters)->Arg(0)->Arg(1)->Arg(2)->Unit(benchmark::kMicrosecond);
+
+static void BM_BookSorter_sortEntries(benchmark::State& state)
+{
+    BenchmarkBook& book = getBenchmarkBook();
+    std::vector<StocksDataBookEntry> input = book.advisorBot->book().getEntries();
+
+    // 0: already sorted, 1: two concatenated sorted halves, 2: shuffled
+    if (state.range(0) == 1)
+    {
+        std::rotate(input.begin(), input.begin() + input.size() / 2, input.end());
+    }
+    else if (state.range(0) == 2)
+    {
+        std::mt19937_64 generator{ 42 };
+        std::shuffle(input.begin(), input.end(), generator);
+    }
+
+    LoadReport loadReport;
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        std::vector<StocksDataBookEntry> entries = input;
+        state.ResumeTiming();
+        BookSorter::sortEntries(entries, loadReport);
+        benchmark::DoNotOptimize(entries.data());
+    }
+    state.counters["runs"] = static_cast<double>(loadReport.sortedRuns);
+    state.SetItemsProcessed(state.iterations() * input.size());
+}
+BENCHMARK(BM_BookSorter_sortEntries)->Arg(0)->Arg(1)->Arg(2)->Unit(benchmark::kMillisecond);
+
+// Book archive
+
+namespace
+{
+    /** Archive the benchmark book on first use */
+    const std::string& getBenchmarkArchive()
+    {
+        static const std::string archiveFilename = []()
+        {
+            std::string filename = (std::filesystem::temp_directory_path() / "advisorbot_bench").string() + BookArchive::extension;
+            BookArchive::write(filename, getBenchmarkBook().advisorBot->book().getEntries());
+            return filename;
+        }();
+        return archiveFilename;
+    }
+}
+
+static void BM_BookArchive_write(benchmark::State& state)
+{
+    BenchmarkBook& book = getBenchmarkBook();
+    const std::vector<StocksDataBookEntry>& entries = book.advisorBot->book().getEntries();
+    std::string filename = (std::filesystem::temp_directory_path() / "advisorbot_bench_write").string() + BookArchive::extension;
+    for (auto _ : state)
+    {
+        BookArchive::write(filename, entries);
+    }
+    state.counters["csvBytes"] = static_cast<double>(std::filesystem::file_size(book.csvFilename));
+    state.counters["archiveBytes"] = static_cast<double>(std::filesystem::file_size(filename));
+    state.SetItemsProcessed(state.iterations() * entries.size());
+}
+BENCHMARK(BM_BookArchive_write)->Unit(benchmark::kMillisecond);
+
+static void BM_BookArchive_readAll(benchmark::State& state)
+{
+    const std::string& filename = getBenchmarkArchive();
+    std::size_t rows = 0;
+    for (auto _ : state)
+    {
+        BookArchive bookArchive{ filename };
+        std::vector<StocksDataBookEntry> entries = bookArchive.readAll();
+        rows = entries.size();
+        benchmark::DoNotOptimize(entries.data());
+    }
+    state.SetItemsProcessed(state.iterations() * rows);
+}
+BENCHMARK(BM_BookArchive_readAll)->Unit(benchmark::kMillisecond);
+
+static void BM_BookArchive_query(benchmark::State& state)
+{
+    BenchmarkBook& book = getBenchmarkBook();
+    const std::string& filename = getBenchmarkArchive();
+
+    // One product over a tenth of the day starting at the simulation time
+    const std::vector<std::int64_t>& times = book.advisorBot->book().getTimeStampIndex().getTimes();
+    std::size_t first = times.size() / 2;
+    std::int64_t fromTime = times[first];
+    std::int64_t toTime = times[std::min(times.size() - 1, first + times.size() / 10)];
+
+    BookArchive bookArchive{ filename };
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(bookArchive.query(book.product, fromTime, toTime));
+    }
+    state.counters["blocksDecodedPerQuery"] = static_cast<double>(bookArchive.getBlocksDecoded()) / state.iterations();
+    state.counters["blocks"] = static_cast<double>(bookArchive.getBlocks().size());
+}
+BENCHMARK(BM_BookArchive_query)->Unit(benchmark::kMicrosecond);
+
+// StocksDataBook queries
+
+static void BM_StocksDataBook_filterSDBEentries(benchmark::State& state)
+{
+    BenchmarkBook& book = getBenchmarkBook();
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(book.advisorBot->book().filterSDBEentries(StocksDataBookType::ask, book.product, book.advisorBot->currentTime));
+    }
+}
+BENCHMARK(BM_StocksDataBook_filterSDBEentries)->Unit(benchmark::kMicrosecond);
+
+static void BM_StocksDataBook_filterSDBEentries_range(benchmark::State& state)
+{
+    BenchmarkBook& book = getBenchmarkBook();
+
+    // One product over a tenth of the day starting at the simulation time
+    const std::vector<std::int64_t>& times = book.advisorBot->book().getTimeStampIndex().getTimes();
+    std::size_t first = times.size() / 2;
+    std::int64_t fromTime = times[first];
+    std::int64_t toTime = times[std::min(times.size() - 1, first + times.size() / 10)];
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(book.advisorBot->book().filterSDBEentries(StocksDataBookType::ask, book.product, fromTime, toTime,
+            -std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity()));
+    }
+}
+BENCHMARK(BM_StocksDataBook_filterSDBEentries_range)->Unit(benchmark::kMicrosecond);
+
+static void BM_StocksDataBook_aggregateSDBEentries(benchmark::State& state)
+{
+    BenchmarkBook& book = getBenchmarkBook();
+    const std::vector<std::int64_t>& times = book.advisorBot->book().getTimeStampIndex().getTimes();
+    std::size_t first = times.size() / 2;
+    std::int64_t fromTime = times[first];
+    std::int64_t toTime = times[std::min(times.size() - 1, first + times.size() / 10)];
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(book.advisorBot->book().aggregateSDBEentries(StocksDataBookType::ask, book.product, fromTime, toTime));
+    }
+}
+BENCHMARK(BM_StocksDataBook_aggregateSDBEentries)->Unit(benchmark::kMicrosecond);
+
+static void BM_ProductShard_equivalence(benchmark::State& state)
+{
+    // Compare the shard-backed filters with a scan of the whole collection, over random time windows of every product
+    BenchmarkBook& book = getBenchmarkBook();
+    const StocksDataBook& stocksDataBook = book.advisorBot->book();
+    const std::vector<StocksDataBookEntry>& entries = stocksDataBook.getEntries();
+    const std::vector<std::int64_t>& times = stocksDataBook.getTimeStampIndex().getTimes();
+    state.SetLabel(std::to_string(stocksDataBook.getShards().size()) + " shards on " + std::to_string(NumaTopology::getNodes().size()) + " node(s)");
+
+    std::mt19937_64 random{ 42 };
+    for (auto _ : state)
+    {
+        const ProductShard& shard = stocksDataBook.getShards()[random() % stocksDataBook.getShards().size()];
+        StocksDataBookType type = random() % 2 == 0 ? StocksDataBookType::bid : StocksDataBookType::ask;
+        std::size_t first = random() % times.size();
+        std::int64_t fromTime = times[first];
+        std::int64_t toTime = times[std::min(times.size() - 1, first + random() % 20)];
+
+        std::vector<StocksDataBookEntry> filtered = stocksDataBook.filterSDBEentries(type, shard.getProduct(), fromTime, toTime,
+            -std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity());
+        std::size_t matched = 0;
+        bool equivalent = true;
+        for (const StocksDataBookEntry& entry : entries)
+        {
+            if (entry.SDBEtype == type && entry.product == shard.getProduct() && entry.timestamp >= fromTime && entry.timestamp <= toTime)
+            {
+                equivalent = equivalent && matched < filtered.size() && filtered[matched].timestamp == entry.timestamp
+                    && filtered[matched].price == entry.price && filtered[matched].amount == entry.amount;
+                ++matched;
+            }
+        }
+        if (!equivalent || matched != filtered.size()
+            || stocksDataBook.aggregateSDBEentries(type, shard.getProduct(), fromTime, toTime).entries != matched)
+        {
+            state.SkipWithError("Shard-backed filter differs from a scan of the collection");
+            break;
+        }
+    }
+}
+BENCHMARK(BM_ProductShard_equivalence)->Iterations(200)->Unit(benchmark::kMicrosecond);
+
+static void BM_StocksDataBook_getMinMaxPrice(benchmark::State& state)
+{
+    BenchmarkBook& book = getBenchmarkBook();
+    std::vector<StocksDataBookEntry> entries = book.advisorBot->book().filterSDBEentries(StocksDataBookType::ask, book.product, book.advisorBot->currentTime);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(book.advisorBot->book().getMinMaxPrice(entries));
+    }
+    state.counters["entries"] = static_cast<double>(entries.size());
+}
+BENCHMARK(BM_StocksDataBook_getMinMaxPrice);
+
+static void BM_StocksDataBook_getUniqueProducts(benchmark::State& state)
+{
+    BenchmarkBook& book = getBenchmarkBook();
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(book.advisorBot->book().getUniqueProducts());
+    }
+}
+BENCHMARK(BM_StocksDataBook_getUniqueProducts);
+
+static void BM_StocksDataBook_getNextTimeStamp(benchmark::State& state)
+{
+    BenchmarkBook& book = getBenchmarkBook();
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(book.advisorBot->book().getNextTimeStamp(book.advisorBot->currentTime));
+    }
+}
+BENCHMARK(BM_StocksDataBook_getNextTimeStamp);
+
+static void BM_StocksDataBook_getPreviousTimeStamp(benchmark::State& state)
+{
+    BenchmarkBook& book = getBenchmarkBook();
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(book.advisorBot->book().getPreviousTimeStamp(book.advisorBot->currentTime));
+    }
+}
+BENCHMARK(BM_StocksDataBook_getPreviousTimeStamp);
+
+// Timestamp parsing
+
+static void BM_TimeStamp_parse_fixedWidth(benchmark::State& state)
+{
+    // Layout of the exchange dumps, decoded at fixed offsets
+    std::string timestamp = "2020/06/01 11:57:30.328127";
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(timestamp.data());
+        benchmark::DoNotOptimize(TimeStamp::parse(timestamp));
+    }
+}
+BENCHMARK(BM_TimeStamp_parse_fixedWidth);
+
+static void BM_TimeStamp_parse_variableWidth(benchmark::State& state)
+{
+    // Fields that are not zero-padded take the slower general path
+    std::string timestamp = "2020/6/1 9:57:30.328127";
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(timestamp.data());
+        benchmark::DoNotOptimize(TimeStamp::parse(timestamp));
+    }
+}
+BENCHMARK(BM_TimeStamp_parse_variableWidth);
+
+static void BM_TimeStamp_format(benchmark::State& state)
+{
+    std::int64_t microseconds = TimeStamp::parse("2020/06/01 11:57:30.328127");
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(TimeStamp::format(microseconds));
+    }
+}
+BENCHMARK(BM_TimeStamp_format);
+
+// Timestamp index
+
+static void BM_TimeStampIndex_seek(benchmark::State& state)
+{
+    // Seek to spread-out times, each a binary search over the distinct timestamps only
+    BenchmarkBook& book = getBenchmarkBook();
+    const TimeStampIndex& timeStampIndex = book.advisorBot->book().getTimeStampIndex();
+    std::int64_t first = timeStampIndex.getTimes().front();
+    std::int64_t span = timeStampIndex.getTimes().back() - first + 1;
+    std::int64_t offset = 0;
+    for (auto _ : state)
+    {
+        offset = (offset + span / 7 + 1) % span;
+        benchmark::DoNotOptimize(timeStampIndex.seek(first + offset));
+    }
+}
+BENCHMARK(BM_TimeStampIndex_seek);
+
+static void BM_TimeStampIndex_findRange(benchmark::State& state)
+{
+    BenchmarkBook& book = getBenchmarkBook();
+    const TimeStampIndex& timeStampIndex = book.advisorBot->book().getTimeStampIndex();
+    std::int64_t first = timeStampIndex.getTimes().front();
+    std::int64_t last = timeStampIndex.getTimes().back();
+    std::size_t begin, end;
+    for (auto _ : state)
+    {
+        timeStampIndex.findRange(first + (last - first) / 4, last - (last - first) / 4, begin, end);
+        benchmark::DoNotOptimize(end - begin);
+    }
+}
+BENCHMARK(BM_TimeStampIndex_findRange);
+
+// UserCommands
+
+static void BM_Command1_HELP(benchmark::State& state)
+{
+    SilenceStandardOutput silence;
+    for (auto _ : state)
+    {
+        UserCommands::Command1_HELP();
+    }
+}
+BENCHMARK(BM_Command1_HELP);
+
+static void BM_Command2_HELP_cmd(benchmark::State& state)
+{
+    SilenceStandardOutput silence;
+    for (auto _ : state)
+    {
+        UserCommands::Command2_HELP_prod();
+        UserCommands::Command2_HELP_min();
+        UserCommands::Command2_HELP_max();
+        UserCommands::Command2_HELP_avg();
+        UserCommands::Command2_HELP_predict();
+        UserCommands::Command2_HELP_time();
+        UserCommands::Command2_HELP_step();
+        UserCommands::Command2_HELP_median();
+        UserCommands::Command2_HELP_report();
+        UserCommands::Command2_HELP_depth();
+        UserCommands::Command2_HELP_impact();
+        UserCommands::Command2_HELP_vwap();
+        UserCommands::Command2_HELP_vwmedian();
+        UserCommands::Command2_HELP_volume();
+        UserCommands::Command2_HELP_spread();
+        UserCommands::Command2_HELP_candles();
+        UserCommands::Command2_HELP_vol();
+        UserCommands::Command2_HELP_zscore();
+        UserCommands::Command2_HELP_corr();
+        UserCommands::Command2_HELP_backtest();
+        UserCommands::Command2_HELP_sweep();
+        UserCommands::Command2_HELP_wallet();
+        UserCommands::Command2_HELP_buy();
+        UserCommands::Command2_HELP_sell();
+        UserCommands::Command2_HELP_goto();
+        UserCommands::Command2_HELP_back();
+        UserCommands::Command2_HELP_forward();
+    }
+}
+BENCHMARK(BM_Command2_HELP_cmd);
+
+static void BM_Command3_PROD(benchmark::State& state)
+{
+    BenchmarkBook& book = getBenchmarkBook();
+    SilenceStandardOutput silence;
+    for (auto _ : state)
+    {
+        UserCommands::Command3_PROD(book.advisorBot.get());
+    }
+}
+BENCHMARK(BM_Command3_PROD);
+
+static void BM_Command4_MIN(benchmark::State& state)
+{
+    BenchmarkBook& book = getBenchmarkBook();
+    SilenceStandardOutput silence;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(UserCommands::Command4_MIN("ask", book.product, book.advisorBot->currentTime, book.advisorBot.get()));
+    }
+}
+BENCHMARK(BM_Command4_MIN)->Unit(benchmark::kMicrosecond);
+
+static void BM_Command5_MAX(benchmark::State& state)
+{
+    BenchmarkBook& book = getBenchmarkBook();
+    SilenceStandardOutput silence;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(UserCommands::Command5_MAX("bid", book.product, book.advisorBot->currentTime, book.advisorBot.get()));
+    }
+}
+BENCHMARK(BM_Command5_MAX)->Unit(benchmark::kMicrosecond);
+
+static void BM_Command4_5_MINMAX_allocations(benchmark::State& state)
+{
+    BenchmarkBook& book = getBenchmarkBook();
+    SilenceStandardOutput silence;
+
+    // Only steady-state queries must stay off the heap, so the first ones may still fill caches
+    UserCommands::Command4_MIN("ask", book.product, book.advisorBot->currentTime, book.advisorBot.get());
+    UserCommands::Command5_MAX("bid", book.product, book.advisorBot->currentTime, book.advisorBot.get());
+
+    std::size_t allocations = 0;
+    for (auto _ : state)
+    {
+        std::size_t allocationsBefore = AllocationCounter::getAllocationCount();
+        benchmark::DoNotOptimize(UserCommands::Command4_MIN("ask", book.product, book.advisorBot->currentTime, book.advisorBot.get()));
+        benchmark::DoNotOptimize(UserCommands::Command5_MAX("bid", book.product, book.advisorBot->currentTime, book.advisorBot.get()));
+        allocations += AllocationCounter::getAllocationCount() - allocationsBefore;
+    }
+    state.counters["allocations"] = static_cast<double>(allocations);
+    if (allocations != 0)
+    {
+        state.SkipWithError("Steady-state min and max queries allocated on the heap");
+    }
+}
+BENCHMARK(BM_Command4_5_MINMAX_allocations)->Unit(benchmark::kMicrosecond);
+
+static void BM_Command6_AVG(benchmark::State& state)
+{
+    BenchmarkBook& book = getBenchmarkBook();
+    std::string numTimesteps = std::to_string(state.range(0));
+    SilenceStandardOutput silence;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(UserCommands::Command6_AVG("ask", book.product, book.advisorBot->currentTime, numTimesteps, book.advisorBot.get()));
+    }
+}
+BENCHMARK(BM_Command6_AVG)->Arg(1)->Arg(10)->Arg(100)->Unit(benchmark::kMicrosecond);
+
+static void BM_Command6_AVG_fixedPoint(benchmark::State& state)
+{
+    BenchmarkBook& book = getBenchmarkBook();
+    AdvisorBot& fixedPointBot = getFixedPointAdvisorBot();
+    std::string numTimesteps = std::to_string(state.range(0));
+    SilenceStandardOutput silence;
+
+    // Summing exactly in ticks may only differ from summing doubles by the rounding of the latter
+    double expected = UserCommands::Command6_AVG("ask", book.product, book.advisorBot->currentTime, numTimesteps, book.advisorBot.get());
+    double average = UserCommands::Command6_AVG("ask", book.product, fixedPointBot.currentTime, numTimesteps, &fixedPointBot);
+    if (!fixedPointBot.book().findShard(book.product)->hasFixedPoint() || std::abs(average - expected) > 1e-12 * std::abs(expected))
+    {
+        state.SkipWithError("Fixed-point average disagrees with the floating-point average");
+        return;
+    }
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(UserCommands::Command6_AVG("ask", book.product, fixedPointBot.currentTime, numTimesteps, &fixedPointBot));
+    }
+}
+BENCHMARK(BM_Command6_AVG_fixedPoint)->Arg(1)->Arg(10)->Arg(100)->Unit(benchmark::kMicrosecond);
+
+static void BM_Command7_PREDICT(benchmark::State& state)
+{
+    BenchmarkBook& book = getBenchmarkBook();
+    SilenceStandardOutput silence;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(UserCommands::Command7_PREDICT(book.product, state.range(0) ? "max" : "min", book.advisorBot->currentTime, "ask", book.advisorBot.get()));
+    }
+}
+BENCHMARK(BM_Command7_PREDICT)->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
+
+static void BM_Command7_PREDICT_candles(benchmark::State& state)
+{
+    BenchmarkBook& book = getBenchmarkBook();
+    SilenceStandardOutput silence;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(UserCommands::Command7_PREDICT_candles("max", book.product, "ask", "5t", book.advisorBot->currentTime, book.advisorBot.get()));
+    }
+}
+BENCHMARK(BM_Command7_PREDICT_candles)->Unit(benchmark::kMicrosecond);
+
+static void BM_Command8_TIME(benchmark::State& state)
+{
+    BenchmarkBook& book = getBenchmarkBook();
+    SilenceStandardOutput silence;
+    for (auto _ : state)
+    {
+        UserCommands::Command8_TIME(book.advisorBot.get());
+    }
+}
+BENCHMARK(BM_Command8_TIME);
+
+static void BM_Command9_STEP(benchmark::State& state)
+{
+    BenchmarkBook& book = getBenchmarkBook();
+    std::string startTime = book.advisorBot->currentTime;
+    SilenceStandardOutput silence;
+    for (auto _ : state)
+    {
+        UserCommands::Command9_STEP(book.advisorBot.get());
+    }
+
+    // Leave the shared simulation where the other benchmarks expect it
+    book.advisorBot->currentTime = startTime;
+}
+BENCHMARK(BM_Command9_STEP);
+
+static void BM_Command10_MEDIAN(benchmark::State& state)
+{
+    BenchmarkBook& book = getBenchmarkBook();
+    std::string numTimesteps = std::to_string(state.range(0));
+    SilenceStandardOutput silence;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(UserCommands::Command10_MEDIAN("bid", book.product, book.advisorBot->currentTime, numTimesteps, book.advisorBot.get()));
+    }
+}
+BENCHMARK(BM_Command10_MEDIAN)->Arg(1)->Arg(10)->Arg(100)->Unit(benchmark::kMicrosecond);
+
+static void BM_Command10_MEDIAN_fixedPoint(benchmark::State& state)
+{
+    BenchmarkBook& book = getBenchmarkBook();
+    AdvisorBot& fixedPointBot = getFixedPointAdvisorBot();
+    std::string numTimesteps = std::to_string(state.range(0));
+    SilenceStandardOutput silence;
+
+    // The middle prices are the same in both modes, so only the halving of an even count may round differently
+    double expected = UserCommands::Command10_MEDIAN("bid", book.product, book.advisorBot->currentTime, numTimesteps, book.advisorBot.get());
+    double median = UserCommands::Command10_MEDIAN("bid", book.product, fixedPointBot.currentTime, numTimesteps, &fixedPointBot);
+    if (std::abs(median - expected) > 1e-15 * std::abs(expected))
+    {
+        state.SkipWithError("Fixed-point median disagrees with the floating-point median");
+        return;
+    }
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(UserCommands::Command10_MEDIAN("bid", book.product, fixedPointBot.currentTime, numTimesteps, &fixedPointBot));
+    }
+}
+BENCHMARK(BM_Command10_MEDIAN_fixedPoint)->Arg(1)->Arg(10)->Arg(100)->Unit(benchmark::kMicrosecond);
+
+static void BM_Command11_REPORT(benchmark::State& state)
+{
+    BenchmarkBook& book = getBenchmarkBook();
+    SilenceStandardOutput silence;
+    for (auto _ : state)
+    {
+        UserCommands::Command11_REPORT(book.advisorBot.get());
+    }
+}
+BENCHMARK(BM_Command11_REPORT);
+
+static void BM_Command12_DEPTH(benchmark::State& state)
+{
+    BenchmarkBook& book = getBenchmarkBook();
+    SilenceStandardOutput silence;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(UserCommands::Command12_DEPTH(book.product, "10", book.advisorBot->currentTime, book.advisorBot.get()));
+    }
+}
+BENCHMARK(BM_Command12_DEPTH)->Unit(benchmark::kMicrosecond);
+
+static void BM_Command13_IMPACT(benchmark::State& state)
+{
+    BenchmarkBook& book = getBenchmarkBook();
+    SilenceStandardOutput silence;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(UserCommands::Command13_IMPACT("ask", book.product, book.advisorBot->currentTime, "25", book.advisorBot.get()));
+    }
+}
+BENCHMARK(BM_Command13_IMPACT)->Unit(benchmark::kMicrosecond);
+
+static void BM_Command14_VWAP(benchmark::State& state)
+{
+    BenchmarkBook& book = getBenchmarkBook();
+    std::string numTimesteps = std::to_string(state.range(0));
+    SilenceStandardOutput silence;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(UserCommands::Command14_VWAP("ask", book.product, book.advisorBot->currentTime, numTimesteps, book.advisorBot.get()));
+    }
+}
+BENCHMARK(BM_Command14_VWAP)->Arg(1)->Arg(10)->Arg(100)->Unit(benchmark::kMicrosecond);
+
+static void BM_Command15_VWMEDIAN(benchmark::State& state)
+{
+    BenchmarkBook& book = getBenchmarkBook();
+    std::string numTimesteps = std::to_string(state.range(0));
+    SilenceStandardOutput silence;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(UserCommands::Command15_VWMEDIAN("bid", book.product, book.advisorBot->currentTime, numTimesteps, book.advisorBot.get()));
+    }
+}
+BENCHMARK(BM_Command15_VWMEDIAN)->Arg(1)->Arg(10)->Arg(100)->Unit(benchmark::kMicrosecond);
+
+static void BM_Command16_VOLUME(benchmark::State& state)
+{
+    BenchmarkBook& book = getBenchmarkBook();
+    std::string numTimesteps = std::to_string(state.range(0));
+    SilenceStandardOutput silence;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(UserCommands::Command16_VOLUME("ask", book.product, book.advisorBot->currentTime, numTimesteps, book.advisorBot.get()));
+    }
+}
+BENCHMARK(BM_Command16_VOLUME)->Arg(1)->Arg(10)->Arg(100)->Unit(benchmark::kMicrosecond);
+
+static void BM_Command17_SPREAD(benchmark::State& state)
+{
+    BenchmarkBook& book = getBenchmarkBook();
+    std::string numTimesteps = std::to_string(state.range(0));
+    SilenceStandardOutput silence;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(UserCommands::Command17_SPREAD(book.product, numTimesteps, book.advisorBot->currentTime, book.advisorBot.get()));
+    }
+}
+BENCHMARK(BM_Command17_SPREAD)->Arg(1)->Arg(10)->Arg(100)->Unit(benchmark::kMicrosecond);
+
+static void BM_Command18_CANDLES(benchmark::State& state)
+{
+    BenchmarkBook& book = getBenchmarkBook();
+    SilenceStandardOutput silence;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(UserCommands::Command18_CANDLES(book.product, "bid", "1m", "10", book.advisorBot->currentTime, book.advisorBot.get()));
+    }
+}
+BENCHMARK(BM_Command18_CANDLES)->Unit(benchmark::kMicrosecond);
+
+static void BM_Command19_VOL(benchmark::State& state)
+{
+    BenchmarkBook& book = getBenchmarkBook();
+    SilenceStandardOutput silence;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(UserCommands::Command19_VOL("ask", book.product, book.advisorBot->currentTime, "100", book.advisorBot.get()));
+    }
+}
+BENCHMARK(BM_Command19_VOL)->Unit(benchmark::kMicrosecond);
+
+static void BM_Command20_ZSCORE(benchmark::State& state)
+{
+    BenchmarkBook& book = getBenchmarkBook();
+    SilenceStandardOutput silence;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(UserCommands::Command20_ZSCORE("bid", book.product, book.advisorBot->currentTime, "100", book.advisorBot.get()));
+    }
+}
+BENCHMARK(BM_Command20_ZSCORE)->Unit(benchmark::kMicrosecond);
+
+static void BM_Command21_CORR(benchmark::State& state)
+{
+    BenchmarkBook& book = getBenchmarkBook();
+    SilenceStandardOutput silence;
+    std::string numTimesteps = std::to_string(state.range(0));
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(UserCommands::Command21_CORR(numTimesteps, book.advisorBot->currentTime, book.advisorBot.get()));
+    }
+}
+BENCHMARK(BM_Command21_CORR)->Arg(10)->Arg(100)->Unit(benchmark::kMicrosecond);
+
+static void BM_Command22_BACKTEST(benchmark::State& state)
+{
+    BenchmarkBook& book = getBenchmarkBook();
+    SilenceStandardOutput silence;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(UserCommands::Command22_BACKTEST(book.product, "10", "0.0001", book.advisorBot.get()));
+    }
+}
+BENCHMARK(BM_Command22_BACKTEST)->Unit(benchmark::kMicrosecond);
+
+static void BM_Command25_BUY(benchmark::State& state)
+{
+    // Each buy takes a small slice of the asks, so the liquidity is reset whenever an order comes back unfilled
+    BenchmarkBook& book = getBenchmarkBook();
+    SilenceStandardOutput silence;
+    std::string baseCurrency, quoteCurrency;
+    Wallet::splitProduct(book.product, baseCurrency, quoteCurrency);
+    for (auto _ : state)
+    {
+        book.advisorBot->wallet.insertCurrency(quoteCurrency, 1e12);
+        if (UserCommands::Command25_BUY(book.product, "0.01", "1e12", book.advisorBot->currentTime, book.advisorBot.get()) == 0)
+        {
+            book.advisorBot->orderMatcher.clearConsumedLiquidity();
+        }
+    }
+}
+BENCHMARK(BM_Command25_BUY)->Unit(benchmark::kMicrosecond);
+
+static void BM_Command27_GOTO(benchmark::State& state)
+{
+    // Jump between two times of day, restoring the simulation time afterwards
+    BenchmarkBook& book = getBenchmarkBook();
+    SilenceStandardOutput silence;
+    std::string startTime = book.advisorBot->currentTime;
+    const TimeStampIndex& timeStampIndex = book.advisorBot->book().getTimeStampIndex();
+    std::string targets[2] = { TimeStamp::format(timeStampIndex.getTimes()[timeStampIndex.size() / 4]).substr(11),
+                               TimeStamp::format(timeStampIndex.getTimes()[timeStampIndex.size() * 3 / 4]).substr(11) };
+    std::size_t target = 0;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(UserCommands::Command27_GOTO(targets[target ^= 1], book.advisorBot->currentTime, book.advisorBot.get()));
+    }
+    book.advisorBot->currentTime = startTime;
+}
+BENCHMARK(BM_Command27_GOTO)->Unit(benchmark::kMicrosecond);
+
+// Order matcher
+
+static void BM_OrderMatcher_matchOrder(benchmark::State& state)
+{
+    // Sweep a whole side in orders of increasing size, measuring the cost per level touched
+    BenchmarkBook& book = getBenchmarkBook();
+    OrderMatcher orderMatcher{ book.advisorBot->engines().depthEngine };
+    const std::string& timestamp = book.advisorBot->currentTime;
+    double amount = static_cast<double>(state.range(0));
+    std::size_t levelsTouched = 0;
+    for (auto _ : state)
+    {
+        OrderFill orderFill = orderMatcher.matchOrder(book.product, timestamp, StocksDataBookType::bid, amount, 1e300);
+        levelsTouched += orderFill.levelFills.size();
+        if (orderFill.filledAmount < amount)
+        {
+            orderMatcher.clearConsumedLiquidity();
+        }
+    }
+    state.counters["levels_per_order"] = benchmark::Counter(static_cast<double>(levelsTouched) / state.iterations());
+}
+BENCHMARK(BM_OrderMatcher_matchOrder)->Arg(1)->Arg(100)->Arg(10000)->Unit(benchmark::kMicrosecond);
+
+// Backtester
+
+static void BM_Backtester_replay(benchmark::State& state)
+{
+    // A single replay over pre-built ticks, the unit of work of a parameter sweep
+    BenchmarkBook& book = getBenchmarkBook();
+    const std::vector<MarketTick>& ticks = book.advisorBot->engines().backtester.getMarketTicks(book.product);
+    EWMAStrategy strategy{ 10, 0.0001 };
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(Backtester::replay(ticks, strategy, 1.0));
+    }
+    state.SetItemsProcessed(state.iterations() * ticks.size());
+}
+BENCHMARK(BM_Backtester_replay)->Unit(benchmark::kMicrosecond);
+
+static void BM_ParameterSweep_sweepPredictionSpans(benchmark::State& state)
+{
+    BenchmarkBook& book = getBenchmarkBook();
+    std::vector<std::string> products = book.advisorBot->book().getUniqueProducts();
+    std::vector<std::size_t> spans = ParameterSweep::getDefaultSpans();
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(ParameterSweep::sweepPredictionSpans(book.advisorBot->book(), products, StocksDataBookType::ask, true, spans));
+    }
+    state.SetItemsProcessed(state.iterations() * products.size() * spans.size());
+}
+BENCHMARK(BM_ParameterSweep_sweepPredictionSpans)->Unit(benchmark::kMicrosecond);
+
+static void BM_ParameterSweep_sweepStrategies(benchmark::State& state)
+{
+    BenchmarkBook& book = getBenchmarkBook();
+    std::vector<std::string> products = book.advisorBot->book().getUniqueProducts();
+    std::vector<std::size_t> spans = ParameterSweep::getDefaultSpans();
+    std::vector<double> thresholds = ParameterSweep::getDefaultThresholds();
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(ParameterSweep::sweepStrategies(book.advisorBot->engines().backtester, products, spans, thresholds));
+    }
+    state.SetItemsProcessed(state.iterations() * products.size() * spans.size() * thresholds.size());
+}
+BENCHMARK(BM_ParameterSweep_sweepStrategies)->Unit(benchmark::kMillisecond);
+
+// Correlation kernel
+
+static void BM_CorrelationMatrix_compute(benchmark::State& state)
+{
+    // Synthetic random walks, so that the kernel can be measured beyond the few products of a real dataset
+    std::size_t numSeries = static_cast<std::size_t>(state.range(0));
+    std::size_t length = static_cast<std::size_t>(state.range(1));
+    std::vector<std::vector<double>> series(numSeries, std::vector<double>(length));
+    std::uint64_t seed = 0x9E3779B97F4A7C15ULL;
+    for (std::vector<double>& values : series)
+    {
+        double value = 100;
+        for (double& element : values)
+        {
+            seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+            value += static_cast<double>(seed >> 11) / 9007199254740992.0 - 0.5;
+            element = value;
+        }
+    }
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(CorrelationMatrix::compute(series));
+    }
+    state.SetItemsProcessed(state.iterations() * numSeries * numSeries * length / 2);
+}
+BENCHMARK(BM_CorrelationMatrix_compute)->Args({ 4, 1000 })->Args({ 32, 10000 })->Args({ 128, 10000 })->Unit(benchmark::kMillisecond);
+
+// Volatility engine
+
+static void BM_RollingStatistics_push(benchmark::State& state)
+{
+    // Once the window is full every push evicts a value, so the cost per push must not depend on the window size
+    std::size_t windowSize = static_cast<std::size_t>(state.range(0));
+    RollingStatistics rollingStatistics{ windowSize };
+    for (std::size_t i = 0; i < windowSize; ++i)
+    {
+        rollingStatistics.push(static_cast<double>(i % 97));
+    }
+
+    double value = 0;
+    for (auto _ : state)
+    {
+        rollingStatistics.push(value);
+        value = value < 100 ? value + 1.25 : 0;
+        benchmark::DoNotOptimize(rollingStatistics.getVariance());
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_RollingStatistics_push)->RangeMultiplier(10)->Range(10, 100000)->Complexity(benchmark::o1);
+
+static void BM_VolatilityEngine_step(benchmark::State& state)
+{
+    // Alternate between two consecutive time steps so that every query slides the window by one position
+    BenchmarkBook& book = getBenchmarkBook();
+    std::size_t windowSize = static_cast<std::size_t>(state.range(0));
+    VolatilityEngine volatilityEngine{ book.advisorBot->book(), book.advisorBot->engines().candleEngine };
+    const std::vector<TimeStepRange>& timeSteps = book.advisorBot->book().getTimeSteps();
+
+    std::size_t timeStepIndex = timeSteps.size() / 2;
+    volatilityEngine.getSnapshot(book.product, StocksDataBookType::ask, windowSize, timeSteps[timeStepIndex].timestamp);
+    for (auto _ : state)
+    {
+        timeStepIndex = timeStepIndex + 1 < timeSteps.size() ? timeStepIndex + 1 : timeSteps.size() / 2;
+        benchmark::DoNotOptimize(volatilityEngine.getSnapshot(book.product, StocksDataBookType::ask, windowSize, timeSteps[timeStepIndex].timestamp));
+    }
+}
+BENCHMARK(BM_VolatilityEngine_step)->Arg(10)->Arg(100)->Arg(1000);
+
+// Candle engine
+
+static void BM_CandleEngine_rollUp_cold(benchmark::State& state)
+{
+    BenchmarkBook& book = getBenchmarkBook();
+    CandleEngine candleEngine{ book.advisorBot->book() };
+    CandleResolution resolution;
+    CandleEngine::parseResolution("1h", resolution);
+    for (auto _ : state)
+    {
+        candleEngine.clearCache();
+        benchmark::DoNotOptimize(candleEngine.getCandles(book.product, StocksDataBookType::ask, resolution));
+    }
+}
+BENCHMARK(BM_CandleEngine_rollUp_cold)->Unit(benchmark::kMicrosecond);
+
+// Depth engine
+
+static void BM_DepthEngine_getLadders_cold(benchmark::State& state)
+{
+    BenchmarkBook& book = getBenchmarkBook();
+    DepthEngine depthEngine{ book.advisorBot->book() };
+    for (auto _ : state)
+    {
+        depthEngine.clearCache();
+        benchmark::DoNotOptimize(depthEngine.getLadders(book.product, book.advisorBot->currentTime));
+    }
+}
+BENCHMARK(BM_DepthEngine_getLadders_cold)->Unit(benchmark::kMicrosecond);
+
+static void BM_DepthEngine_getLadders_cached(benchmark::State& state)
+{
+    BenchmarkBook& book = getBenchmarkBook();
+    DepthEngine depthEngine{ book.advisorBot->book() };
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(depthEngine.getLadders(book.product, book.advisorBot->currentTime));
+    }
+}
+BENCHMARK(BM_DepthEngine_getLadders_cached);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,254 @@
+#include "SyntheticOrderBookGenerator.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+
+namespace
+{
+    /** Structure is used to describe a product emitted by the generator */
+    struct SyntheticProduct
+    {
+        const char* name;
+        double basePrice;
+    };
+
+    // Products modelled on the exchange dumps, extended with synthetic pairs when more are requested
+    const SyntheticProduct knownProducts[] = {
+        { "BTC/USDT", 9500.0 },
+        { "DOGE/BTC", 0.0000003 },
+        { "DOGE/USDT", 0.0026 },
+        { "ETH/BTC", 0.025 },
+        { "ETH/USDT", 240.0 },
+    };
+
+    /** Convert a civil date into the number of days since 1970/01/01 */
+    std::int64_t daysFromCivil(std::int64_t year, unsigned month, unsigned day)
+    {
+        year -= month <= 2;
+        const std::int64_t era = (year >= 0 ? year : year - 399) / 400;
+        const unsigned yearOfEra = static_cast<unsigned>(year - era * 400);
+        const unsigned dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+        const unsigned dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+        return era * 146097 + static_cast<std::int64_t>(dayOfEra) - 719468;
+    }
+
+    /** Convert a number of days since 1970/01/01 into a civil date */
+    void civilFromDays(std::int64_t days, std::int64_t& year, unsigned& month, unsigned& day)
+    {
+        days += 719468;
+        const std::int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+        const unsigned dayOfEra = static_cast<unsigned>(days - era * 146097);
+        const unsigned yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+        const unsigned dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+        const unsigned monthPrime = (5 * dayOfYear + 2) / 153;
+        day = dayOfYear - (153 * monthPrime + 2) / 5 + 1;
+        month = monthPrime < 10 ? monthPrime + 3 : monthPrime - 9;
+        year = static_cast<std::int64_t>(yearOfEra) + era * 400 + (month <= 2);
+    }
+
+    /** Append a price or amount as a plain decimal of at least ten significant digits
+     *
+     *  The exchange dumps write eight decimals and no exponents; eight decimals alone would round the prices of
+     *  products such as DOGE/BTC to a single significant digit, so smaller values are given more
+     */
+    void appendDecimal(std::string& line, double value)
+    {
+        int magnitude = value > 0 ? static_cast<int>(std::floor(std::log10(value))) : 0;
+        int decimals = std::clamp(9 - magnitude, 8, std::numeric_limits<double>::max_digits10);
+
+        // Room for the integer digits of the largest double, the point and the decimals
+        char text[std::numeric_limits<double>::max_exponent10 + std::numeric_limits<double>::max_digits10 + 4];
+        int length = std::snprintf(text, sizeof(text), "%.*f", decimals, value);
+        line.append(text, static_cast<std::size_t>(std::clamp(length, 0, static_cast<int>(sizeof(text)) - 1)));
+    }
+}
+
+/** Initialize a generator with the configuration provided
+ *
+ *  @param _config Rows, products, timestamps, bid/ask skew and seed of the book
+ *
+ */
+SyntheticOrderBookGenerator::SyntheticOrderBookGenerator(SyntheticOrderBookConfig _config)
+    : config(_config),
+    randomState(_config.seed)
+{
+}
+
+/** Return the product names used by the generator
+ *
+ *  @return container of product names in the order they are emitted within a timestep
+ *
+ */
+std::vector<std::string> SyntheticOrderBookGenerator::getProducts() const
+{
+    std::vector<std::string> products;
+    for (std::size_t i = 0; i < config.products; ++i)
+    {
+        if (i < std::size(knownProducts))
+        {
+            products.emplace_back(knownProducts[i].name);
+        }
+        else
+        {
+            products.emplace_back("SYN" + std::to_string(i) + "/USDT");
+        }
+    }
+
+    // Emit products in lexicographic order, as the exchange dumps do
+    std::sort(products.begin(), products.end());
+    return products;
+}
+
+/** Write the synthetic order book as CSV to the stream provided
+ *
+ *  @param outputStream Stream to which the CSV lines are written
+ *
+ */
+void SyntheticOrderBookGenerator::writeCSV(std::ostream& outputStream)
+{
+    // Restart the random sequence so that every call produces the same book
+    randomState = config.seed;
+
+    std::vector<std::string> products = getProducts();
+
+    // Current mid price of each product, following a random walk across timesteps
+    std::vector<double> midPrices;
+    for (const std::string& product : products)
+    {
+        double basePrice = 100.0;
+        for (const SyntheticProduct& knownProduct : knownProducts)
+        {
+            if (product == knownProduct.name)
+            {
+                basePrice = knownProduct.basePrice;
+            }
+        }
+        midPrices.push_back(basePrice);
+    }
+
+    // Rows of each product within one timestep, split between asks and bids according to the skew
+    std::size_t rowsPerProduct = std::max<std::size_t>(2, config.rows / std::max<std::size_t>(1, config.timesteps * products.size()));
+    std::size_t bidsPerProduct = static_cast<std::size_t>(std::lround(rowsPerProduct * std::clamp(config.bidFraction, 0.0, 1.0)));
+    std::size_t asksPerProduct = rowsPerProduct - bidsPerProduct;
+
+    // Buffer for a single formatted line
+    std::string line;
+    line.reserve(160);
+
+    for (std::size_t timestep = 0; timestep < config.timesteps; ++timestep)
+    {
+        std::string timestamp = formatTimeStamp(static_cast<std::int64_t>(timestep) * config.timestepMicroseconds);
+
+        for (std::size_t productIndex = 0; productIndex < products.size(); ++productIndex)
+        {
+            // Move the mid price by up to 0.2% per timestep
+            double& midPrice = midPrices[productIndex];
+            midPrice *= 1.0 + (nextUniform() - 0.5) * 0.004;
+
+            // Asks lie above the mid price, and bids lie below it
+            for (std::size_t i = 0; i < asksPerProduct; ++i)
+            {
+                double price = midPrice * (1.0 + 0.0005 + nextUniform() * 0.01);
+                double amount = 0.01 + nextUniform() * 10.0;
+                line.assign(timestamp).append(",").append(products[productIndex]).append(",ask,");
+                appendDecimal(line, price);
+                line += ',';
+                appendDecimal(line, amount);
+                line += '\n';
+                outputStream << line;
+            }
+            for (std::size_t i = 0; i < bidsPerProduct; ++i)
+            {
+                double price = midPrice * (1.0 - 0.0005 - nextUniform() * 0.01);
+                double amount = 0.01 + nextUniform() * 10.0;
+                line.assign(timestamp).append(",").append(products[productIndex]).append(",bid,");
+                appendDecimal(line, price);
+                line += ',';
+                appendDecimal(line, amount);
+                line += '\n';
+                outputStream << line;
+            }
+        }
+    }
+}
+
+/** Write the synthetic order book as CSV to the file provided
+ *
+ *  @param csvFilename Name of the CSV file to be written
+ *  @return            true if the file was written, false otherwise
+ *
+ */
+bool SyntheticOrderBookGenerator::writeCSVfile(const std::string& csvFilename)
+{
+    std::ofstream csvFile{ csvFilename };
+    if (!csvFile.is_open())
+    {
+        return false;
+    }
+    writeCSV(csvFile);
+    return static_cast<bool>(csvFile);
+}
+
+/** Return the next value of the deterministic random sequence (SplitMix64)
+ *
+ *  @return 64-bit pseudo-random value
+ *
+ */
+std::uint64_t SyntheticOrderBookGenerator::nextRandom()
+{
+    std::uint64_t value = (randomState += 0x9E3779B97F4A7C15ULL);
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+    return value ^ (value >> 31);
+}
+
+/** Return a uniformly distributed value in [0, 1)
+ *
+ *  The standard library distributions are implementation-defined, so the mapping is done by hand to keep
+ *  generated books identical across platforms
+ *
+ *  @return pseudo-random double in [0, 1)
+ *
+ */
+double SyntheticOrderBookGenerator::nextUniform()
+{
+    return static_cast<double>(nextRandom() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/** Format a timestamp that lies a number of microseconds after the start timestamp
+ *
+ *  @param offsetMicroseconds Offset from the start timestamp
+ *  @return                   timestamp in the "YYYY/MM/DD HH:MM:SS.ffffff" format of the exchange dumps
+ *
+ */
+std::string SyntheticOrderBookGenerator::formatTimeStamp(std::int64_t offsetMicroseconds) const
+{
+    // Decompose the start timestamp
+    int year = 2020, month = 6, day = 1, hour = 0, minute = 0, second = 0;
+    long microsecond = 0;
+    std::sscanf(config.startTimeStamp.c_str(), "%d/%d/%d %d:%d:%d.%ld", &year, &month, &day, &hour, &minute, &second, &microsecond);
+
+    // Absolute microseconds since 1970/01/01
+    const std::int64_t microsecondsPerDay = 86400000000LL;
+    std::int64_t total = daysFromCivil(year, month, day) * microsecondsPerDay
+        + ((hour * 60LL + minute) * 60LL + second) * 1000000LL + microsecond + offsetMicroseconds;
+
+    // Recompose the timestamp
+    std::int64_t days = total / microsecondsPerDay;
+    std::int64_t timeOfDay = total % microsecondsPerDay;
+    std::int64_t civilYear;
+    unsigned civilMonth, civilDay;
+    civilFromDays(days, civilYear, civilMonth, civilDay);
+
+    // Room for every field at its widest, so that the output is never truncated
+    char buffer[5 * 20 + 2 * 10 + 6 + 1];
+    std::snprintf(buffer, sizeof(buffer), "%04lld/%02u/%02u %02lld:%02lld:%02lld.%06lld",
+        static_cast<long long>(civilYear), civilMonth, civilDay,
+        static_cast<long long>(timeOfDay / 3600000000LL),
+        static_cast<long long>(timeOfDay / 60000000LL % 60),
+        static_cast<long long>(timeOfDay / 1000000LL % 60),
+        static_cast<long long>(timeOfDay % 1000000LL));
+    return buffer;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <ostream>
+
+/** Structure is used to configure the synthetic order book produced by the generator */
+struct SyntheticOrderBookConfig
+{
+    // Approximate number of rows to emit across the whole file
+    std::size_t rows = 100000;
+
+    // Number of products and distinct timestamps in the book
+    std::size_t products = 4;
+    std::size_t timesteps = 200;
+
+    // First timestamp of the book and the gap between consecutive timestamps
+    std::string startTimeStamp = "2020/06/01 11:57:30.000000";
+    std::int64_t timestepMicroseconds = 3000000;
+
+    // Fraction of the rows of each timestep that are bids rather than asks
+    double bidFraction = 0.5;
+
+    // Seed of the deterministic random number generator
+    std::uint64_t seed = 20200601;
+};
+
+class SyntheticOrderBookGenerator
+{
+public:
+    /** Initialize a generator with the configuration provided */
+    SyntheticOrderBookGenerator(SyntheticOrderBookConfig _config);
+
+    /** Write the synthetic order book as CSV to the stream provided */
+    void writeCSV(std::ostream& outputStream);
+
+    /** Write the synthetic order book as CSV to the file provided */
+    bool writeCSVfile(const std::string& csvFilename);
+
+    /** Return the product names used by the generator */
+    std::vector<std::string> getProducts() const;
+
+private:
+    /** Return the next value of the deterministic random sequence */
+    std::uint64_t nextRandom();
+
+    /** Return a uniformly distributed value in [0, 1) */
+    double nextUniform();
+
+    /** Format a timestamp that lies a number of microseconds after the start timestamp */
+    std::string formatTimeStamp(std::int64_t offsetMicroseconds) const;
+
+    /** Configuration of the book */
+    SyntheticOrderBookConfig config;
+
+    /** State of the random number generator */
+    std::uint64_t randomState;
+};
@@ -0,0 +1,56 @@
+#include "SyntheticOrderBookGenerator.h"
+#include <iostream>
+#include <string>
+
+/** Print the command line syntax of the generator */
+static void printUsage()
+{
+    std::cout << "Usage: generate_orderbook [--rows=N] [--products=N] [--timesteps=N] [--start=\"YYYY/MM/DD HH:MM:SS.ffffff\"]\n"
+                 "                          [--interval-us=N] [--bid-fraction=F] [--seed=N] [--output=file.csv]" << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    SyntheticOrderBookConfig config;
+    std::string outputFilename = "synthetic.csv";
+
+    // Parse --name=value options
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string argument = argv[i];
+        std::size_t separator = argument.find('=');
+        std::string name = argument.substr(0, separator);
+        std::string value = separator == std::string::npos ? "" : argument.substr(separator + 1);
+
+        try
+        {
+            if (name == "--rows") config.rows = std::stoull(value);
+            else if (name == "--products") config.products = std::stoull(value);
+            else if (name == "--timesteps") config.timesteps = std::stoull(value);
+            else if (name == "--start") config.startTimeStamp = value;
+            else if (name == "--interval-us") config.timestepMicroseconds = std::stoll(value);
+            else if (name == "--bid-fraction") config.bidFraction = std::stod(value);
+            else if (name == "--seed") config.seed = std::stoull(value);
+            else if (name == "--output") outputFilename = value;
+            else
+            {
+                printUsage();
+                return 1;
+            }
+        }
+        catch (const std::exception& e)
+        {
+            std::cout << "Invalid value for " << name << ": " << value << std::endl;
+            return 1;
+        }
+    }
+
+    SyntheticOrderBookGenerator generator{ config };
+    if (!generator.writeCSVfile(outputFilename))
+    {
+        std::cout << "Unable to write " << outputFilename << std::endl;
+        return 1;
+    }
+    std::cout << "Synthetic order book written to " << outputFilename << std::endl;
+    return 0;
+}
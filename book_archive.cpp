@@ -0,0 +1,141 @@
+#include "BookArchive.h"
+#include "CSVFileReader.h"
+#include "LoadReport.h"
+#include "TimeStamp.h"
+#include <charconv>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+/** Print the command line syntax of the converter */
+static void printUsage()
+{
+    std::cout << "Usage: book_archive pack input.csv output" << BookArchive::extension << " [--rows-per-block=N]\n"
+                 "       book_archive unpack input" << BookArchive::extension << " output.csv\n"
+                 "       book_archive info input" << BookArchive::extension << "\n"
+                 "       book_archive query input" << BookArchive::extension << " product \"from timestamp\" \"to timestamp\"" << std::endl;
+}
+
+/** Append a price or amount using the shortest digits that read back to the same double */
+static void appendNumber(std::string& line, double value)
+{
+    char buffer[32];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    line.append(buffer, result.ptr);
+}
+
+/** Format an SDBE as a CSV line in the layout of the exchange dumps */
+static std::string toCSVLine(const StocksDataBookEntry& entry)
+{
+    std::string line = entry.getTimestampString();
+    line += ',';
+    line += entry.product;
+    line += entry.SDBEtype == StocksDataBookType::bid ? ",bid," : entry.SDBEtype == StocksDataBookType::ask ? ",ask," : ",unknown,";
+    appendNumber(line, entry.price);
+    line += ',';
+    appendNumber(line, entry.amount);
+    line += '\n';
+    return line;
+}
+
+int main(int argc, char* argv[])
+{
+    std::string mode = argc > 1 ? argv[1] : "";
+
+    try
+    {
+        if (mode == "pack" && (argc == 4 || argc == 5))
+        {
+            std::size_t rowsPerBlock = BookArchive::defaultRowsPerBlock;
+            if (argc == 5)
+            {
+                std::string argument = argv[4];
+                if (argument.rfind("--rows-per-block=", 0) != 0)
+                {
+                    printUsage();
+                    return 1;
+                }
+                rowsPerBlock = std::stoull(argument.substr(argument.find('=') + 1));
+            }
+
+            LoadReport loadReport;
+            std::vector<StocksDataBookEntry> entries = CSVFileReader::readCSVfile(argv[2], loadReport);
+            BookArchive::write(argv[3], entries, rowsPerBlock);
+
+            std::ifstream csvFile{ argv[2], std::ios::binary | std::ios::ate };
+            std::ifstream archiveFile{ argv[3], std::ios::binary | std::ios::ate };
+            std::cout << "Packed " << entries.size() << " SDBEs (" << loadReport.getRowsRejected() << " rejected) from "
+                      << csvFile.tellg() << " to " << archiveFile.tellg() << " bytes" << std::endl;
+            return 0;
+        }
+
+        if (mode == "unpack" && argc == 4)
+        {
+            BookArchive bookArchive{ argv[2] };
+            std::ofstream csvFile{ argv[3], std::ios::binary | std::ios::trunc };
+            if (!csvFile.is_open())
+            {
+                std::cout << "Unable to write " << argv[3] << std::endl;
+                return 1;
+            }
+
+            // Decode one block at a time, so that the whole book is never held in memory
+            std::size_t rows = 0;
+            for (std::size_t blockIndex = 0; blockIndex < bookArchive.getBlocks().size(); ++blockIndex)
+            {
+                for (const StocksDataBookEntry& entry : bookArchive.readBlock(blockIndex))
+                {
+                    csvFile << toCSVLine(entry);
+                    ++rows;
+                }
+            }
+            std::cout << "Unpacked " << rows << " SDBEs to " << argv[3] << std::endl;
+            return 0;
+        }
+
+        if (mode == "info" && argc == 3)
+        {
+            BookArchive bookArchive{ argv[2] };
+            std::cout << "SDBEs:    " << bookArchive.getRowCount() << std::endl;
+            std::cout << "Blocks:   " << bookArchive.getBlocks().size() << std::endl;
+            std::cout << "Products: " << bookArchive.getProducts().size() << std::endl;
+            for (const std::string& product : bookArchive.getProducts())
+            {
+                std::cout << "  " << product << std::endl;
+            }
+            if (!bookArchive.getBlocks().empty())
+            {
+                std::cout << "From:     " << TimeStamp::format(bookArchive.getBlocks().front().minTime) << std::endl;
+                std::cout << "To:       " << TimeStamp::format(bookArchive.getBlocks().back().maxTime) << std::endl;
+            }
+            return 0;
+        }
+
+        if (mode == "query" && argc == 6)
+        {
+            std::int64_t fromTime = TimeStamp::parse(argv[4]);
+            std::int64_t toTime = TimeStamp::parse(argv[5]);
+            if (fromTime < 0 || toTime < 0)
+            {
+                std::cout << "Invalid timestamp, expected \"YYYY/MM/DD HH:MM:SS\"" << std::endl;
+                return 1;
+            }
+
+            BookArchive bookArchive{ argv[2] };
+            for (const StocksDataBookEntry& entry : bookArchive.query(argv[3], fromTime, toTime))
+            {
+                std::cout << toCSVLine(entry);
+            }
+            std::cout << "Decoded " << bookArchive.getBlocksDecoded() << " of " << bookArchive.getBlocks().size() << " blocks" << std::endl;
+            return 0;
+        }
+    }
+    catch (const std::exception& e)
+    {
+        // The archive and CSV readers have already printed the cause
+        return 1;
+    }
+
+    printUsage();
+    return 1;
+}
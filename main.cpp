@@ -1,11 +1,89 @@
 #include <iostream>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
 #include "AdvisorBot.h"
 
-int main()
+/** Print the command line syntax of Advisor Bot */
+static void printUsage()
 {
-    // Create an instance of Advisor Bot
-    AdvisorBot app{};
+    std::cout << "Usage: AdvisorBot [--strict | --lenient] [--quarantine=rejected.csv] [--foreground] [--fixed-point] [file.csv | file.sdba]...\n"
+                 "       With no files, 20200601.csv is loaded. Several files are merged into one dataset.\n"
+                 "       --strict stops at the first malformed line, --lenient (default) skips malformed lines,\n"
+                 "       and --quarantine writes every rejected line with its line number and reason.\n"
+                 "       The dataset loads in the background while commands are accepted, unless --foreground is given.\n"
+                 "       --fixed-point also holds prices and amounts as integers in each product's tick size, so that\n"
+                 "       averages and medians of CSV data are computed exactly." << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    // Every argument that is not a flag names a file to be loaded
+    std::vector<std::string> filenames;
+    CSVReadOptions options;
+    BookLoadMode loadMode = BookLoadMode::background;
+    std::ofstream quarantineFile;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string argument = argv[i];
+        if (argument == "--strict")
+        {
+            options.mode = CSVValidationMode::strict;
+        }
+        else if (argument == "--lenient")
+        {
+            options.mode = CSVValidationMode::lenient;
+        }
+        else if (argument == "--foreground")
+        {
+            loadMode = BookLoadMode::foreground;
+        }
+        else if (argument == "--fixed-point")
+        {
+            options.fixedPoint = true;
+        }
+        else if (argument.rfind("--quarantine=", 0) == 0)
+        {
+            quarantineFile.open(argument.substr(argument.find('=') + 1));
+            if (!quarantineFile.is_open())
+            {
+                std::cout << "Unable to write " << argument.substr(argument.find('=') + 1) << std::endl;
+                return 1;
+            }
+            options.quarantineStream = &quarantineFile;
+        }
+        else if (argument.rfind("--", 0) == 0)
+        {
+            printUsage();
+            return argument == "--help" ? 0 : 1;
+        }
+        else
+        {
+            filenames.push_back(argument);
+        }
+    }
+
+    // Create an instance of Advisor Bot, over the default dataset unless files were named
+    std::unique_ptr<AdvisorBot> app;
+    try
+    {
+        if (filenames.empty())
+        {
+            filenames.push_back("20200601.csv");
+        }
+        app = std::make_unique<AdvisorBot>(filenames, options, loadMode);
+    }
+    catch (const std::exception& e)
+    {
+        // The cause has already been printed by the reader
+        std::cout << "Advisor Bot could not load its dataset." << std::endl;
+        return 1;
+    }
+
+    // The quarantine file stays open, as a background load keeps writing to it
 
     // Begin simulation, and request user to continuously enter commands
-    app.init();
-}
\ No newline at end of file
+    app->init();
+}